@@ -0,0 +1,514 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "CountingFunction.h"
+#include "FunctionsConcrete.h"
+#include "Functions2DConcrete.h"
+#include "TrapezoidSolver.h"
+#include "SimpsonSolver.h"
+#include "WeddleSolver.h"
+#include "MonteCarloSolver.h"
+#include "AdaptiveGKSolver.h"
+#include "RombergSolver.h"
+#include "GaussLegendreSolver.h"
+#include "TanhSinhSolver.h"
+#include "QuasiMonteCarloSolver.h"
+#include "StratifiedMonteCarloSolver.h"
+#include "ImportanceMonteCarloSolver.h"
+#include "VegasSolver.h"
+#include "Trapezoid2DSolver.h"
+#include "Simpson2DSolver.h"
+#include "Weddle2DSolver.h"
+#include "MonteCarlo2DSolver.h"
+#include "GaussLegendre2DSolver.h"
+#include "QuasiMonteCarlo2DSolver.h"
+#include "SparseGrid2DSolver.h"
+#include "VectorMath.h"
+#include "Expression.h"
+
+
+/*
+Benchmark of every Solver and Solver2D implementation on the test functions of main.cpp (F1-F4)
+and main_2d.cpp (G1-G4), over a sweep of resolutions (n, nx x ny, sample counts, tolerances)
+and thread counts.
+
+Every row reports the best wall time of `repeat` runs, the number of integrand evaluations of
+one run (counted by the wrappers of CountingFunction.h, G1-G4 stay separable), ns per
+evaluation, evaluations per second, the result and its error against the analytic values.
+With --perf the hardware counters cycles, instructions, cache misses and branch misses of the
+best run are added (Linux perf_event_open, counts include the worker threads). Output is CSV
+(default) or JSON, so two runs can be diffed across commits.
+
+    ./benchmark [--json] [--output FILE] [--repeat K] [--threads 1,4,8] [--filter NAME] [--quick] [--perf]
+                [--expressions]
+
+--threads      thread counts of the multithreaded solvers (default: 1 and hardware_concurrency)
+--filter       only solvers whose name contains NAME
+--quick        the smaller half of every sweep
+--expressions  also E1-E4 / H1-H4, the same integrands given as expressions (Expression.h),
+               to compare the bytecode interpreter with the hand-written classes row by row
+*/
+
+
+// ============================================================
+// hardware counters
+// ============================================================
+
+// cycles, instructions, cache misses and branch misses of the calling thread and of the threads
+// it starts while the counters are open (inherit), unavailable counters read as -1
+class PerfCounters {
+public:
+    static constexpr std::size_t size = 4;
+
+    PerfCounters() {
+#ifdef __linux__
+        const std::uint64_t configs[size] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                             PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (std::size_t i = 0; i < size; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = configs[i];
+            attr.disabled = 1;
+            attr.inherit = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fd_[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#endif
+    }
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int fd : fd_) {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // true if at least one counter could be opened
+    bool available() const {
+        return std::any_of(fd_, fd_ + size, [](int fd) { return fd >= 0; });
+    }
+
+    void start() {
+#ifdef __linux__
+        for (int fd : fd_) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // stops the counters and stores their values in values
+    void stop(std::int64_t* values) {
+        for (std::size_t i = 0; i < size; ++i) {
+            values[i] = -1;
+#ifdef __linux__
+            if (fd_[i] < 0) continue;
+            ioctl(fd_[i], PERF_EVENT_IOC_DISABLE, 0);
+            std::uint64_t count = 0;
+            if (read(fd_[i], &count, sizeof(count)) == static_cast<ssize_t>(sizeof(count))) {
+                values[i] = static_cast<std::int64_t>(count);
+            }
+#endif
+        }
+    }
+
+private:
+    int fd_[size] = {-1, -1, -1, -1};
+};
+
+const char* const perf_names[PerfCounters::size] = {"cycles", "instructions", "cache_misses", "branch_misses"};
+
+
+// ============================================================
+// benchmark cases
+// ============================================================
+
+struct Options {
+    bool json = false;
+    std::string output;
+    int repeat = 3;
+    std::vector<unsigned> threads;
+    std::string filter;
+    bool quick = false;
+    bool perf = false;
+    bool expressions = false;
+    bool help = false;
+};
+
+// one solver configuration, run on every integrand of its dimension
+struct Case {
+    std::string solver;      // e.g. "Trapezoid"
+    std::string resolution;  // e.g. "n=100000"
+    unsigned threads;        // worker threads, 1 for the single-threaded solvers
+    std::unique_ptr<Solver> solver_1d;
+    std::unique_ptr<Solver2D> solver_2d;
+};
+
+// an integrand with its interval (or box) and analytic value
+struct Integrand {
+    std::string name;
+    const Function* f;
+    const Function2D* g;
+    double a, b, c, d;
+    double exact;
+};
+
+struct Row {
+    const Case* c;
+    const Integrand* integrand;
+    double seconds;
+    std::uint64_t evaluations;
+    double value;
+    std::int64_t counters[PerfCounters::size];
+};
+
+// the first half (quick) or all of the values
+template <class T>
+std::vector<T> sweep(const std::vector<T>& values, bool quick) {
+    return quick ? std::vector<T>(values.begin(), values.begin() + (values.size() + 1) / 2) : values;
+}
+
+std::vector<Case> make_cases(const Options& options) {
+    std::vector<Case> cases;
+    auto add_1d = [&](const std::string& solver, const std::string& resolution, unsigned threads, Solver* s) {
+        cases.push_back({solver, resolution, threads, std::unique_ptr<Solver>(s), nullptr});
+    };
+    auto add_2d = [&](const std::string& solver, const std::string& resolution, unsigned threads, Solver2D* s) {
+        cases.push_back({solver, resolution, threads, nullptr, std::unique_ptr<Solver2D>(s)});
+    };
+    const bool quick = options.quick;
+    const auto n_str = [](std::size_t n) { return "n=" + std::to_string(n); };
+    const auto tol_str = [](double tol) {
+        std::ostringstream out;
+        out << "tol=" << tol;
+        return out.str();
+    };
+
+    // 1D
+    for (std::size_t n : sweep<std::size_t>({1000, 100000, 1000000, 10000000}, quick)) {
+        for (unsigned t : options.threads) {
+            add_1d("Trapezoid", n_str(n), t, new TrapezoidSolver(n, t));
+            add_1d("Simpson", n_str(n), t, new SimpsonSolver(n, t));
+            add_1d("Weddle", n_str(n), t, new WeddleSolver(n, t));
+        }
+    }
+    for (std::size_t n : sweep<std::size_t>({10000, 1000000, 10000000}, quick)) {
+        add_1d("MonteCarlo", n_str(n), 1, new MonteCarloSolver(n, 42));
+        for (unsigned t : options.threads) {
+            add_1d("MonteCarloParallel", n_str(n), t, new MonteCarloSolver(n, 42, MonteCarloSolver::Mode::Parallel, t));
+        }
+    }
+    for (std::size_t panels : sweep<std::size_t>({1, 64, 4096}, quick)) {
+        add_1d("GaussLegendre", "order=16,panels=" + std::to_string(panels), 1, new GaussLegendreSolver(16, panels));
+    }
+    for (double tol : sweep<double>({1e-6, 1e-10}, quick)) {
+        add_1d("AdaptiveGK", tol_str(tol), 1, new AdaptiveGKSolver(tol, tol));
+        add_1d("Romberg", tol_str(tol), 1, new RombergSolver(tol, tol));
+        add_1d("TanhSinh", tol_str(tol), 1, new TanhSinhSolver(tol, tol));
+    }
+    for (std::size_t n : sweep<std::size_t>({4096, 65536}, quick)) {
+        for (unsigned t : options.threads) {
+            add_1d("QuasiMonteCarlo", n_str(n) + ",replicates=8", t, new QuasiMonteCarloSolver(n, 8, 42,
+                   QuasiMonteCarloSolver::Sequence::Sobol, t));
+        }
+    }
+    for (std::size_t n : sweep<std::size_t>({20000, 2000000}, quick)) {
+        for (unsigned t : options.threads) {
+            add_1d("StratifiedMonteCarlo", n_str(n) + ",strata=" + std::to_string(n / 2), t,
+                   new StratifiedMonteCarloSolver(n, n / 2, 42, t));
+            add_1d("ImportanceMonteCarlo", n_str(n) + ",proposal=x^(-1/2)", t,
+                   new ImportanceMonteCarloSolver(n, std::make_shared<PowerLawProposal>(0.5), 42, t));
+        }
+    }
+    for (std::size_t n : sweep<std::size_t>({20000, 200000}, quick)) {
+        for (unsigned t : options.threads) {
+            add_1d("Vegas", n_str(n) + ",bins=100,iterations=10", t, new VegasSolver(n, 100, 10, 42, t));
+        }
+    }
+
+    // 2D
+    for (std::size_t n : sweep<std::size_t>({100, 1000, 3000}, quick)) {
+        const std::string grid = "n=" + std::to_string(n) + "x" + std::to_string(n);
+        for (unsigned t : options.threads) {
+            add_2d("Trapezoid2D", grid, t, new Trapezoid2DSolver(n, n, t));
+            add_2d("Simpson2D", grid, t, new Simpson2DSolver(n, n, t));
+            add_2d("Weddle2D", grid, t, new Weddle2DSolver(n, n, t));
+        }
+    }
+    for (std::size_t n : sweep<std::size_t>({10000, 1000000, 10000000}, quick)) {
+        add_2d("MonteCarlo2D", n_str(n), 1, new MonteCarlo2DSolver(n, 42));
+        for (unsigned t : options.threads) {
+            add_2d("MonteCarlo2DParallel", n_str(n), t, new MonteCarlo2DSolver(n, 42, MonteCarlo2DSolver::Mode::Parallel, t));
+        }
+    }
+    for (std::size_t panels : sweep<std::size_t>({1, 16, 128}, quick)) {
+        for (unsigned t : options.threads) {
+            add_2d("GaussLegendre2D", "order=16,panels=" + std::to_string(panels) + "x" + std::to_string(panels), t,
+                   new GaussLegendre2DSolver(16, panels, panels, t));
+        }
+    }
+    for (std::size_t n : sweep<std::size_t>({4096, 65536}, quick)) {
+        for (unsigned t : options.threads) {
+            add_2d("QuasiMonteCarlo2D", n_str(n) + ",replicates=8", t, new QuasiMonteCarlo2DSolver(n, 8, 42,
+                   QuasiMonteCarlo2DSolver::Sequence::Sobol, t));
+        }
+    }
+    for (double tol : sweep<double>({1e-6, 1e-10}, quick)) {
+        add_2d("SparseGrid2D", tol_str(tol), 1, new SparseGrid2DSolver(tol, tol));
+    }
+
+    if (!options.filter.empty()) {
+        cases.erase(std::remove_if(cases.begin(), cases.end(), [&](const Case& c) {
+            return c.solver.find(options.filter) == std::string::npos;
+        }), cases.end());
+    }
+    return cases;
+}
+
+
+// ============================================================
+// command line and output
+// ============================================================
+
+// "1,4,8" -> {1, 4, 8}
+std::vector<unsigned> parse_threads(const std::string& list) {
+    std::vector<unsigned> threads;
+    std::stringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        const unsigned long t = std::stoul(item);
+        if (t == 0) throw std::invalid_argument("thread counts must be positive");
+        threads.push_back(static_cast<unsigned>(t));
+    }
+    if (threads.empty()) throw std::invalid_argument("empty thread list");
+    return threads;
+}
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--json") options.json = true;
+        else if (arg == "--csv") options.json = false;
+        else if (arg == "--output") options.output = value();
+        else if (arg == "--repeat") options.repeat = std::max(1, std::stoi(value()));
+        else if (arg == "--threads") options.threads = parse_threads(value());
+        else if (arg == "--filter") options.filter = value();
+        else if (arg == "--quick") options.quick = true;
+        else if (arg == "--perf") options.perf = true;
+        else if (arg == "--expressions") options.expressions = true;
+        else if (arg == "--help") options.help = true;
+        else throw std::invalid_argument("unknown option " + arg);
+    }
+    if (options.threads.empty()) {
+        options.threads.push_back(1);
+        const unsigned hw = resolve_threads(0);
+        if (hw > 1) options.threads.push_back(hw);
+    }
+    return options;
+}
+
+// solver and integrand names contain no quotes, commas only in the resolution column
+std::string csv_field(const std::string& s) {
+    return s.find(',') == std::string::npos ? s : "\"" + s + "\"";
+}
+
+void write_csv(std::ostream& out, const std::vector<Row>& rows, bool perf) {
+    out << "solver,resolution,threads,integrand,seconds,evaluations,ns_per_eval,evals_per_second,value,exact,error";
+    if (perf) {
+        for (const char* name : perf_names) out << "," << name;
+    }
+    out << "\n";
+    for (const Row& r : rows) {
+        const double evals = static_cast<double>(r.evaluations);
+        out << r.c->solver << "," << csv_field(r.c->resolution) << "," << r.c->threads << "," << r.integrand->name
+            << "," << std::setprecision(6) << r.seconds << "," << r.evaluations << "," << r.seconds * 1e9 / evals
+            << "," << evals / r.seconds << "," << std::setprecision(17) << r.value << "," << r.integrand->exact
+            << "," << std::abs(r.value - r.integrand->exact);
+        if (perf) {
+            for (std::int64_t v : r.counters) out << "," << v;
+        }
+        out << "\n";
+    }
+}
+
+void write_json(std::ostream& out, const std::vector<Row>& rows, const Options& options, bool perf) {
+    out << "{\n  \"repeat\": " << options.repeat << ",\n  \"hardware_concurrency\": " << resolve_threads(0)
+        << ",\n  \"isa\": \"" << vmath::isa() << "\""
+        << ",\n  \"perf\": " << (perf ? "true" : "false") << ",\n  \"results\": [";
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        const Row& r = rows[i];
+        const double evals = static_cast<double>(r.evaluations);
+        out << (i ? ",\n" : "\n") << "    {\"solver\": \"" << r.c->solver << "\", \"resolution\": \"" << r.c->resolution
+            << "\", \"threads\": " << r.c->threads << ", \"integrand\": \"" << r.integrand->name
+            << "\", \"seconds\": " << std::setprecision(6) << r.seconds << ", \"evaluations\": " << r.evaluations
+            << ", \"ns_per_eval\": " << r.seconds * 1e9 / evals << ", \"evals_per_second\": " << evals / r.seconds
+            << ", \"value\": " << std::setprecision(17) << r.value << ", \"exact\": " << r.integrand->exact
+            << ", \"error\": " << std::abs(r.value - r.integrand->exact);
+        if (perf) {
+            for (std::size_t k = 0; k < PerfCounters::size; ++k) {
+                out << ", \"" << perf_names[k] << "\": ";
+                if (r.counters[k] < 0) out << "null";
+                else out << r.counters[k];
+            }
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+
+const char* const usage =
+    "usage: benchmark [--json|--csv] [--output FILE] [--repeat K] [--threads 1,4,8] [--filter NAME] [--quick] [--perf]\n"
+    "                 [--expressions]\n";
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "benchmark: " << e.what() << "\n" << usage;
+        return 2;
+    }
+    if (options.help) {
+        std::cout << usage;
+        return 0;
+    }
+
+    // test functions and analytic values of main.cpp and main_2d.cpp
+    // F3 and F4 are singular at 0, the grid solvers integrate them on [1e-6, 1] as main.cpp does
+    F1 f1;
+    F2 f2;
+    F3 f3;
+    F4 f4;
+    G1 g1;
+    G2 g2;
+    G3 g3;
+    G4 g4;
+    const double epsilon = 1e-6;
+    const double pi = std::acos(-1.0);
+    std::vector<Integrand> integrands_1d = {
+        {"F1", &f1, nullptr, 0.0, 1.0, 0.0, 0.0, 2.0 * std::cos(1.0) - std::sin(1.0)},
+        {"F2", &f2, nullptr, 0.0, 1.0, 0.0, 0.0, 1.0 / 11.0},
+        {"F3", &f3, nullptr, epsilon, 1.0, 0.0, 0.0, 2.0 - 2.0 * std::sqrt(epsilon)},
+        {"F4", &f4, nullptr, epsilon, 1.0, 0.0, 0.0, -1.0 - epsilon * (std::log(epsilon) - 1.0)}
+    };
+    std::vector<Integrand> integrands_2d = {
+        {"G1", nullptr, &g1, 0.0, 1.0, 0.0, 1.0, 2.0 / 3.0},
+        {"G2", nullptr, &g2, 0.0, 1.0, 0.0, 1.0, 0.25},
+        {"G3", nullptr, &g3, 0.0, 1.0, 0.0, 1.0, (std::exp(1.0) - 1.0) * (std::exp(1.0) - 1.0)},
+        {"G4", nullptr, &g4, 0.0, pi, 0.0, pi, 0.0}
+    };
+
+    // the same integrands as expressions, G1-G4 stay separable (make_expression_function_2d;
+    // H3 needs expand for exp(x+y) = exp(x) * exp(y), like the hand-written G3)
+    const ExpressionFunction e1("x^2*cos(x)");
+    const ExpressionFunction e2("x^10");
+    const ExpressionFunction e3("1/sqrt(x)");
+    const ExpressionFunction e4("log(x)");
+    const std::unique_ptr<Function2D> h1 = make_expression_function_2d("x^2 + y^2");
+    const std::unique_ptr<Function2D> h2 = make_expression_function_2d("x*y");
+    const std::unique_ptr<Function2D> h3 = make_expression_function_2d("exp(x+y)", "x", "y", true);
+    const std::unique_ptr<Function2D> h4 = make_expression_function_2d("sin(x)*cos(y)");
+    if (options.expressions) {
+        const Function* es[] = {&e1, &e2, &e3, &e4};
+        const Function2D* hs[] = {h1.get(), h2.get(), h3.get(), h4.get()};
+        for (std::size_t k = 0; k < 4; ++k) {
+            Integrand e = integrands_1d[k];
+            e.name = "E" + std::to_string(k + 1);
+            e.f = es[k];
+            integrands_1d.push_back(e);
+            Integrand h = integrands_2d[k];
+            h.name = "H" + std::to_string(k + 1);
+            h.g = hs[k];
+            integrands_2d.push_back(h);
+        }
+    }
+
+    std::unique_ptr<PerfCounters> counters;
+    if (options.perf) {
+        counters = std::make_unique<PerfCounters>();
+        if (!counters->available()) {
+            std::cerr << "benchmark: perf_event_open not available, hardware counters are reported as null\n";
+        }
+    }
+
+    const std::vector<Case> cases = make_cases(options);
+    std::vector<Row> rows;
+    for (const Case& c : cases) {
+        std::cerr << c.solver << " (" << c.resolution << ", threads=" << c.threads << ")\n";
+        for (const Integrand& integrand : (c.solver_1d ? integrands_1d : integrands_2d)) {
+            std::atomic<std::uint64_t> evaluations{0};
+            const CountingFunction counted_f(c.solver_1d ? *integrand.f : f1, evaluations);
+            const std::unique_ptr<Function2D> counted_g = counting_function(c.solver_2d ? *integrand.g : g1, evaluations);
+            Row row{&c, &integrand, 1e300, 0, 0.0, {-1, -1, -1, -1}};
+            for (int r = 0; r < options.repeat; ++r) {
+                evaluations = 0;
+                std::int64_t values[PerfCounters::size] = {-1, -1, -1, -1};
+                if (counters) counters->start();
+                const auto start = std::chrono::steady_clock::now();
+                const double value = c.solver_1d
+                    ? c.solver_1d->integrate(counted_f, integrand.a, integrand.b)
+                    : c.solver_2d->integrate(*counted_g, integrand.a, integrand.b, integrand.c, integrand.d);
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                if (counters) counters->stop(values);
+                if (elapsed.count() < row.seconds) {
+                    row.seconds = elapsed.count();
+                    row.value = value;
+                    std::copy(values, values + PerfCounters::size, row.counters);
+                }
+                row.evaluations = evaluations.load();
+            }
+            rows.push_back(row);
+        }
+    }
+
+    std::ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file) {
+            std::cerr << "benchmark: cannot open " << options.output << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = options.output.empty() ? std::cout : file;
+    // timings with 6 digits, values and errors with all 17 so that bit changes show up in a diff
+    if (options.json) {
+        write_json(out, rows, options, options.perf);
+    } else {
+        write_csv(out, rows, options.perf);
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include "VectorMath.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+Summation policies of the solver accumulators.
+
+A single running sum s += x_i has two problems at 10^7+ terms: the rounding error grows like
+n * eps, and every addition waits for the previous one (loop-carried dependency), so the loop can
+neither be vectorized nor pipelined. The solvers therefore add their function values block by
+block (Function::evaluate blocks) into an Accumulator with one of these policies:
+
+Naive     one running sum, left to right (the behaviour before the policies existed)
+Pairwise  every block is summed in 8 independent lanes (SIMD registers, no dependency between
+          consecutive terms) that are combined pairwise (vmath::sum / vmath::dot, dispatched to
+          the widest instruction set of the CPU, same result in every variant); the block sums
+          go into a binary cascade that only ever adds partial sums of equal size, so the error
+          grows like log(n) * eps
+Neumaier  compensated running sum (Kahan-Babuska-Neumaier): the rounding error of every addition
+          is carried in a correction term, the error is independent of n, about 4x the work
+
+The solvers split their nodes into fixed chunks and combine the chunk sums in a fixed pairwise
+tree (parallel_sum), so every policy gives bit-identical results for every thread count.
+*/
+enum class Summation { Naive, Pairwise, Neumaier };
+
+// ",summation=naive" / ",summation=neumaier" for the configuration strings, empty for the default Pairwise
+inline std::string summation_suffix(Summation summation) {
+    switch (summation) {
+        case Summation::Naive: return ",summation=naive";
+        case Summation::Neumaier: return ",summation=neumaier";
+        default: return std::string();
+    }
+}
+
+class Accumulator {
+public:
+    explicit Accumulator(Summation summation = Summation::Pairwise) : summation_(summation) {}
+
+    // add x[0..n)
+    void add(const double* x, std::size_t n) {
+        switch (summation_) {
+            case Summation::Naive:
+                for (std::size_t k = 0; k < n; ++k) {
+                    sum_ += x[k];
+                }
+                break;
+            case Summation::Pairwise:
+                push(vmath::sum(x, n));
+                break;
+            case Summation::Neumaier:
+                for (std::size_t k = 0; k < n; ++k) {
+                    neumaier(x[k]);
+                }
+                break;
+        }
+    }
+
+    // add w[0..n) * x[0..n)
+    void add_products(const double* w, const double* x, std::size_t n) {
+        switch (summation_) {
+            case Summation::Naive:
+                for (std::size_t k = 0; k < n; ++k) {
+                    sum_ += w[k] * x[k];
+                }
+                break;
+            case Summation::Pairwise:
+                push(vmath::dot(w, x, n));
+                break;
+            case Summation::Neumaier:
+                for (std::size_t k = 0; k < n; ++k) {
+                    neumaier(w[k] * x[k]);
+                }
+                break;
+        }
+    }
+
+    // add a single value (a partial sum of another accumulator, a boundary term)
+    void add(double x) {
+        switch (summation_) {
+            case Summation::Naive: sum_ += x; break;
+            case Summation::Pairwise: push(x); break;
+            case Summation::Neumaier: neumaier(x); break;
+        }
+    }
+
+    // sum of everything added so far
+    double sum() const {
+        if (summation_ != Summation::Pairwise) return sum_ + correction_;
+        // the cascade levels from the smallest partial sums up
+        double s = 0.0;
+        for (unsigned level = 0; level < 64; ++level) {
+            if ((occupied_ >> level) & 1u) s += cascade_[level];
+        }
+        return s;
+    }
+
+private:
+    // binary counter of partial sums: level l holds the sum of 2^l pushed values,
+    // two partial sums are only added when they cover the same number of values
+    void push(double x) {
+        unsigned level = 0;
+        while ((occupied_ >> level) & 1u) {
+            x = cascade_[level] + x;
+            occupied_ &= ~(std::uint64_t(1) << level);
+            ++level;
+        }
+        cascade_[level] = x;
+        occupied_ |= std::uint64_t(1) << level;
+    }
+
+    void neumaier(double x) {
+        const double t = sum_ + x;
+        correction_ += (std::abs(sum_) >= std::abs(x)) ? (sum_ - t) + x : (x - t) + sum_;
+        sum_ = t;
+    }
+
+    Summation summation_;
+    double sum_ = 0.0;
+    double correction_ = 0.0;
+    double cascade_[64];
+    std::uint64_t occupied_ = 0;
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include "Solver.h"
+#include <cstddef>
+#include <string>
+
+// Adaptive Gauss-Kronrod integrator (G7-K15 rule per subinterval, as in QUADPACK qag).
+// The subinterval with the largest error estimate is bisected until the summed error estimate
+// meets max(abs_tol, rel_tol * |result|) or the evaluation budget is used up.
+// The 15 nodes never include the interval endpoints, so integrable endpoint singularities
+// (e.g. x^(-1/2) or log(x) on [0,1]) can be integrated directly.
+class AdaptiveGKSolver : public Solver {
+public:
+    // result of one adaptive integration
+    struct Result {
+        double value;             // approximate integral
+        double error;             // estimated absolute error
+        std::size_t evaluations;  // number of integrand evaluations
+        std::size_t intervals;    // number of subintervals at the end
+        bool converged;           // false if the budget ran out before the tolerance was met
+    };
+
+    // abs_tol / rel_tol = requested absolute / relative accuracy
+    // max_evaluations = evaluation budget (at least one 15 point rule is always applied)
+    // explicit prevents implicit creation
+    explicit AdaptiveGKSolver(double abs_tol = 1e-10, double rel_tol = 1e-10,
+                              std::size_t max_evaluations = 100000)
+        : abs_tol_(abs_tol), rel_tol_(rel_tol), max_evaluations_(max_evaluations) {}
+
+    // integrate method from the Solver class, returns only the value
+    double integrate(const Function& f, double a, double b) const override;
+
+    // rule and parameters, see Solver::configuration
+    std::string configuration() const override;
+
+    // same integration, also reports error estimate and cost
+    Result integrate_adaptive(const Function& f, double a, double b) const;
+
+private:
+    double abs_tol_;
+    double rel_tol_;
+    std::size_t max_evaluations_;
+};
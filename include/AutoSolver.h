@@ -0,0 +1,82 @@
+#pragma once
+#include "Solver.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Auto-tuning integrator: picks the cheapest rule and resolution for a requested tolerance.
+//
+// Pilot: every grid rule (Trapezoid, Simpson, Weddle) is run on the nested grids n0, 2 n0, 4 n0, 8 n0.
+// The last three values give the observed convergence order p = log2(|Q(2n)-Q(n)| / |Q(4n)-Q(2n)|)
+// and the Richardson error estimate |Q(8n0)-Q(4n0)| / (2^p - 1) of the finest pilot; the error
+// model e(n) = C n^(-p) then predicts the n that reaches half the tolerance. Monte Carlo is piloted
+// with a streaming run, its standard error sigma / sqrt(n) predicts the number of samples.
+// Each candidate's cost is its predicted number of evaluations times its cost per evaluation
+// measured on the pilot (wall-clock).
+//
+// Final run: only the cheapest candidate predicted to meet max(abs_tol, rel_tol * |value|) within
+// max_evaluations. A grid rule keeps doubling n from the finest pilot grid up to the predicted N,
+// re-estimating the order at every step, and stops as soon as the Richardson estimate meets the
+// target: a pilot that is not in the asymptotic range yet (F3, F4 near their singularity) only
+// over-predicts N, it does not cost N. Monte Carlo runs a streaming estimate that stops at the
+// tolerance. If the finest pilot already meets the tolerance it is the result, no final run.
+// If no candidate is predicted to meet the tolerance, the one with the smallest predicted error
+// at the budget runs and converged is false.
+//
+// The choice depends on measured timings, so the result is not reproducible bit for bit
+// (configuration() stays empty, CachedSolver does not cache it).
+class AutoSolver : public Solver {
+public:
+    enum class Rule { Trapezoid, Simpson, Weddle, MonteCarlo };
+
+    // pilot result and prediction of one rule
+    struct Candidate {
+        Rule rule;
+        double order;                // observed convergence order p (0.5 for Monte Carlo)
+        double pilot_error;          // estimated error of the finest pilot (standard error for Monte Carlo)
+        double cost_per_evaluation;  // seconds per integrand evaluation in the pilot
+        std::size_t n;               // predicted subintervals / samples for the tolerance (capped at the budget),
+                                     // for a grid rule the upper limit of the final doubling
+        double predicted_error;      // error predicted at n
+        double predicted_cost;       // seconds predicted for the final run
+    };
+
+    // result of one auto-tuned integration
+    struct Result {
+        double value;                       // integral from the chosen rule
+        double error;                       // estimated error of value (Richardson / standard error)
+        double predicted_error;             // error the pilot predicted for the chosen n
+        Rule rule;                          // chosen rule
+        std::size_t n;                      // subintervals / samples of the final run
+        std::size_t evaluations;            // all integrand evaluations, pilot included
+        std::size_t pilot_evaluations;      // evaluations of the pilot runs
+        bool converged;                     // false if error > max(abs_tol, rel_tol * |value|)
+        std::vector<Candidate> candidates;  // pilot results of all rules
+    };
+
+    // abs_tol / rel_tol = requested accuracy
+    // max_evaluations = budget of the final run
+    // pilot_n = coarsest pilot grid n0 (falls back to 8 if smaller), Monte Carlo pilots with 64 n0 samples
+    // seed = Monte Carlo seed, 0 means "random seed" (non-deterministic)
+    // threads = worker threads of the rules, 0 means std::thread::hardware_concurrency()
+    explicit AutoSolver(double abs_tol = 1e-8, double rel_tol = 1e-8, std::size_t max_evaluations = 100000000,
+                        std::size_t pilot_n = 64, std::uint64_t seed = 0, unsigned threads = 0);
+
+    // integrate method from the Solver class, returns only the value
+    double integrate(const Function& f, double a, double b) const override;
+
+    // same integration, also reports the choice, the predicted and the estimated error
+    Result integrate_auto(const Function& f, double a, double b) const;
+
+    // "Trapezoid", "Simpson", "Weddle", "MonteCarlo"
+    static std::string rule_name(Rule rule);
+
+private:
+    double abs_tol_;
+    double rel_tol_;
+    std::size_t max_evaluations_;
+    std::size_t pilot_n_;
+    std::uint64_t seed_;
+    unsigned threads_;
+};
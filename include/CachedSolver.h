@@ -0,0 +1,101 @@
+#pragma once
+#include "Solver.h"
+#include "Solver2D.h"
+#include "LruCache.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <typeindex>
+
+/*
+Opt-in memoization of integration results.
+
+CachedSolver / CachedSolver2D wrap any Solver / Solver2D and remember the results of previous calls,
+keyed on the integrand identity (object address and dynamic type), the bounds and the solver
+configuration (rule and parameters, see Solver::configuration). The cache is a bounded LRU and can
+be shared by concurrent callers. Solvers with an empty configuration, e.g. Monte Carlo with seed 0,
+bypass the cache.
+
+The integrand is identified by its address: if an integrand object is destroyed and another one
+is created at the same address with the same type, call clear() in between. Counting wrappers
+(CountingFunction.h, e.g. from an InstrumentedSolver on top of the cache) are keyed on the
+integrand they count, not on their own (stack) address.
+*/
+
+// key of one cached integral, unused bounds are 0
+struct IntegralKey {
+    const void* integrand;
+    std::type_index type;
+    std::array<double, 4> bounds;
+    std::string configuration;
+
+    bool operator==(const IntegralKey& other) const {
+        return integrand == other.integrand && type == other.type
+            && bounds == other.bounds && configuration == other.configuration;
+    }
+};
+
+struct IntegralKeyHash {
+    std::size_t operator()(const IntegralKey& key) const;
+};
+
+// hit / miss counters of a cached solver
+struct CacheStats {
+    std::size_t hits;      // results served from the cache
+    std::size_t misses;    // results computed and stored
+    std::size_t bypassed;  // calls that were not cacheable (empty configuration)
+    std::size_t size;      // entries currently stored
+    std::size_t capacity;  // maximal number of entries
+};
+
+class CachedSolver : public Solver {
+public:
+    // solver = the wrapped solver, capacity = maximal number of cached results
+    explicit CachedSolver(std::unique_ptr<Solver> solver, std::size_t capacity = 1024)
+        : solver_(std::move(solver)), cache_(capacity) {}
+
+    // returns the cached result or integrates with the wrapped solver
+    double integrate(const Function& f, double a, double b) const override;
+
+    // same configuration as the wrapped solver
+    std::string configuration() const override { return solver_->configuration(); }
+
+    // sampling if the wrapped solver is
+    bool sampling() const override { return solver_->sampling(); }
+
+    CacheStats stats() const;
+    void clear();
+
+private:
+    std::unique_ptr<Solver> solver_;
+    mutable LruCache<IntegralKey, double, IntegralKeyHash> cache_;
+    mutable std::atomic<std::size_t> bypassed_{0};
+};
+
+class CachedSolver2D : public Solver2D {
+public:
+    // solver = the wrapped solver, capacity = maximal number of cached results
+    explicit CachedSolver2D(std::unique_ptr<Solver2D> solver, std::size_t capacity = 1024)
+        : solver_(std::move(solver)), cache_(capacity) {}
+
+    // returns the cached result or integrates with the wrapped solver
+    double integrate(const Function2D& f,
+                    double a, double b,
+                    double c, double d) const override;
+
+    // same configuration as the wrapped solver
+    std::string configuration() const override { return solver_->configuration(); }
+
+    // sampling if the wrapped solver is
+    bool sampling() const override { return solver_->sampling(); }
+
+    CacheStats stats() const;
+    void clear();
+
+private:
+    std::unique_ptr<Solver2D> solver_;
+    mutable LruCache<IntegralKey, double, IntegralKeyHash> cache_;
+    mutable std::atomic<std::size_t> bypassed_{0};
+};
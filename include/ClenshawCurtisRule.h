@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/*
+Nested Clenshaw-Curtis rules on [-1, 1] for levels 1..clenshaw_curtis_max_level, the 1D building
+blocks of the sparse-grid solvers.
+
+Level 1 is the midpoint rule (node 0, weight 2), level l >= 2 has m = 2^(l-1) + 1 nodes
+x_j = -cos(pi j / (m - 1)), j = 0..m-1 (ascending, endpoints included). Every node of level l - 1
+is a node of level l (node j of level l - 1 is node 2j of level l), so a sparse grid built from
+these rules evaluates each point once, whatever the number of levels that share it.
+
+Along with the weights of Q_l the table holds the weights of the difference rule Q_l - Q_(l-1)
+on the nodes of level l, and the position of every node on the grid of the finest level, an exact
+integer name of the node shared by all levels. The table is computed on first use.
+*/
+
+constexpr std::size_t clenshaw_curtis_max_level = 12;
+
+// number of intervals of the finest level, node positions are in [0, clenshaw_curtis_positions]
+constexpr std::uint32_t clenshaw_curtis_positions = std::uint32_t(1) << (clenshaw_curtis_max_level - 1);
+
+// one level, all arrays have `size` entries
+struct ClenshawCurtisRule {
+    const double* nodes;               // ascending
+    const double* weights;             // weights of Q_l
+    const double* differences;         // weights of Q_l - Q_(l-1) (Q_0 = 0)
+    const std::uint32_t* positions;    // index of the node on the finest level
+    std::size_t size;
+};
+
+// rule of the given level, level must be in [1, clenshaw_curtis_max_level]
+ClenshawCurtisRule clenshaw_curtis_rule(std::size_t level);
@@ -0,0 +1,113 @@
+#pragma once
+#include "Function.h"
+#include "Function2D.h"
+#include "SeparableFunction2D.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/*
+Integrand wrappers that count evaluations into a caller-owned counter, used by InstrumentedSolver
+and the benchmark driver. One relaxed atomic add per evaluate block (per point for operator()),
+so the wrappers can be evaluated from several worker threads.
+
+A SeparableFunction2D has to stay separable, otherwise the grid solvers would leave their
+factorized path (see tensor_product_sum) and the measurement would change what it measures:
+counting_function wraps it in a CountingSeparableFunction2D whose 1D factors count their own
+evaluations, nx + ny per term on the factorized path and one per point elsewhere.
+
+The wrappers are short-lived (one per instrumented call, usually on the stack), so they are no
+identity of their own: wrapped() gives the counted integrand, which CachedSolver uses as its key.
+*/
+
+class CountingFunction : public Function {
+public:
+    // f = wrapped integrand, count = incremented by the number of evaluations
+    CountingFunction(const Function& f, std::atomic<std::uint64_t>& count) : f_(f), count_(count) {}
+
+    double operator()(double x) const override {
+        count_.fetch_add(1, std::memory_order_relaxed);
+        return f_(x);
+    }
+
+    void evaluate(const double* x, double* out, std::size_t n) const override {
+        count_.fetch_add(n, std::memory_order_relaxed);
+        f_.evaluate(x, out, n);
+    }
+
+    // the counted integrand
+    const Function& wrapped() const { return f_; }
+
+private:
+    const Function& f_;
+    std::atomic<std::uint64_t>& count_;
+};
+
+class CountingFunction2D : public Function2D {
+public:
+    // f = wrapped integrand, count = incremented by the number of evaluations
+    CountingFunction2D(const Function2D& f, std::atomic<std::uint64_t>& count) : f_(f), count_(count) {}
+
+    double operator()(double x, double y) const override {
+        count_.fetch_add(1, std::memory_order_relaxed);
+        return f_(x, y);
+    }
+
+    void evaluate(const double* x, const double* y, double* out, std::size_t n) const override {
+        count_.fetch_add(n, std::memory_order_relaxed);
+        f_.evaluate(x, y, out, n);
+    }
+
+    // the counted integrand
+    const Function2D& wrapped() const { return f_; }
+
+private:
+    const Function2D& f_;
+    std::atomic<std::uint64_t>& count_;
+};
+
+// separable counterpart of CountingFunction2D: the terms are the counted factors of f,
+// point evaluations go to f itself (its direct formula, if it has one)
+class CountingSeparableFunction2D : public SeparableFunction2D {
+public:
+    CountingSeparableFunction2D(const SeparableFunction2D& f, std::atomic<std::uint64_t>& count)
+        : SeparableFunction2D(counting_terms(f, count)), f_(f), count_(count) {}
+
+    double operator()(double x, double y) const override {
+        count_.fetch_add(1, std::memory_order_relaxed);
+        return f_(x, y);
+    }
+
+    void evaluate(const double* x, const double* y, double* out, std::size_t n) const override {
+        count_.fetch_add(n, std::memory_order_relaxed);
+        f_.evaluate(x, y, out, n);
+    }
+
+    // the counted integrand
+    const SeparableFunction2D& wrapped() const { return f_; }
+
+private:
+    // the factors are kept alive by f, the wrappers only refer to them
+    static std::vector<Term> counting_terms(const SeparableFunction2D& f, std::atomic<std::uint64_t>& count) {
+        std::vector<Term> terms;
+        for (std::size_t k = 0; k < f.terms(); ++k) {
+            terms.push_back({std::make_shared<CountingFunction>(*f.term(k).x, count),
+                             std::make_shared<CountingFunction>(*f.term(k).y, count)});
+        }
+        return terms;
+    }
+
+    const SeparableFunction2D& f_;
+    std::atomic<std::uint64_t>& count_;
+};
+
+// counting wrapper of f that keeps it separable if it is
+inline std::unique_ptr<Function2D> counting_function(const Function2D& f, std::atomic<std::uint64_t>& count) {
+    if (const auto* separable = dynamic_cast<const SeparableFunction2D*>(&f)) {
+        return std::make_unique<CountingSeparableFunction2D>(*separable, count);
+    }
+    return std::make_unique<CountingFunction2D>(f, count);
+}
@@ -0,0 +1,151 @@
+#pragma once
+#include "Function.h"
+#include "Function2D.h"
+#include "SeparableFunction2D.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+Integrands given as text at run time, e.g. "x^2*cos(x)" or "exp(x+y)", without writing and
+compiling a class like F1.
+
+Syntax: decimal numbers (2, 0.5, .5, 1e-3; no hexadecimal), the variables, the constants pi and e, + - * / and ^ (right
+associative and tighter than unary minus: -x^2 = -(x^2), 2^-1 = 0.5), parentheses and the functions
+sin cos tan exp log sqrt abs (one argument) and pow min max (two arguments).
+Errors (syntax, unknown names, wrong number of arguments, nesting deeper than 1000 levels) throw
+std::invalid_argument with the position.
+
+Compilation:
+1. a recursive descent parser builds the syntax tree,
+2. the tree is lowered into a DAG in which every node exists once, so common subexpressions
+   ("sin(x)*sin(x)") are computed once, and nodes with constant operands are folded ("2*pi*x" is
+   one multiplication); x^n for integer |n| <= 64 becomes a multiplication chain by squaring (x^10 is
+   computed like F2), x^0.5 and x^-0.5 become sqrt and 1/sqrt,
+3. the DAG is scheduled into a register bytecode: every register holds a block of 256 values,
+   every instruction processes a whole block (sin, cos, exp, log and 1/sqrt through the vmath
+   kernels) and a register is reused as soon as its last reader ran.
+The interpreter dispatches once per instruction and block, not per point, so the cost per point
+stays within a small factor of the hand-written classes (x^2*cos(x): r0 = mul x, x; r1 = cos x;
+out = mul r0, r1). Measured with Simpson on one thread: 1/sqrt(x) and log(x) about 1.0x F3 / F4,
+x^2*cos(x) 1.1-1.4x F1, x^10 1.4-1.65x F2 (every instruction makes a pass over the block where
+the compiler keeps F2's chain in registers).
+
+The compiled program evaluates the expression as written up to rounding: integer powers are
+multiplication chains instead of std::pow and constants are folded with std:: functions, so E1-E4
+agree with the hand-written F1-F4 to about 1e-13 relative. The same holds for the factorized 2D
+functions of make_expression_function_2d by default; with expand they are rewritten and can differ
+by much more (see there).
+*/
+
+// compiled program of an Expression (src/Expression.cpp)
+struct ExpressionProgram;
+
+class Expression {
+public:
+    // source = the expression, variables = names of its arguments in order, e.g. {"x", "y"}
+    explicit Expression(const std::string& source, std::vector<std::string> variables = {"x"});
+
+    // value at one point, args[v] is the value of variables[v]
+    double operator()(const double* args) const;
+
+    // out[i] = value at (args[0][i], args[1][i], ...) for i in [0, n), out may alias an argument
+    void evaluate(const double* const* args, double* out, std::size_t n) const;
+
+    const std::string& source() const { return source_; }
+    const std::vector<std::string>& variables() const { return variables_; }
+
+    // size of the compiled program: bytecode instructions and block registers
+    std::size_t instructions() const;
+    std::size_t registers() const;
+
+    // the bytecode, one instruction per line ("r0 = mul x, x")
+    std::string disassemble() const;
+
+private:
+    std::string source_;
+    std::vector<std::string> variables_;
+    std::shared_ptr<const ExpressionProgram> program_;
+};
+
+// f(x) given as an expression
+class ExpressionFunction : public Function {
+public:
+    // source = expression in the one variable named variable
+    explicit ExpressionFunction(const std::string& source, const std::string& variable = "x")
+        : expression_(source, {variable}) {}
+
+    double operator()(double x) const override {
+        return expression_(&x);
+    }
+
+    void evaluate(const double* x, double* out, std::size_t n) const override {
+        expression_.evaluate(&x, out, n);
+    }
+
+    const Expression& expression() const { return expression_; }
+
+private:
+    Expression expression_;
+};
+
+// f(x, y) given as an expression
+class ExpressionFunction2D : public Function2D {
+public:
+    // source = expression in the two variables named x and y
+    explicit ExpressionFunction2D(const std::string& source, const std::string& x = "x", const std::string& y = "y")
+        : expression_(source, {x, y}) {}
+
+    double operator()(double x, double y) const override {
+        const double args[2] = {x, y};
+        return expression_(args);
+    }
+
+    void evaluate(const double* x, const double* y, double* out, std::size_t n) const override {
+        const double* args[2] = {x, y};
+        expression_.evaluate(args, out, n);
+    }
+
+    const Expression& expression() const { return expression_; }
+
+private:
+    Expression expression_;
+};
+
+// f(x, y) given as an expression that is a sum of products of x-only and y-only factors:
+// the terms are ExpressionFunctions of the factors (factorized path of the grid solvers),
+// point and block evaluations run the whole expression
+class SeparableExpressionFunction2D : public SeparableFunction2D {
+public:
+    SeparableExpressionFunction2D(const std::string& source, std::vector<Term> terms,
+                                  const std::string& x = "x", const std::string& y = "y")
+        : SeparableFunction2D(std::move(terms)), expression_(source, {x, y}) {}
+
+    double operator()(double x, double y) const override {
+        const double args[2] = {x, y};
+        return expression_(args);
+    }
+
+    void evaluate(const double* x, const double* y, double* out, std::size_t n) const override {
+        const double* args[2] = {x, y};
+        expression_.evaluate(args, out, n);
+    }
+
+    const Expression& expression() const { return expression_; }
+
+private:
+    Expression expression_;
+};
+
+// f(x, y) from an expression: a SeparableExpressionFunction2D if the expression is written as a sum
+// of at most 16 products of x-only and y-only factors ("x^2 + y^2", "-2*sin(x)*cos(y)/x"), an
+// ExpressionFunction2D otherwise.
+// expand = also factorize by distributing products and quotients of sums ((x-y)^2 -> x^2 - 2xy + y^2)
+// and by exp(u(x) + v(y)) = exp(u(x)) * exp(v(y)). Faster, but not value-preserving: expanded sums
+// cancel catastrophically ((x-y)^2 on [1e8, 1e8+1]^2 integrates to 0) and the exp factors overflow
+// where the integrand is finite (exp(800x - 800y) gives inf * 0 = NaN)
+std::unique_ptr<Function2D> make_expression_function_2d(const std::string& source,
+                                                        const std::string& x = "x", const std::string& y = "y",
+                                                        bool expand = false);
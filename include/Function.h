@@ -1,5 +1,6 @@
 #pragma once
 #include <functional>
+#include <cstddef>
 
 // Abstract base for integrand functions
 class Function {
@@ -10,5 +11,16 @@ public:
     // const means the object itself is not changed
     // =0 makes the class abstract, you can not instantiate the class directly
     virtual double operator()(double x) const = 0;
+
+    // Evaluate function at n contiguous abscissae: out[i] = f(x[i]) for i in [0, n)
+    // The solvers call this once per block of nodes instead of calling operator() once per node.
+    // The default falls back to the scalar operator, derived classes can override it
+    // so that a whole block costs a single virtual call and the loop can be inlined.
+    virtual void evaluate(const double* x, double* out, std::size_t n) const {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = (*this)(x[i]);
+        }
+    }
+
     virtual ~Function() = default;
-};
\ No newline at end of file
+};
@@ -1,5 +1,5 @@
 #pragma once
-
+#include <cstddef>
 
 
 class Function2D {
@@ -10,5 +10,15 @@ public:
     // const ensure the object is not modified
     // = 0 makes it abstract
     virtual double operator()(double x, double y) const = 0;
+
+    // Evaluate function at n contiguous points: out[i] = f(x[i], y[i]) for i in [0, n)
+    // Block entry point used by the solvers, the default falls back to the scalar operator.
+    // Derived classes can override it to pay one virtual call per block instead of per point.
+    virtual void evaluate(const double* x, const double* y, double* out, std::size_t n) const {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = (*this)(x[i], y[i]);
+        }
+    }
+
     virtual ~Function2D() = default;
-};
\ No newline at end of file
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include "Function2D.h"
+#include <array>
+#include <cstddef>
+
+/*
+Integrand in D dimensions, D fixed at compile time.
+
+A point is a std::array<double, D>, so it lives on the stack like the (x, y) pair of Function2D.
+The block entry point takes the coordinates as D separate arrays (structure of arrays):
+coordinate d of point i is x[d][i]. This is the layout of Function2D::evaluate(x, y, out, n),
+the solvers fill the arrays in blocks of SolverND<D>::block_size points.
+*/
+template <std::size_t D>
+class FunctionND {
+public:
+    static_assert(D >= 1, "FunctionND needs at least one dimension");
+
+    using Point = std::array<double, D>;
+    using Coordinates = std::array<const double*, D>;
+
+    static constexpr std::size_t dimensions = D;
+
+    // Evaluate function at the point x
+    virtual double operator()(const Point& x) const = 0;
+
+    // Evaluate function at n points: out[i] = f(x[0][i], ..., x[D-1][i]) for i in [0, n)
+    // The default gathers every point into a stack Point and calls the scalar operator.
+    virtual void evaluate(const Coordinates& x, double* out, std::size_t n) const {
+        Point p;
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t d = 0; d < D; ++d) {
+                p[d] = x[d][i];
+            }
+            out[i] = (*this)(p);
+        }
+    }
+
+    virtual ~FunctionND() = default;
+};
+
+// View of a Function2D as FunctionND<2>, the blocks go straight to Function2D::evaluate.
+// Lets every existing 2D integrand run through the N-D solvers.
+class Function2DAsND : public FunctionND<2> {
+public:
+    // f has to outlive the view
+    explicit Function2DAsND(const Function2D& f) : f_(f) {}
+
+    double operator()(const Point& x) const override { return f_(x[0], x[1]); }
+
+    void evaluate(const Coordinates& x, double* out, std::size_t n) const override {
+        f_.evaluate(x[0], x[1], out, n);
+    }
+
+private:
+    const Function2D& f_;
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include "Solver2D.h"
+#include "Accumulator.h"
+#include "ParallelSum.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Tensor-product composite Gauss-Legendre integrator on [a,b] x [c,d].
+// Each direction is split into equal panels, every panel pair is integrated with the
+// order x order point product rule. Nodes and weights come from GaussLegendreRule.h.
+class GaussLegendre2DSolver : public Solver2D {
+public:
+    // order = points per panel and direction, clamped to [1, 64]
+    // panels_x / panels_y = number of panels in x and y direction (fall back to 1 if 0)
+    // threads = number of worker threads, 0 means std::thread::hardware_concurrency()
+    // summation = accumulation policy of the grid sums, see Accumulator.h
+    // explicit prevents implicit creation
+    explicit GaussLegendre2DSolver(std::size_t order = 16, std::size_t panels_x = 1, std::size_t panels_y = 1,
+                                   unsigned threads = 0, Summation summation = Summation::Pairwise);
+
+    // integrate method to be overridden
+    double integrate(const Function2D& f,
+                    double a, double b,
+                    double c, double d) const override;
+
+    // all integrands in one sweep over the grid, see Solver2D::integrate_many
+    std::vector<double> integrate_many(const std::vector<const Function2D*>& fs,
+                                       double a, double b,
+                                       double c, double d) const override;
+
+    // rule and parameters, see Solver2D::configuration
+    std::string configuration() const override;
+
+    // number of worker threads used by integrate
+    // the result is bit-identical for every thread count
+    unsigned threads() const { return threads_; }
+
+private:
+    std::size_t order_;
+    std::size_t panels_x_;
+    std::size_t panels_y_;
+    unsigned threads_;
+    Summation summation_;
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include "TensorProductND.h"
+#include "GaussLegendreRule.h"
+#include <algorithm>
+#include <cstddef>
+#include <string>
+
+// Tensor-product composite Gauss-Legendre integrator on a D-dimensional box,
+// the N-D form of GaussLegendre2DSolver: order^D points per panel, panels^D panels.
+template <std::size_t D>
+class GaussLegendreNDSolver : public TensorProductNDSolver<D> {
+public:
+    // order = points per panel and dimension, clamped to [1, 64]
+    // panels = number of panels per dimension (falls back to 1 if 0)
+    // threads = number of worker threads, 0 means std::thread::hardware_concurrency()
+    explicit GaussLegendreNDSolver(std::size_t order = 8, std::size_t panels = 1, unsigned threads = 0)
+        : TensorProductNDSolver<D>(threads),
+          order_(std::min(std::max<std::size_t>(order, 1), gauss_legendre_max_order)),
+          panels_(panels ? panels : 1) {}
+
+    // rule and parameters, see SolverND::configuration
+    std::string configuration() const override {
+        return "GaussLegendreND<" + std::to_string(D) + ">(order=" + std::to_string(order_)
+             + ",panels=" + std::to_string(panels_) + ")";
+    }
+
+protected:
+    TensorRule1D rule(std::size_t, double lo, double hi) const override {
+        return gauss_legendre_composite_rule(order_, panels_, lo, hi);
+    }
+
+private:
+    std::size_t order_;
+    std::size_t panels_;
+};
@@ -0,0 +1,100 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+/*
+Gauss-Legendre nodes and weights on [-1, 1] for orders 1..gauss_legendre_max_order.
+
+The nodes are the roots of the Legendre polynomial P_n, found by Newton iteration on the
+three-term recurrence starting from the approximation cos(pi (i - 1/4) / (n + 1/2)),
+the weights are w_i = 2 / ((1 - x_i^2) P_n'(x_i)^2). Everything is constexpr: the table in
+src/GaussLegendreRule.cpp is computed by the compiler, there is no startup cost.
+*/
+
+constexpr std::size_t gauss_legendre_max_order = 64;
+
+// nodes (ascending) and weights of one rule, both arrays have `order` entries
+struct GaussLegendreRule {
+    const double* nodes;
+    const double* weights;
+    std::size_t order;
+};
+
+// rule of the given order, order must be in [1, gauss_legendre_max_order]
+GaussLegendreRule gauss_legendre_rule(std::size_t order);
+
+namespace gauss_legendre_detail {
+
+// all rules 1..max_order stored back to back, rule n starts at offset(n)
+constexpr std::size_t offset(std::size_t order) { return order * (order - 1) / 2; }
+constexpr std::size_t table_size = offset(gauss_legendre_max_order + 1);
+
+struct Table {
+    std::array<double, table_size> nodes{};
+    std::array<double, table_size> weights{};
+};
+
+constexpr double pi = 3.14159265358979323846;
+
+constexpr double abs(double x) { return x < 0.0 ? -x : x; }
+
+// cos on [0, pi] by its Taylor series, only used for the Newton starting values
+constexpr double cos_series(double x) {
+    const double x2 = x * x;
+    double term = 1.0;
+    double sum = 1.0;
+    for (int k = 1; k < 40; ++k) {
+        term *= -x2 / static_cast<double>((2 * k - 1) * (2 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+struct LegendreValue {
+    double p;   // P_n(x)
+    double dp;  // P_n'(x)
+};
+
+// P_n(x) and its derivative from the recurrence k P_k = (2k-1) x P_(k-1) - (k-1) P_(k-2), |x| < 1
+constexpr LegendreValue legendre(std::size_t n, double x) {
+    double p0 = 1.0;
+    double p1 = x;
+    for (std::size_t k = 2; k <= n; ++k) {
+        const double pk = (static_cast<double>(2 * k - 1) * x * p1 - static_cast<double>(k - 1) * p0)
+                        / static_cast<double>(k);
+        p0 = p1;
+        p1 = pk;
+    }
+    const double dp = static_cast<double>(n) * (x * p1 - p0) / (x * x - 1.0);
+    return {p1, dp};
+}
+
+constexpr Table make_table() {
+    Table table;
+    for (std::size_t n = 1; n <= gauss_legendre_max_order; ++n) {
+        const std::size_t base = offset(n);
+        // roots come in pairs +-x, compute the positive ones (descending) and mirror them
+        for (std::size_t i = 0; i < (n + 1) / 2; ++i) {
+            double x = cos_series(pi * (static_cast<double>(i) + 0.75) / (static_cast<double>(n) + 0.5));
+            if (2 * i + 1 == n) {
+                x = 0.0;  // middle root of an odd order rule
+            } else {
+                for (int it = 0; it < 100; ++it) {
+                    const LegendreValue v = legendre(n, x);
+                    const double dx = v.p / v.dp;
+                    x -= dx;
+                    if (abs(dx) <= 1e-17) break;
+                }
+            }
+            const double dp = legendre(n, x).dp;
+            const double w = 2.0 / ((1.0 - x * x) * dp * dp);
+            table.nodes[base + i] = -x;
+            table.weights[base + i] = w;
+            table.nodes[base + n - 1 - i] = x;
+            table.weights[base + n - 1 - i] = w;
+        }
+    }
+    return table;
+}
+
+}
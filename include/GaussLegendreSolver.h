@@ -0,0 +1,41 @@
+#pragma once
+#include "Solver.h"
+#include "IntegrationKernels.h"
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Composite Gauss-Legendre integrator: [a,b] is split into `panels` equal panels and each panel
+// is integrated with the `order` point Gauss-Legendre rule (exact for polynomials of degree 2*order-1).
+// Nodes and weights come from the compile-time table in GaussLegendreRule.h.
+class GaussLegendreSolver : public Solver {
+public:
+    // order = points per panel, clamped to [1, 64]
+    // panels = number of panels (falls back to 1 if 0)
+    // summation = accumulation policy of the weighted sum, see Accumulator.h
+    // explicit prevents implicit creation
+    explicit GaussLegendreSolver(std::size_t order = 16, std::size_t panels = 1,
+                                 Summation summation = Summation::Pairwise);
+
+    // integrate method from the Solver class
+    double integrate(const Function& f, double a, double b) const override;
+
+    // any other callable double(double), e.g. a lambda: same rule with the call inlined,
+    // see IntegrationKernels.h
+    template <typename F, typename = std::enable_if_t<!std::is_base_of<Function, F>::value>>
+    double integrate(const F& f, double a, double b) const {
+        return kernels::gauss_legendre(f, a, b, order_, panels_, summation_);
+    }
+
+    // all integrands in one sweep over the nodes, see Solver::integrate_many
+    std::vector<double> integrate_many(const std::vector<const Function*>& fs, double a, double b) const override;
+
+    // rule and parameters, see Solver::configuration
+    std::string configuration() const override;
+
+private:
+    std::size_t order_;
+    std::size_t panels_;
+    Summation summation_;
+};
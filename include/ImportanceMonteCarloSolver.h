@@ -0,0 +1,46 @@
+#pragma once
+#include "Solver.h"
+#include "ParallelSum.h"
+#include "Proposal.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Importance sampling Monte Carlo integrator: the samples are drawn from a proposal density p
+// by inversion (see Proposal.h) and the estimate is the mean of f(x) / p(x).
+// With p close to proportional to |f| the variance drops sharply, e.g. PowerLawProposal(0.5)
+// makes f(x) = 1/sqrt(x) on [0,1] a constant weight.
+// Sample i comes from the Philox counter (seed, i), the result does not depend on the thread count.
+// configuration() stays empty (not cacheable): a user-supplied proposal has no description.
+class ImportanceMonteCarloSolver : public Solver {
+public:
+    // result of one integration
+    struct Result {
+        double value;         // mean of f(x_i) / p(x_i)
+        double error;         // standard error of value
+        std::size_t samples;  // number of samples used (n)
+    };
+
+    // n = number of samples (falls back to 1 if 0)
+    // proposal = sampling density, shared (throws std::invalid_argument if null)
+    // seed = 0 means "random seed" (non-deterministic)
+    // threads = worker threads, 0 means std::thread::hardware_concurrency()
+    explicit ImportanceMonteCarloSolver(std::size_t n, std::shared_ptr<const Proposal> proposal,
+                                        std::uint64_t seed = 0, unsigned threads = 0);
+
+    // integrate method from the Solver class, returns only the value
+    double integrate(const Function& f, double a, double b) const override;
+
+    // same integration, also reports the error estimate
+    Result integrate_importance(const Function& f, double a, double b) const;
+
+    // every evaluation is a sample, see Solver::sampling
+    bool sampling() const override { return true; }
+
+private:
+    std::size_t n_;
+    std::shared_ptr<const Proposal> proposal_;
+    std::uint64_t seed_;
+    unsigned threads_;
+};
@@ -0,0 +1,171 @@
+#pragma once
+#include "Solver.h"
+#include "Solver2D.h"
+#include "CountingFunction.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+Opt-in instrumentation of integration calls.
+
+InstrumentedSolver / InstrumentedSolver2D wrap any Solver / Solver2D (like CachedSolver) and record
+for every call the number of integrand evaluations, the wall-clock and CPU time and, for the
+sampling solvers (Solver::sampling), the number of samples. The per-call numbers are returned by
+integrate_instrumented, the totals over all calls are kept in a SolverStats that can be read with
+snapshot() and dumped as text or JSON.
+
+Evaluations are counted by wrapping the integrand for the duration of the call (CountingFunction.h):
+one relaxed atomic add per evaluate block, per point for the solvers that call operator() directly.
+Unwrapped solvers pay nothing; a wrapped solver with set_enabled(false) forwards to the wrapped
+solver after one atomic load.
+
+The wrappers can be called concurrently: every call counts into its own counter and the
+totals are updated once per call under a mutex. CPU time is the CPU time of the whole process
+(std::clock) during the call, it includes the worker threads of the call and, for overlapping
+concurrent calls, the work of the other calls too.
+*/
+
+// cost of one integration call
+struct CallStats {
+    std::uint64_t evaluations;  // integrand evaluations
+    std::uint64_t samples;      // evaluations of a sampling solver, 0 for the deterministic rules
+    double wall_seconds;        // wall-clock time
+    double cpu_seconds;         // process CPU time (all threads)
+
+    // evaluations per wall-clock second, 0 if no time was measured
+    double evaluations_per_second() const;
+};
+
+// totals over all instrumented calls of one solver
+struct SolverStats {
+    std::string name;           // the name given to the wrapper, by default the solver configuration
+    std::uint64_t calls;        // integrate calls (integrate_many counts one call per integrand)
+    std::uint64_t evaluations;
+    std::uint64_t samples;
+    double wall_seconds;
+    double cpu_seconds;
+    CallStats last;             // the most recently finished call
+
+    // evaluations per wall-clock second over all calls, 0 if no time was measured
+    double evaluations_per_second() const;
+
+    // one line "name: calls=... evaluations=... ..." for logs
+    std::string to_text() const;
+
+    // one JSON object with the fields above, for scraping
+    std::string to_json() const;
+};
+
+// JSON array of the stats of several solvers
+std::string to_json(const std::vector<SolverStats>& stats);
+
+// shared bookkeeping of InstrumentedSolver and InstrumentedSolver2D
+class SolverInstrumentation {
+public:
+    explicit SolverInstrumentation(std::string name) : name_(std::move(name)) {}
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+    void set_enabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+    // adds one finished call to the totals
+    void record(const CallStats& call);
+
+    SolverStats snapshot() const;
+    void reset();
+
+private:
+    std::string name_;
+    std::atomic<bool> enabled_{true};
+    mutable std::mutex mutex_;
+    SolverStats totals_{};
+};
+
+class InstrumentedSolver : public Solver {
+public:
+    // solver = the wrapped solver, name = label of the stats (empty: the solver configuration)
+    explicit InstrumentedSolver(std::unique_ptr<Solver> solver, std::string name = std::string());
+
+    // result of one instrumented call
+    struct Result {
+        double value;
+        CallStats stats;
+    };
+
+    // integrates with the wrapped solver and records the call (if enabled)
+    double integrate(const Function& f, double a, double b) const override;
+
+    // same integration, also returns the cost of this call (measured even when disabled, not recorded then)
+    Result integrate_instrumented(const Function& f, double a, double b) const;
+
+    // forwards to the wrapped integrate_many (fused sweeps stay fused), records one call per integrand
+    // sharing the time of the sweep equally
+    std::vector<double> integrate_many(const std::vector<const Function*>& fs, double a, double b) const override;
+
+    // same configuration as the wrapped solver
+    std::string configuration() const override { return solver_->configuration(); }
+
+    // sampling if the wrapped solver is
+    bool sampling() const override { return solver_->sampling(); }
+
+    // recording on / off, on by default
+    void set_enabled(bool enabled) { instrumentation_.set_enabled(enabled); }
+    bool enabled() const { return instrumentation_.enabled(); }
+
+    // totals over all recorded calls
+    SolverStats snapshot() const { return instrumentation_.snapshot(); }
+    void reset() { instrumentation_.reset(); }
+
+private:
+    std::unique_ptr<Solver> solver_;
+    mutable SolverInstrumentation instrumentation_;
+};
+
+class InstrumentedSolver2D : public Solver2D {
+public:
+    // solver = the wrapped solver, name = label of the stats (empty: the solver configuration)
+    explicit InstrumentedSolver2D(std::unique_ptr<Solver2D> solver, std::string name = std::string());
+
+    // result of one instrumented call
+    struct Result {
+        double value;
+        CallStats stats;
+    };
+
+    // integrates with the wrapped solver and records the call (if enabled)
+    double integrate(const Function2D& f,
+                     double a, double b,
+                     double c, double d) const override;
+
+    // same integration, also returns the cost of this call (measured even when disabled, not recorded then)
+    Result integrate_instrumented(const Function2D& f,
+                                  double a, double b,
+                                  double c, double d) const;
+
+    // forwards to the wrapped integrate_many, records one call per integrand
+    std::vector<double> integrate_many(const std::vector<const Function2D*>& fs,
+                                       double a, double b,
+                                       double c, double d) const override;
+
+    // same configuration as the wrapped solver
+    std::string configuration() const override { return solver_->configuration(); }
+
+    // sampling if the wrapped solver is
+    bool sampling() const override { return solver_->sampling(); }
+
+    // recording on / off, on by default
+    void set_enabled(bool enabled) { instrumentation_.set_enabled(enabled); }
+    bool enabled() const { return instrumentation_.enabled(); }
+
+    // totals over all recorded calls
+    SolverStats snapshot() const { return instrumentation_.snapshot(); }
+    void reset() { instrumentation_.reset(); }
+
+private:
+    std::unique_ptr<Solver2D> solver_;
+    mutable SolverInstrumentation instrumentation_;
+};
@@ -0,0 +1,232 @@
+#pragma once
+#include "Accumulator.h"
+#include "Function.h"
+#include "GaussLegendreRule.h"
+#include "ParallelSum.h"
+#include "Philox.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+
+/*
+Header-only integration kernels, templated on the integrand type.
+
+    kernels::simpson([](double x) { return x * x; }, 0.0, 1.0, 1000);
+
+F is any callable double(double): a lambda, a functor or a Function. For a lambda or functor the
+call is resolved at compile time, inlined into the block loop and the loop can be vectorized.
+Function objects (and classes derived from it) keep going through their evaluate override, one
+virtual call per block; this is how TrapezoidSolver, SimpsonSolver, WeddleSolver,
+GaussLegendreSolver and MonteCarloSolver implement integrate, so for a Function the kernels
+give exactly the results of the solver classes.
+
+Nodes, blocks, chunks and the summation policy (Accumulator.h) are the ones of the solver classes:
+the results are bit-identical for every thread count.
+*/
+
+namespace kernels {
+
+// nodes per evaluation block and per work item, the values of Solver::block_size / Solver::chunk_size
+constexpr std::size_t block_size = 256;
+constexpr std::size_t chunk_size = 64 * block_size;
+
+// throws std::invalid_argument unless a < b
+inline void validate_interval(double a, double b) {
+    if (!(a < b)) throw std::invalid_argument("Invalid interval: require a < b");
+}
+
+// out[i] = f(x[i]) for i in [0, n)
+// Function objects use their evaluate override, any other callable is called directly (inlined)
+template <typename F>
+inline void evaluate_block(const F& f, const double* x, double* out, std::size_t n) {
+    if constexpr (std::is_base_of<Function, F>::value) {
+        f.evaluate(x, out, n);
+    } else {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = f(x[i]);
+        }
+    }
+}
+
+// composite trapezoidal rule with n subintervals (0 falls back to 1)
+// threads = worker threads, 0 means std::thread::hardware_concurrency()
+template <typename F>
+double trapezoid(const F& f, double a, double b, std::size_t n, unsigned threads = 1,
+                 Summation summation = Summation::Pairwise) {
+    validate_interval(a, b);
+    n = n ? n : 1;
+    const double h = (b - a) / static_cast<double>(n);
+
+    // h·[f(a)/2 + Σ f(x_i) + f(b)/2], interior nodes x_i, i = 1..n-1, in fixed chunks
+    const double interior = parallel_sum(n - 1, chunk_size, threads, [&](std::size_t begin, std::size_t end) {
+        double xs[block_size];
+        double fx[block_size];
+        Accumulator chunk(summation);
+        for (std::size_t i = begin; i < end; i += block_size) {
+            const std::size_t m = std::min(block_size, end - i);
+            for (std::size_t k = 0; k < m; ++k) {
+                xs[k] = a + (i + k + 1) * h;
+            }
+            evaluate_block(f, xs, fx, m);
+            chunk.add(fx, m);
+        }
+        return chunk.sum();
+    });
+    double s = 0.5 * (f(a) + f(b));
+    s += interior;
+    return s * h;
+}
+
+// composite Simpson rule with n subintervals (0 becomes 2, odd n is rounded up)
+// threads = worker threads, 0 means std::thread::hardware_concurrency()
+template <typename F>
+double simpson(const F& f, double a, double b, std::size_t n, unsigned threads = 1,
+               Summation summation = Summation::Pairwise) {
+    validate_interval(a, b);
+    n = (n == 0) ? 2 : ((n % 2 == 0) ? n : n + 1);
+    const double h = (b - a) / static_cast<double>(n);
+
+    // interior nodes x_i, i = 1..n-1, weight 4 at odd and 2 at even indices
+    const double interior = parallel_sum(n - 1, chunk_size, threads, [&](std::size_t begin, std::size_t end) {
+        double xs[block_size];
+        double fx[block_size];
+        double odd[block_size / 2];
+        double even[block_size / 2];
+        Accumulator s_odd(summation);
+        Accumulator s_even(summation);
+        for (std::size_t j = begin; j < end; j += block_size) {
+            const std::size_t m = std::min(block_size, end - j);
+            for (std::size_t k = 0; k < m; ++k) {
+                xs[k] = a + (j + k + 1) * h;
+            }
+            evaluate_block(f, xs, fx, m);
+            // chunk_size and block_size are even, so j is even and node index i = j + k + 1
+            // is odd for even k
+            for (std::size_t k = 0; k < m; ++k) {
+                (k % 2 == 0 ? odd : even)[k / 2] = fx[k];
+            }
+            s_odd.add(odd, (m + 1) / 2);
+            s_even.add(even, m / 2);
+        }
+        return 4.0 * s_odd.sum() + 2.0 * s_even.sum();
+    });
+    double s = f(a) + f(b);
+    s += interior;
+    return s * (h / 3.0);
+}
+
+// Weddle rule of WeddleSolver, (h/2)[f(a) + f(b) + 2·Σ f(midpoints)], n subintervals (0 falls back to 1)
+// threads = worker threads, 0 means std::thread::hardware_concurrency()
+template <typename F>
+double weddle(const F& f, double a, double b, std::size_t n, unsigned threads = 1,
+              Summation summation = Summation::Pairwise) {
+    validate_interval(a, b);
+    n = n ? n : 1;
+    const double h = (b - a) / static_cast<double>(n);
+
+    const double mid = parallel_sum(n, chunk_size, threads, [&](std::size_t begin, std::size_t end) {
+        double xs[block_size];
+        double fx[block_size];
+        Accumulator chunk(summation);
+        for (std::size_t i = begin; i < end; i += block_size) {
+            const std::size_t m = std::min(block_size, end - i);
+            for (std::size_t k = 0; k < m; ++k) {
+                xs[k] = a + (static_cast<double>(i + k) + 0.5) * h;
+            }
+            evaluate_block(f, xs, fx, m);
+            chunk.add(fx, m);
+        }
+        return chunk.sum();
+    });
+    double sum = f(a) + f(b);
+    sum += 2.0 * mid;
+    return sum * (h / 2.0);
+}
+
+// composite Gauss-Legendre rule, order clamped to [1, 64] points on each of `panels` panels (0 falls back to 1)
+template <typename F>
+double gauss_legendre(const F& f, double a, double b, std::size_t order, std::size_t panels = 1,
+                      Summation summation = Summation::Pairwise) {
+    validate_interval(a, b);
+    order = std::min(std::max<std::size_t>(order, 1), gauss_legendre_max_order);
+    panels = panels ? panels : 1;
+    const GaussLegendreRule rule = gauss_legendre_rule(order);
+    const double H = (b - a) / static_cast<double>(panels);
+    const double half = 0.5 * H;
+
+    // the nodes of all panels are numbered k = p*order + i and generated in blocks
+    const std::size_t count = panels * order;
+    double xs[block_size];
+    double ws[block_size];
+    double fx[block_size];
+    Accumulator sum(summation);
+    for (std::size_t k0 = 0; k0 < count; k0 += block_size) {
+        const std::size_t m = std::min(block_size, count - k0);
+        for (std::size_t k = 0; k < m; ++k) {
+            const std::size_t p = (k0 + k) / order;
+            const std::size_t i = (k0 + k) % order;
+            const double center = a + (static_cast<double>(p) + 0.5) * H;
+            xs[k] = center + half * rule.nodes[i];
+            ws[k] = rule.weights[i];
+        }
+        evaluate_block(f, xs, fx, m);
+        sum.add_products(ws, fx, m);
+    }
+    return sum.sum() * half;
+}
+
+// plain Monte Carlo with n uniform samples (0 falls back to 1) from one std::mt19937_64 stream seeded with seed
+template <typename F>
+double monte_carlo(const F& f, double a, double b, std::size_t n, std::uint64_t seed,
+                   Summation summation = Summation::Pairwise) {
+    validate_interval(a, b);
+    n = n ? n : 1;
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> dist(a, b);
+
+    double xs[block_size];
+    double fx[block_size];
+    Accumulator sum(summation);
+    for (std::size_t i = 0; i < n; i += block_size) {
+        const std::size_t m = std::min(block_size, n - i);
+        for (std::size_t k = 0; k < m; ++k) {
+            xs[k] = dist(rng);
+        }
+        evaluate_block(f, xs, fx, m);
+        sum.add(fx, m);
+    }
+    return (b - a) / static_cast<double>(n) * sum.sum();
+}
+
+// plain Monte Carlo with n uniform samples (0 falls back to 1), sample i from the Philox counter (seed, i)
+// threads = worker threads, 0 means std::thread::hardware_concurrency()
+template <typename F>
+double monte_carlo_parallel(const F& f, double a, double b, std::size_t n, std::uint64_t seed,
+                            unsigned threads = 1, Summation summation = Summation::Pairwise) {
+    validate_interval(a, b);
+    n = n ? n : 1;
+    const Philox4x32 rng(seed);
+    const double width = b - a;
+
+    const double sum = parallel_sum(n, chunk_size, threads, [&](std::size_t begin, std::size_t end) {
+        double xs[block_size];
+        double fx[block_size];
+        Accumulator chunk(summation);
+        for (std::size_t i = begin; i < end; i += block_size) {
+            const std::size_t m = std::min(block_size, end - i);
+            for (std::size_t k = 0; k < m; ++k) {
+                const Philox4x32::result_type r = rng(static_cast<std::uint64_t>(i + k));
+                xs[k] = a + width * Philox4x32::to_unit(r[0], r[1]);
+            }
+            evaluate_block(f, xs, fx, m);
+            chunk.add(fx, m);
+        }
+        return chunk.sum();
+    });
+    return (b - a) / static_cast<double>(n) * sum;
+}
+
+}
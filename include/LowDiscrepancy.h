@@ -0,0 +1,63 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/*
+Randomized low-discrepancy sequences for the quasi-Monte Carlo solvers.
+
+Both generators produce point i of a fixed sequence directly from its index, so blocks of
+points can be generated anywhere in the sequence (by any thread) and fed to Function::evaluate.
+Every coordinate is generated separately: generate(d, begin, out, n) writes coordinate d of
+the points begin .. begin+n-1. All values lie in the open interval (0, 1), so integrands that
+are singular at an endpoint (1/sqrt(x), log(x) on [0,1]) are never evaluated there.
+
+The seed selects an independent randomization of the same sequence, the solvers average a few
+randomized replicates and use their spread as error estimate.
+*/
+
+// Sobol sequence (Joe-Kuo direction numbers, up to max_dimensions coordinates, 2^32 points)
+// with nested uniform (Owen) scrambling via the hash-based permutation of Burley (2020).
+// The scrambling keeps the (t,m,s)-net structure: for n = 2^m the points stratify every
+// elementary interval, so n should preferably be a power of two.
+// Points are in Gray code order, which gives the same point sets for every block of 2^m indices.
+class SobolSequence {
+public:
+    static constexpr std::size_t max_dimensions = 8;
+    static constexpr std::uint64_t max_points = std::uint64_t(1) << 32;
+
+    // dimensions = number of coordinates, clamped to [1, max_dimensions]
+    // seed selects the scrambling
+    SobolSequence(std::size_t dimensions, std::uint64_t seed);
+
+    std::size_t dimensions() const { return dimensions_; }
+
+    // coordinate `dimension` of points begin .. begin+n-1 into out[0..n)
+    // throws std::out_of_range if dimension >= dimensions() or the points exceed max_points
+    void generate(std::size_t dimension, std::uint64_t begin, double* out, std::size_t n) const;
+
+private:
+    std::size_t dimensions_;
+    std::array<std::uint32_t, max_dimensions> scramble_;
+};
+
+// Halton sequence (radical inverses in the first max_dimensions primes)
+// randomized by a uniform random shift modulo 1 per coordinate (Cranley-Patterson rotation).
+class HaltonSequence {
+public:
+    static constexpr std::size_t max_dimensions = 8;
+
+    // dimensions = number of coordinates, clamped to [1, max_dimensions]
+    // seed selects the random shift
+    HaltonSequence(std::size_t dimensions, std::uint64_t seed);
+
+    std::size_t dimensions() const { return dimensions_; }
+
+    // coordinate `dimension` of points begin .. begin+n-1 into out[0..n)
+    // throws std::out_of_range if dimension >= dimensions()
+    void generate(std::size_t dimension, std::uint64_t begin, double* out, std::size_t n) const;
+
+private:
+    std::size_t dimensions_;
+    std::array<double, max_dimensions> shift_;
+};
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+/*
+Thread-safe least-recently-used cache with a bounded number of entries and hit / miss counters.
+Used by CachedSolver / CachedSolver2D to memoize integration results.
+*/
+template <class Key, class Value, class Hash>
+class LruCache {
+public:
+    // counters and size at one point in time
+    struct Stats {
+        std::size_t hits;
+        std::size_t misses;
+        std::size_t size;
+        std::size_t capacity;
+    };
+
+    // capacity = maximal number of entries (falls back to 1 if 0)
+    explicit LruCache(std::size_t capacity) : capacity_(capacity ? capacity : 1) {}
+
+    // looks up key, on a hit copies the value to out and marks the entry as most recently used
+    bool get(const Key& key, Value& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = index_.find(key);
+        if (it == index_.end()) {
+            ++misses_;
+            return false;
+        }
+        ++hits_;
+        items_.splice(items_.begin(), items_, it->second);
+        out = it->second->second;
+        return true;
+    }
+
+    // inserts or updates key, evicts the least recently used entry when the cache is full
+    void put(const Key& key, const Value& value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = index_.find(key);
+        if (it != index_.end()) {
+            it->second->second = value;
+            items_.splice(items_.begin(), items_, it->second);
+            return;
+        }
+        items_.emplace_front(key, value);
+        index_.emplace(key, items_.begin());
+        if (items_.size() > capacity_) {
+            index_.erase(items_.back().first);
+            items_.pop_back();
+        }
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        items_.clear();
+        index_.clear();
+        hits_ = 0;
+        misses_ = 0;
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return {hits_, misses_, items_.size(), capacity_};
+    }
+
+private:
+    using Item = std::pair<Key, Value>;
+
+    std::size_t capacity_;
+    std::list<Item> items_;  // most recently used first
+    std::unordered_map<Key, typename std::list<Item>::iterator, Hash> index_;
+    std::size_t hits_ = 0;
+    std::size_t misses_ = 0;
+    mutable std::mutex mutex_;
+};
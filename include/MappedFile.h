@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+/*
+Read-only memory map of a whole file (mmap on POSIX, MapViewOfFile on Windows).
+
+The file is not read up front: pages are faulted in by whichever thread touches them first and
+evicted by the OS under memory pressure, so files larger than the RAM can be integrated and the
+worker threads of the sampled solvers stream through their own chunks of the file in parallel.
+The mapping is advised as sequential where the OS supports it.
+*/
+class MappedFile {
+public:
+    // maps the file, throws std::runtime_error if it cannot be opened or mapped
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // first byte of the file (page aligned, nullptr for an empty file) and size in bytes
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
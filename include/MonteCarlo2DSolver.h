@@ -1,21 +1,68 @@
 #pragma once
 #include "Solver2D.h"
+#include "Accumulator.h"
+#include "ParallelSum.h"
 #include <cstddef>
+#include <string>
 #include <cstdint>
 
 class MonteCarlo2DSolver : public Solver2D {
 public:
+    // Sequential: all samples come from one std::mt19937_64 stream on the calling thread
+    // Parallel: counter-based Philox4x32 stream, sample i is a pure function of (seed, i),
+    //           the samples are drawn on several threads and the estimate for a given seed
+    //           is identical for any thread count
+    enum class Mode { Sequential, Parallel };
+
     // constructor of MonteCarlo Solver in 2D, takes number of sampled points and random seed as input
-    explicit MonteCarlo2DSolver(std::size_t n = 1000000, std::uint64_t seed = 0)
-        : n_(n ? n : 1), seed_(seed) {}
+    // seed = 0 means "random seed" (non-deterministic)
+    // threads = worker threads in Parallel mode, 0 means std::thread::hardware_concurrency()
+    // summation = accumulation policy of the sample sum, see Accumulator.h
+    explicit MonteCarlo2DSolver(std::size_t n = 1000000, std::uint64_t seed = 0,
+                                Mode mode = Mode::Sequential, unsigned threads = 0,
+                                Summation summation = Summation::Pairwise)
+        : n_(n ? n : 1), seed_(seed), mode_(mode), threads_(resolve_threads(threads)), summation_(summation) {}
     // integrate method to be overridden
     // takes reference to 2D Function object and two intervals over which to integrate
     double integrate(const Function2D& f,
                     double a, double b,
                     double c, double d) const override;
 
+    // result of a streaming integration
+    struct Result {
+        double value;         // area * mean of the samples
+        double error;         // standard error of value
+        std::size_t samples;  // number of samples used
+        bool converged;       // false if the budget n ran out before the tolerance was met
+    };
+
+    // Streaming estimate, see MonteCarloSolver::integrate_streaming: stops as soon as the
+    // standard error is at most max(abs_tol, rel_tol * |value|) or n samples are used
+    Result integrate_streaming(const Function2D& f,
+                               double a, double b,
+                               double c, double d,
+                               double abs_tol, double rel_tol = 0.0) const;
+
+    // rule and parameters, see Solver2D::configuration
+    std::string configuration() const override;
+
+    // every evaluation is a sample, see Solver2D::sampling
+    bool sampling() const override { return true; }
+
 private:
+    double integrate_sequential(const Function2D& f, double a, double b,
+                                double c, double d, std::uint64_t seed) const;
+    double integrate_parallel(const Function2D& f, double a, double b,
+                              double c, double d, std::uint64_t seed) const;
+    Result streaming_sequential(const Function2D& f, double a, double b, double c, double d,
+                                double abs_tol, double rel_tol, std::uint64_t seed) const;
+    Result streaming_parallel(const Function2D& f, double a, double b, double c, double d,
+                              double abs_tol, double rel_tol, std::uint64_t seed) const;
+
     // private attributes, the number of samples and the seed
     std::size_t n_;
     std::uint64_t seed_;
-};
\ No newline at end of file
+    Mode mode_;
+    unsigned threads_;
+    Summation summation_;
+};
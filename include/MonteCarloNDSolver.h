@@ -0,0 +1,84 @@
+#pragma once
+#include "SolverND.h"
+#include "Accumulator.h"
+#include "ParallelSum.h"
+#include "Philox.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+
+// Monte Carlo integrator on a D-dimensional box with the counter-based Philox4x32 stream.
+// Coordinates 2p and 2p+1 of sample i come from the counter (i, p): one Philox call gives two
+// coordinates, so sample i is a pure function of (seed, i) and the estimate for a given seed is
+// identical for any thread count. For D = 2 the samples and the summation order are those of
+// MonteCarlo2DSolver in Parallel mode (default Pairwise summation), both give the same result.
+template <std::size_t D>
+class MonteCarloNDSolver : public SolverND<D> {
+public:
+    using typename SolverND<D>::Point;
+
+    // n = number of samples, seed = 0 means "random seed" (non-deterministic)
+    // threads = number of worker threads, 0 means std::thread::hardware_concurrency()
+    explicit MonteCarloNDSolver(std::size_t n = 1000000, std::uint64_t seed = 0, unsigned threads = 0)
+        : n_(n ? n : 1), seed_(seed), threads_(resolve_threads(threads)) {}
+
+    double integrate(const FunctionND<D>& f, const Point& lower, const Point& upper) const override {
+        this->validate_box(lower, upper);
+        const std::uint64_t actual_seed = (seed_ != 0) ? seed_ : std::random_device{}();
+        const Philox4x32 rng(actual_seed);
+        Point width;
+        for (std::size_t d = 0; d < D; ++d) {
+            width[d] = upper[d] - lower[d];
+        }
+
+        constexpr std::size_t block = SolverND<D>::block_size;
+        const double sum = parallel_sum(n_, SolverND<D>::chunk_size, threads_, [&](std::size_t begin, std::size_t end) {
+            // one block of D-wide samples, coordinate d of sample k in xs[d][k]
+            double xs[D][block];
+            double fx[block];
+            typename FunctionND<D>::Coordinates x;
+            for (std::size_t d = 0; d < D; ++d) {
+                x[d] = xs[d];
+            }
+            Accumulator chunk;
+            for (std::size_t i = begin; i < end; i += block) {
+                const std::size_t m = std::min(block, end - i);
+                for (std::size_t k = 0; k < m; ++k) {
+                    const std::uint64_t index = i + k;
+                    for (std::size_t d = 0; d < D; d += 2) {
+                        const Philox4x32::result_type r = rng(static_cast<std::uint32_t>(index),
+                                                              static_cast<std::uint32_t>(index >> 32),
+                                                              static_cast<std::uint32_t>(d / 2));
+                        xs[d][k] = lower[d] + width[d] * Philox4x32::to_unit(r[0], r[1]);
+                        if (d + 1 < D) {
+                            xs[d + 1][k] = lower[d + 1] + width[d + 1] * Philox4x32::to_unit(r[2], r[3]);
+                        }
+                    }
+                }
+                f.evaluate(x, fx, m);
+                chunk.add(fx, m);
+            }
+            return chunk.sum();
+        });
+        return this->volume(lower, upper) * sum / static_cast<double>(n_);
+    }
+
+    // rule and parameters, see SolverND::configuration
+    std::string configuration() const override {
+        // seed 0 draws a new random seed on every call, the result is not reproducible
+        if (seed_ == 0) return std::string();
+        return "MonteCarloND<" + std::to_string(D) + ">(n=" + std::to_string(n_)
+             + ",seed=" + std::to_string(seed_) + ")";
+    }
+
+    // number of worker threads used by integrate
+    unsigned threads() const { return threads_; }
+
+private:
+    std::size_t n_;
+    std::uint64_t seed_;
+    unsigned threads_;
+};
@@ -1,26 +1,80 @@
 #pragma once
 #include "Solver.h"
+#include "IntegrationKernels.h"
 #include <cstddef>
+#include <string>
 #include <cstdint>
+#include <random>
+#include <type_traits>
 
 // Monte Carlo integrator using uniform samples on [a,b].
 // If seed == 0 (default) the RNG is seeded from std::random_device for non-deterministic runs.
 // If seed != 0 the RNG is seeded with that value (deterministic).
 class MonteCarloSolver : public Solver {
 public:
+    // Sequential: all samples come from one std::mt19937_64 stream on the calling thread
+    // Parallel: counter-based Philox4x32 stream, sample i is a pure function of (seed, i),
+    //           the samples are drawn on several threads and the estimate for a given seed
+    //           is identical for any thread count
+    enum class Mode { Sequential, Parallel };
+
     // n = number of samples (falls back to 1 if 0)
     // seed = 0 means "random seed" (non-deterministic)
+    // threads = worker threads in Parallel mode, 0 means std::thread::hardware_concurrency()
+    // summation = accumulation policy of the sample sum, see Accumulator.h
     // explicit: the user has to deliberately create a MonteCarloSolver object, implicit creations are not possible
-    explicit MonteCarloSolver(std::size_t n = 10000, std::uint64_t seed = 0);
+    explicit MonteCarloSolver(std::size_t n = 10000, std::uint64_t seed = 0,
+                              Mode mode = Mode::Sequential, unsigned threads = 0,
+                              Summation summation = Summation::Pairwise);
 
     // integrate f on [a,b] using simple Monte Carlo estimator
     // integration method from Solver class that will be overridden
     double integrate(const Function& f, double a, double b) const override;
 
+    // any other callable double(double), e.g. a lambda: same samples with the call inlined,
+    // see IntegrationKernels.h
+    template <typename F, typename = std::enable_if_t<!std::is_base_of<Function, F>::value>>
+    double integrate(const F& f, double a, double b) const {
+        const std::uint64_t actual_seed = (seed_ != 0) ? seed_ : std::random_device{}();
+        return (mode_ == Mode::Parallel)
+            ? kernels::monte_carlo_parallel(f, a, b, n_, actual_seed, threads_, summation_)
+            : kernels::monte_carlo(f, a, b, n_, actual_seed, summation_);
+    }
+
+    // result of a streaming integration
+    struct Result {
+        double value;         // (b-a) * mean of the samples
+        double error;         // standard error of value
+        std::size_t samples;  // number of samples used
+        bool converged;       // false if the budget n ran out before the tolerance was met
+    };
+
+    // Streaming estimate: samples are drawn in blocks, the running mean and variance are updated
+    // after every block (Welford) and sampling stops as soon as the standard error is at most
+    // max(abs_tol, rel_tol * |value|) or n samples (the budget) are used.
+    // Sequential mode checks after every block of 256 samples, Parallel mode after every round of
+    // 65536 samples drawn on all threads; for a given seed the result does not depend on the thread count.
+    Result integrate_streaming(const Function& f, double a, double b,
+                               double abs_tol, double rel_tol = 0.0) const;
+
+    // rule and parameters, see Solver::configuration
+    std::string configuration() const override;
+
+    // every evaluation is a sample, see Solver::sampling
+    bool sampling() const override { return true; }
+
 private:
+    Result streaming_sequential(const Function& f, double a, double b, double abs_tol, double rel_tol,
+                                std::uint64_t seed) const;
+    Result streaming_parallel(const Function& f, double a, double b, double abs_tol, double rel_tol,
+                              std::uint64_t seed) const;
+
     // private attributes
     // n_ being number of samples
     // seed_ being seed for randomization
     std::size_t n_;
     std::uint64_t seed_;
+    Mode mode_;
+    unsigned threads_;
+    Summation summation_;
 };
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+/*
+Deterministic parallel summation used by the multithreaded solvers.
+
+The index range [0, count) is split into fixed chunks of chunk_size indices. chunk_sum(begin, end)
+returns the partial sum of one chunk, the chunks are distributed over the worker threads and the
+partial sums are combined pairwise in a fixed binary tree. Because neither the chunk boundaries
+nor the combination order depend on the number of threads, the result is bit-identical for any
+thread count.
+*/
+
+// number of worker threads to use, 0 means std::thread::hardware_concurrency() (at least 1)
+unsigned resolve_threads(unsigned requested);
+
+// runs chunk_work(chunk_index, begin, end) for every chunk of [0, count) on up to `threads` threads:
+// the calling thread and up to threads - 1 workers of a persistent pool shared by all callers
+// (started on first use, no thread is created per call). Nested and concurrent calls are allowed.
+// The first exception thrown by a chunk is rethrown in the caller after all threads have finished
+void parallel_chunks(std::size_t count, std::size_t chunk_size, unsigned threads,
+                     const std::function<void(std::size_t, std::size_t, std::size_t)>& chunk_work);
+
+// sum of chunk_sum over all chunks of [0, count), computed on up to `threads` threads
+double parallel_sum(std::size_t count, std::size_t chunk_size, unsigned threads,
+                    const std::function<double(std::size_t, std::size_t)>& chunk_sum);
+
+// `width` sums at once: chunk_sum(begin, end, partial) stores the partial sums of one chunk in
+// partial[0..width), each component is combined in the same fixed tree as the scalar version
+std::vector<double> parallel_sum(std::size_t count, std::size_t chunk_size, unsigned threads, std::size_t width,
+                                 const std::function<void(std::size_t, std::size_t, double*)>& chunk_sum);
@@ -0,0 +1,68 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+/*
+Counter-based random number generator Philox4x32-10
+(Salmon, Moraes, Dror, Shaw: "Parallel random numbers: as easy as 1, 2, 3", SC 2011).
+
+The output is a pure function of a 128 bit counter and a 64 bit key, there is no state.
+Sample i of a stream is generated directly from (key, i), so worker threads can draw
+disjoint index ranges without any coordination and the numbers do not depend on how
+the indices are distributed.
+*/
+class Philox4x32 {
+public:
+    using result_type = std::array<std::uint32_t, 4>;
+
+    // the key selects the stream (the seed of the Monte Carlo solvers)
+    explicit Philox4x32(std::uint64_t key)
+        : k0_(static_cast<std::uint32_t>(key)), k1_(static_cast<std::uint32_t>(key >> 32)) {}
+
+    // four 32 bit random words for the counter (c0, c1, c2, c3)
+    result_type operator()(std::uint32_t c0, std::uint32_t c1,
+                           std::uint32_t c2 = 0, std::uint32_t c3 = 0) const {
+        std::uint32_t k0 = k0_;
+        std::uint32_t k1 = k1_;
+        for (int round = 0; round < 10; ++round) {
+            if (round > 0) {
+                // bump the key with the Weyl sequence constants
+                k0 += 0x9E3779B9u;
+                k1 += 0xBB67AE85u;
+            }
+            const std::uint64_t p0 = static_cast<std::uint64_t>(0xD2511F53u) * c0;
+            const std::uint64_t p1 = static_cast<std::uint64_t>(0xCD9E8D57u) * c2;
+            const std::uint32_t hi0 = static_cast<std::uint32_t>(p0 >> 32);
+            const std::uint32_t lo0 = static_cast<std::uint32_t>(p0);
+            const std::uint32_t hi1 = static_cast<std::uint32_t>(p1 >> 32);
+            const std::uint32_t lo1 = static_cast<std::uint32_t>(p1);
+            c0 = hi1 ^ c1 ^ k0;
+            c1 = lo1;
+            c2 = hi0 ^ c3 ^ k1;
+            c3 = lo0;
+        }
+        return {c0, c1, c2, c3};
+    }
+
+    // random words for sample index i (counter = i)
+    result_type operator()(std::uint64_t i) const {
+        return (*this)(static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(i >> 32));
+    }
+
+    // uniform double in [0, 1) from the top 53 of 64 random bits
+    static double to_unit(std::uint32_t hi, std::uint32_t lo) {
+        const std::uint64_t bits = (static_cast<std::uint64_t>(hi) << 32) | lo;
+        return static_cast<double>(bits >> 11) * 0x1p-53;
+    }
+
+    // uniform double in the open interval (0, 1): the center of one of the 2^53 cells of to_unit,
+    // for samplers that must not hit an endpoint (inverse CDFs, integrands singular at a)
+    static double to_open_unit(std::uint32_t hi, std::uint32_t lo) {
+        const std::uint64_t bits = (static_cast<std::uint64_t>(hi) << 32) | lo;
+        return (static_cast<double>(bits >> 11) + 0.5) * 0x1p-53;
+    }
+
+private:
+    std::uint32_t k0_;
+    std::uint32_t k1_;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+/*
+Proposal densities for importance sampling (see ImportanceMonteCarloSolver).
+
+A proposal is a probability density p on [a,b] that can be sampled by inversion:
+x = inverse_cdf(u) for u uniform in (0,1) is distributed with density p. The estimator averages
+f(x) / p(x), its variance is small when p is roughly proportional to |f|, e.g. a power law with
+the same singularity as the integrand.
+*/
+class Proposal {
+public:
+    // density p(x) on [a,b], must be positive wherever f is non-zero
+    virtual double density(double x, double a, double b) const = 0;
+
+    // x with CDF(x) = u for u in (0,1)
+    virtual double inverse_cdf(double u, double a, double b) const = 0;
+
+    virtual ~Proposal() = default;
+};
+
+// p(x) = alpha (x-a)^(alpha-1) / (b-a)^alpha, alpha > 0
+// alpha < 1 concentrates the samples at a, alpha = 0.5 matches a 1/sqrt(x-a) singularity
+class PowerLawProposal : public Proposal {
+public:
+    // throws std::invalid_argument unless alpha > 0
+    explicit PowerLawProposal(double alpha);
+
+    double density(double x, double a, double b) const override;
+    double inverse_cdf(double u, double a, double b) const override;
+
+private:
+    double alpha_;
+};
+
+// p(x) = rate e^(-rate (x-a)) / (1 - e^(-rate (b-a))), truncated exponential, rate != 0
+// rate > 0 concentrates the samples at a, rate < 0 at b
+class ExponentialProposal : public Proposal {
+public:
+    // throws std::invalid_argument if rate is 0 or not finite
+    explicit ExponentialProposal(double rate);
+
+    double density(double x, double a, double b) const override;
+    double inverse_cdf(double u, double a, double b) const override;
+
+private:
+    double rate_;
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include "Solver2D.h"
+#include "Accumulator.h"
+#include "ParallelSum.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Randomized quasi-Monte Carlo integrator on [a,b] x [c,d], the 2D counterpart of
+// QuasiMonteCarloSolver: coordinates 1 and 2 of a scrambled Sobol or shifted Halton sequence,
+// `replicates` independent randomizations, mean and standard error over them.
+class QuasiMonteCarlo2DSolver : public Solver2D {
+public:
+    // Sobol: Owen-scrambled Sobol points, best with n a power of two
+    // Halton: radical inverses in bases 2 and 3 with a random shift
+    enum class Sequence { Sobol, Halton };
+
+    // result of one integration
+    struct Result {
+        double value;             // mean of the replicate estimates
+        double error;             // standard error of the mean over the replicates
+        std::size_t evaluations;  // n * replicates
+        std::size_t replicates;
+    };
+
+    // n = points per replicate (falls back to 1 if 0, at most 2^32 for Sobol)
+    // replicates = number of independent randomizations (at least 2)
+    // seed = 0 means "random seed" (non-deterministic)
+    // threads = worker threads, 0 means std::thread::hardware_concurrency()
+    // summation = accumulation policy of the replicate sums, see Accumulator.h
+    explicit QuasiMonteCarlo2DSolver(std::size_t n = 65536, std::size_t replicates = 8, std::uint64_t seed = 0,
+                                     Sequence sequence = Sequence::Sobol, unsigned threads = 0,
+                                     Summation summation = Summation::Pairwise);
+
+    // integrate method to be overridden, returns only the value
+    double integrate(const Function2D& f,
+                    double a, double b,
+                    double c, double d) const override;
+
+    // same integration, also reports the error estimate and the cost
+    Result integrate_qmc(const Function2D& f,
+                         double a, double b,
+                         double c, double d) const;
+
+    // rule and parameters, see Solver2D::configuration
+    std::string configuration() const override;
+
+    // every evaluation is a sample, see Solver2D::sampling
+    bool sampling() const override { return true; }
+
+private:
+    std::size_t n_;
+    std::size_t replicates_;
+    std::uint64_t seed_;
+    Sequence sequence_;
+    unsigned threads_;
+    Summation summation_;
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include "Solver.h"
+#include "Accumulator.h"
+#include "ParallelSum.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Randomized quasi-Monte Carlo integrator on [a,b].
+// The samples are the points of a scrambled Sobol or a randomly shifted Halton sequence
+// (see LowDiscrepancy.h) instead of pseudo-random numbers, for smooth integrands the error
+// decreases close to O(n^-1) instead of O(n^-1/2).
+// `replicates` independent randomizations are integrated with n points each, the estimate is
+// their mean and the error estimate the standard error of the mean.
+// Seed handling follows MonteCarloSolver: seed 0 draws a new random seed on every call.
+class QuasiMonteCarloSolver : public Solver {
+public:
+    // Sobol: Owen-scrambled Sobol points, best with n a power of two
+    // Halton: radical inverse in base 2 with a random shift
+    enum class Sequence { Sobol, Halton };
+
+    // result of one integration
+    struct Result {
+        double value;             // mean of the replicate estimates
+        double error;             // standard error of the mean over the replicates
+        std::size_t evaluations;  // n * replicates
+        std::size_t replicates;
+    };
+
+    // n = points per replicate (falls back to 1 if 0, at most 2^32 for Sobol)
+    // replicates = number of independent randomizations (at least 2)
+    // seed = 0 means "random seed" (non-deterministic)
+    // threads = worker threads, 0 means std::thread::hardware_concurrency()
+    // summation = accumulation policy of the replicate sums, see Accumulator.h
+    // explicit prevents implicit creation
+    explicit QuasiMonteCarloSolver(std::size_t n = 4096, std::size_t replicates = 8, std::uint64_t seed = 0,
+                                   Sequence sequence = Sequence::Sobol, unsigned threads = 0,
+                                   Summation summation = Summation::Pairwise);
+
+    // integrate method from the Solver class, returns only the value
+    double integrate(const Function& f, double a, double b) const override;
+
+    // same integration, also reports the error estimate and the cost
+    Result integrate_qmc(const Function& f, double a, double b) const;
+
+    // rule and parameters, see Solver::configuration
+    std::string configuration() const override;
+
+    // every evaluation is a sample, see Solver::sampling
+    bool sampling() const override { return true; }
+
+private:
+    std::size_t n_;
+    std::size_t replicates_;
+    std::uint64_t seed_;
+    Sequence sequence_;
+    unsigned threads_;
+    Summation summation_;
+};
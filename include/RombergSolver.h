@@ -0,0 +1,44 @@
+#pragma once
+#include "Solver.h"
+#include "Accumulator.h"
+#include <cstddef>
+#include <string>
+
+// Romberg integrator: nested trapezoid sequence with n = 1, 2, 4, 8, ... subintervals
+// plus Richardson extrapolation. Every level only evaluates the new midpoints, all
+// previous evaluations are reused through the previous trapezoid value.
+// Stops when two successive diagonal entries agree to max(abs_tol, rel_tol * |R(k,k)|).
+class RombergSolver : public Solver {
+public:
+    // result of one Romberg integration
+    struct Result {
+        double value;             // last diagonal entry R(k,k)
+        double error;             // |R(k,k) - R(k-1,k-1)|
+        std::size_t evaluations;  // number of integrand evaluations
+        std::size_t levels;       // number of halvings k, the finest trapezoid has 2^k subintervals
+        bool converged;           // false if max_levels was reached before the tolerance
+    };
+
+    // abs_tol / rel_tol = requested absolute / relative agreement of the diagonal entries
+    // max_levels = maximal number of interval halvings (2^max_levels + 1 evaluations at most)
+    // summation = accumulation policy of the midpoint sums (up to 2^(max_levels-1) terms), see Accumulator.h
+    // explicit prevents implicit creation
+    explicit RombergSolver(double abs_tol = 1e-10, double rel_tol = 1e-10, std::size_t max_levels = 25,
+                           Summation summation = Summation::Pairwise)
+        : abs_tol_(abs_tol), rel_tol_(rel_tol), max_levels_(max_levels ? max_levels : 1), summation_(summation) {}
+
+    // integrate method from the Solver class, returns only the value
+    double integrate(const Function& f, double a, double b) const override;
+
+    // rule and parameters, see Solver::configuration
+    std::string configuration() const override;
+
+    // same integration, also reports the convergence information
+    Result integrate_romberg(const Function& f, double a, double b) const;
+
+private:
+    double abs_tol_;
+    double rel_tol_;
+    std::size_t max_levels_;
+    Summation summation_;
+};
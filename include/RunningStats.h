@@ -0,0 +1,53 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+/*
+Running mean and variance of a stream of samples (Welford's update), used by the streaming
+Monte Carlo solvers. Partial statistics of separate blocks of samples are combined with the
+pairwise update of Chan, Golub and LeVeque, which is as stable as adding the samples one by one.
+*/
+class RunningStats {
+public:
+    // add one sample
+    void add(double x) {
+        ++count_;
+        const double delta = x - mean_;
+        mean_ += delta / static_cast<double>(count_);
+        m2_ += delta * (x - mean_);
+    }
+
+    // add all samples summarized by other
+    void merge(const RunningStats& other) {
+        if (other.count_ == 0) return;
+        if (count_ == 0) {
+            *this = other;
+            return;
+        }
+        const double n_a = static_cast<double>(count_);
+        const double n_b = static_cast<double>(other.count_);
+        const double n = n_a + n_b;
+        const double delta = other.mean_ - mean_;
+        mean_ += delta * (n_b / n);
+        m2_ += other.m2_ + delta * delta * (n_a * n_b / n);
+        count_ += other.count_;
+    }
+
+    std::size_t count() const { return count_; }
+    double mean() const { return mean_; }
+
+    // unbiased sample variance, 0 for fewer than two samples
+    double variance() const { return count_ > 1 ? m2_ / static_cast<double>(count_ - 1) : 0.0; }
+
+    // standard error of the mean, sqrt(variance / count), infinite for fewer than two samples
+    double standard_error() const {
+        if (count_ < 2) return std::numeric_limits<double>::infinity();
+        return std::sqrt(variance() / static_cast<double>(count_));
+    }
+
+private:
+    std::size_t count_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;  // sum of squared deviations from the mean
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include "Accumulator.h"
+#include "ParallelSum.h"
+#include "Samples.h"
+#include <string>
+
+/*
+Simpson rule applied directly to tabulated samples (Samples.h), e.g. a memory-mapped raw file.
+
+Equally spaced samples with an even number of intervals use the nodes, chunks and summation order of
+SimpsonSolver: samples of f at a + i h (and f(b) last) give SimpsonSolver(count - 1).integrate(f, a, b)
+bit for bit. An odd number of intervals adds the last one with the parabola through the last three
+samples, (h/12)(5 f_n + 8 f_{n-1} - f_{n-2}), so no sample is dropped. Samples at explicit nodes use the
+parabola through each pair of intervals (non-uniform Simpson, see simpson_rule in TensorProduct.h), the
+same end correction and, for a single interval, the trapezoid rule. 2D grids use the weights of
+Simpson2DSolver. The results are bit-identical for every thread count.
+*/
+class SampledSimpsonSolver {
+public:
+    // threads = number of worker threads, 0 means std::thread::hardware_concurrency()
+    // summation = accumulation policy of the sums, see Accumulator.h
+    explicit SampledSimpsonSolver(unsigned threads = 0, Summation summation = Summation::Pairwise)
+        : threads_(resolve_threads(threads)), summation_(summation) {}
+
+    // integral over [samples.a(), samples.b()], throws std::invalid_argument if explicit nodes
+    // are not strictly increasing
+    double integrate(const Samples1D& samples) const;
+
+    // integral over the rectangle spanned by the grid nodes
+    double integrate(const Samples2D& samples) const;
+
+    // "SampledSimpson" with the summation policy, see Solver::configuration
+    std::string configuration() const;
+
+    unsigned threads() const { return threads_; }
+
+private:
+    unsigned threads_;
+    Summation summation_;
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include "Accumulator.h"
+#include "ParallelSum.h"
+#include "Samples.h"
+#include <string>
+
+/*
+Trapezoidal rule applied directly to tabulated samples (Samples.h), e.g. a memory-mapped raw file.
+
+Equally spaced samples use the nodes, chunks and summation order of TrapezoidSolver: samples of f at
+a + i h (and f(b) last) give TrapezoidSolver(count - 1).integrate(f, a, b) bit for bit. Samples at
+explicit nodes sum (x_{i+1} - x_i)(f_i + f_{i+1}) / 2 over the intervals; 2D grids use the weights of
+Trapezoid2DSolver (trapezoid_rule, TensorProduct.h). The results are bit-identical for every thread count.
+*/
+class SampledTrapezoidSolver {
+public:
+    // threads = number of worker threads, 0 means std::thread::hardware_concurrency()
+    // summation = accumulation policy of the sums, see Accumulator.h
+    explicit SampledTrapezoidSolver(unsigned threads = 0, Summation summation = Summation::Pairwise)
+        : threads_(resolve_threads(threads)), summation_(summation) {}
+
+    // integral over [samples.a(), samples.b()], throws std::invalid_argument if explicit nodes
+    // are not strictly increasing
+    double integrate(const Samples1D& samples) const;
+
+    // integral over the rectangle spanned by the grid nodes
+    double integrate(const Samples2D& samples) const;
+
+    // "SampledTrapezoid" with the summation policy, see Solver::configuration
+    std::string configuration() const;
+
+    unsigned threads() const { return threads_; }
+
+private:
+    unsigned threads_;
+    Summation summation_;
+};
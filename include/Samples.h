@@ -0,0 +1,136 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+Tabulated integrands: function values sampled at fixed nodes, integrated directly by
+SampledTrapezoidSolver / SampledSimpsonSolver instead of wrapping them in an interpolating Function.
+
+Samples1D / Samples2D are views: they point at the values (and nodes) and keep whatever owns them
+alive, nothing is copied. The loaders read
+
+raw files  little-endian IEEE doubles without a header. The file is memory-mapped (MappedFile.h) and
+           the samples point straight into the mapping, so a multi-GB file costs no heap and no
+           read pass; the solvers stream through it in chunks on all threads. (On a big-endian host
+           the values are byte-swapped into memory instead.)
+CSV files  one sample (1D) or one grid row (2D) per line, fields separated by ',', ';', tabs or
+           spaces; an optional header line, empty lines and lines starting with '#' are skipped.
+           The text is memory-mapped and parsed on all threads in fixed pieces of lines, only the
+           parsed values are kept.
+
+Errors in the arguments or the file contents throw std::invalid_argument (CSV errors with the line
+number), files that cannot be opened or mapped throw std::runtime_error.
+*/
+
+// f_i at nodes x_0 < x_1 < ... < x_{count-1}, either equally spaced on [a, b] or given explicitly
+class Samples1D {
+public:
+    // f_i = values[i * stride] at the equally spaced nodes a + i (b - a) / (count - 1), count >= 2
+    Samples1D(const double* values, std::size_t count, double a, double b, std::size_t stride = 1);
+
+    // f_i = values[i * stride] at the nodes x_i = x[i * stride], count >= 2
+    // the nodes have to be strictly increasing, the solvers check this while they integrate
+    Samples1D(const double* x, const double* values, std::size_t count, std::size_t stride = 1);
+
+    // raw file f_0, f_1, ..., equally spaced on [a, b]
+    static Samples1D load_raw(const std::string& path, double a, double b);
+
+    // raw file of pairs x_0, f_0, x_1, f_1, ...
+    static Samples1D load_raw_pairs(const std::string& path);
+
+    // CSV file, nodes from column x_column and values from column value_column (0-based)
+    // threads = parser threads, 0 means std::thread::hardware_concurrency()
+    static Samples1D load_csv(const std::string& path, std::size_t x_column = 0, std::size_t value_column = 1,
+                              unsigned threads = 0);
+
+    // CSV file, values from column value_column, equally spaced on [a, b]
+    static Samples1D load_csv_values(const std::string& path, std::size_t value_column, double a, double b,
+                                     unsigned threads = 0);
+
+    std::size_t count() const { return count_; }
+    bool uniform() const { return x_ == nullptr; }
+
+    // first and last node, spacing of equally spaced samples
+    double a() const { return x_ ? x_[0] : a_; }
+    double b() const { return x_ ? x_[(count_ - 1) * stride_] : b_; }
+    double h() const { return (b_ - a_) / static_cast<double>(count_ - 1); }
+
+    double value(std::size_t i) const { return values_[i * stride_]; }
+    double node(std::size_t i) const { return x_ ? x_[i * stride_] : a_ + i * h(); }
+
+    // f_begin .. f_{begin+n-1} as a contiguous array: the samples themselves if they are contiguous,
+    // else copied into buffer (n doubles)
+    const double* values(std::size_t begin, std::size_t n, double* buffer) const {
+        return gather(values_, begin, n, buffer);
+    }
+
+    // same for the explicit nodes x_begin .. x_{begin+n-1}
+    const double* nodes(std::size_t begin, std::size_t n, double* buffer) const {
+        return gather(x_, begin, n, buffer);
+    }
+
+private:
+    const double* gather(const double* p, std::size_t begin, std::size_t n, double* buffer) const {
+        if (stride_ == 1) return p + begin;
+        for (std::size_t k = 0; k < n; ++k) {
+            buffer[k] = p[(begin + k) * stride_];
+        }
+        return buffer;
+    }
+
+    const double* x_ = nullptr;
+    const double* values_;
+    std::size_t count_;
+    std::size_t stride_;
+    double a_ = 0.0;
+    double b_ = 0.0;
+    std::shared_ptr<const void> storage_; // mapped file or parsed values the pointers refer to
+};
+
+// f(x_i, y_j) on an nx x ny grid, stored row by row: values[i * ny + j]
+class Samples2D {
+public:
+    // nodes equally spaced on [a, b] x [c, d], nx, ny >= 2
+    Samples2D(const double* values, std::size_t nx, std::size_t ny, double a, double b, double c, double d);
+
+    // nodes x (nx >= 2) and y (ny >= 2), both strictly increasing
+    Samples2D(const double* values, std::vector<double> x, std::vector<double> y);
+
+    // raw file of nx * ny values, equally spaced on [a, b] x [c, d]
+    static Samples2D load_raw(const std::string& path, std::size_t nx, std::size_t ny,
+                              double a, double b, double c, double d);
+
+    // raw file of x.size() * y.size() values at the given nodes
+    static Samples2D load_raw(const std::string& path, std::vector<double> x, std::vector<double> y);
+
+    // CSV file with one grid row f(x_i, y_0), f(x_i, y_1), ... per line, equally spaced on [a, b] x [c, d]
+    // threads = parser threads, 0 means std::thread::hardware_concurrency()
+    static Samples2D load_csv(const std::string& path, double a, double b, double c, double d, unsigned threads = 0);
+
+    std::size_t nx() const { return x_.size(); }
+    std::size_t ny() const { return y_.size(); }
+    bool uniform() const { return uniform_; }
+
+    // the rectangle [a, b] x [c, d] spanned by the nodes
+    double a() const { return a_; }
+    double b() const { return b_; }
+    double c() const { return c_; }
+    double d() const { return d_; }
+
+    const double* values() const { return values_; }
+    double value(std::size_t i, std::size_t j) const { return values_[i * y_.size() + j]; }
+
+    // the nodes (computed as lo + i h for equally spaced samples)
+    const std::vector<double>& x_nodes() const { return x_; }
+    const std::vector<double>& y_nodes() const { return y_; }
+
+private:
+    const double* values_;
+    std::vector<double> x_;
+    std::vector<double> y_;
+    bool uniform_;
+    double a_, b_, c_, d_;
+    std::shared_ptr<const void> storage_;
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include "Function.h"
+#include "Function2D.h"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/*
+2D integrand that is a sum of products of 1D functions:
+    f(x, y) = Σ_k u_k(x) * v_k(y)
+
+A tensor-product rule applied to such a function factorizes,
+    Σ_i Σ_j wx_i wy_j f(x_i, y_j) = Σ_k (Σ_i wx_i u_k(x_i)) * (Σ_j wy_j v_k(y_j)),
+so the grid solvers (see tensor_product_sum) detect this type and integrate it with
+(nx + ny) evaluations per term instead of nx * ny.
+
+The factors are shared, copies of a SeparableFunction2D refer to the same Function objects.
+Derived classes may override operator() / evaluate with a direct formula (e.g. e^(x+y) for e^x * e^y),
+it has to agree with the sum of products up to rounding.
+*/
+class SeparableFunction2D : public Function2D {
+public:
+    // one product u(x) * v(y)
+    struct Term {
+        std::shared_ptr<const Function> x;
+        std::shared_ptr<const Function> y;
+    };
+
+    // f(x, y) = u(x) * v(y)
+    SeparableFunction2D(std::shared_ptr<const Function> u, std::shared_ptr<const Function> v)
+        : terms_{Term{std::move(u), std::move(v)}} {}
+
+    // f(x, y) = Σ_k terms[k].x(x) * terms[k].y(y)
+    explicit SeparableFunction2D(std::vector<Term> terms) : terms_(std::move(terms)) {}
+
+    // number of products and access to them
+    std::size_t terms() const { return terms_.size(); }
+    const Term& term(std::size_t k) const { return terms_[k]; }
+
+    double operator()(double x, double y) const override {
+        double s = 0.0;
+        for (const Term& t : terms_) {
+            s += (*t.x)(x) * (*t.y)(y);
+        }
+        return s;
+    }
+
+    // the factors are evaluated blockwise through their own evaluate
+    void evaluate(const double* x, const double* y, double* out, std::size_t n) const override {
+        double u[256];
+        double v[256];
+        for (std::size_t i0 = 0; i0 < n; i0 += 256) {
+            const std::size_t m = std::min<std::size_t>(256, n - i0);
+            std::fill(out + i0, out + i0 + m, 0.0);
+            for (const Term& t : terms_) {
+                t.x->evaluate(x + i0, u, m);
+                t.y->evaluate(y + i0, v, m);
+                for (std::size_t k = 0; k < m; ++k) {
+                    out[i0 + k] += u[k] * v[k];
+                }
+            }
+        }
+    }
+
+private:
+    std::vector<Term> terms_;
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include "TensorProductND.h"
+#include <cstddef>
+#include <string>
+
+// Tensor-product Simpson rule on a D-dimensional box, the N-D form of Simpson2DSolver
+template <std::size_t D>
+class SimpsonNDSolver : public TensorProductNDSolver<D> {
+public:
+    using typename TensorProductNDSolver<D>::Sizes;
+
+    // n = intervals per dimension, must be even for Simpson's rule (0 becomes 2, odd values are rounded up)
+    // threads = number of worker threads, 0 means std::thread::hardware_concurrency()
+    explicit SimpsonNDSolver(const Sizes& n, unsigned threads = 0)
+        : TensorProductNDSolver<D>(threads),
+          n_(this->fixed(n, [](std::size_t v) { return v == 0 ? std::size_t(2) : (v % 2 == 0) ? v : v + 1; })) {}
+
+    // the same number of intervals n in every dimension
+    explicit SimpsonNDSolver(std::size_t n = 20, unsigned threads = 0)
+        : SimpsonNDSolver(filled(n), threads) {}
+
+    // rule and parameters, see SolverND::configuration
+    std::string configuration() const override {
+        return "SimpsonND<" + std::to_string(D) + ">(n=" + this->join(n_) + ")";
+    }
+
+protected:
+    TensorRule1D rule(std::size_t d, double lo, double hi) const override {
+        return simpson_rule(lo, hi, n_[d]);
+    }
+
+private:
+    static Sizes filled(std::size_t n) {
+        Sizes s;
+        s.fill(n);
+        return s;
+    }
+
+    Sizes n_;
+};
@@ -1,6 +1,9 @@
 #pragma once
 #include "Function.h"
 #include <stdexcept>
+#include <cstddef>
+#include <string>
+#include <vector>
 
 // Abstract base class for numerical integrators
 class Solver {
@@ -13,9 +16,41 @@ public:
     // const -> method does not change the solver object
     // = 0 makes the Solver class abstract
     virtual double integrate(const Function& f, double a, double b) const = 0;
+
+    // Integrate every function of fs on the same interval [a,b], result[q] belongs to fs[q].
+    // The default calls integrate once per function; the fixed-grid solvers override it and
+    // generate each block of nodes (and weights) once, evaluating all integrands on it in one sweep.
+    // The results are bit-identical to separate integrate calls.
+    virtual std::vector<double> integrate_many(const std::vector<const Function*>& fs, double a, double b) const {
+        std::vector<double> result;
+        result.reserve(fs.size());
+        for (const Function* f : fs) {
+            result.push_back(integrate(*f, a, b));
+        }
+        return result;
+    }
+
+    // Describes the rule and every parameter that influences the result, e.g. "Trapezoid(n=1000)".
+    // Two solvers with the same configuration return the same value for the same integrand and interval,
+    // CachedSolver uses it as part of its key. The thread count is not part of it (results do not depend on it).
+    // An empty string (the default) means the result is not reproducible and must not be cached.
+    virtual std::string configuration() const { return std::string(); }
+
+    // True for the sampling (Monte Carlo type) solvers, whose integrand evaluations are random or
+    // quasi-random samples. InstrumentedSolver reports their evaluations as the sample count.
+    virtual bool sampling() const { return false; }
+
     virtual ~Solver() = default;
 
 protected:
+    // number of nodes generated and handed to Function::evaluate at once
+    // 256 doubles per buffer keeps the node and value blocks in L1 cache
+    static constexpr std::size_t block_size = 256;
+
+    // number of nodes per work item of the multithreaded solvers
+    // fixed (independent of the thread count) so the summation order and the result are too
+    static constexpr std::size_t chunk_size = 64 * block_size;
+
     // Optional helper: validate interval
     // just a method to check if a given interval is valid, i.e. a<b
     // the method is static, meaning it is a class method not a method of an object
@@ -1,6 +1,9 @@
 #pragma once
 #include "Function2D.h"
 #include <stdexcept>
+#include <cstddef>
+#include <string>
+#include <vector>
 
 // Abstract base class for 2D numerical integrators
 // This is the 2D equivalent of your Solver.h
@@ -18,9 +21,38 @@ public:
     virtual double integrate(const Function2D& f, 
                             double a, double b,
                             double c, double d) const = 0;
+
+    // Integrate every function of fs on the same rectangle, result[q] belongs to fs[q].
+    // The default calls integrate once per function; the tensor-product solvers override it
+    // and evaluate all integrands on each block of points in one sweep (bit-identical results).
+    virtual std::vector<double> integrate_many(const std::vector<const Function2D*>& fs,
+                                               double a, double b,
+                                               double c, double d) const {
+        std::vector<double> result;
+        result.reserve(fs.size());
+        for (const Function2D* f : fs) {
+            result.push_back(integrate(*f, a, b, c, d));
+        }
+        return result;
+    }
+
+    // Describes the rule and every parameter that influences the result, e.g. "Trapezoid2D(nx=100,ny=100)".
+    // Used by CachedSolver2D as part of its key, an empty string (the default) means "do not cache".
+    virtual std::string configuration() const { return std::string(); }
+
+    // True for the sampling solvers (Monte Carlo, quasi-Monte Carlo), see Solver::sampling
+    virtual bool sampling() const { return false; }
+
     virtual ~Solver2D() = default;
 
 protected:
+    // number of points generated and handed to Function2D::evaluate at once
+    static constexpr std::size_t block_size = 256;
+
+    // number of points per work item of the multithreaded solvers
+    // fixed (independent of the thread count) so the summation order and the result are too
+    static constexpr std::size_t chunk_size = 64 * block_size;
+
     // Helper: validate intervals
     // static function makes it a class method
     // just a method to check if the intervals are valid
@@ -0,0 +1,51 @@
+#pragma once
+#include "FunctionND.h"
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+// Abstract base class for integrators over a D-dimensional box, D fixed at compile time
+// This is the N-D equivalent of Solver.h and Solver2D.h
+
+template <std::size_t D>
+class SolverND {
+public:
+    using Point = typename FunctionND<D>::Point;
+
+    // Integrate f over the box [lower[0], upper[0]] x ... x [lower[D-1], upper[D-1]]
+    virtual double integrate(const FunctionND<D>& f, const Point& lower, const Point& upper) const = 0;
+
+    // Describes the rule and every parameter that influences the result, e.g. "TrapezoidND<3>(n=20x20x20)".
+    // An empty string (the default) means "do not cache", as for Solver::configuration.
+    virtual std::string configuration() const { return std::string(); }
+
+    virtual ~SolverND() = default;
+
+protected:
+    // number of points generated and handed to FunctionND::evaluate at once
+    static constexpr std::size_t block_size = 256;
+
+    // number of points per work item of the Monte Carlo solvers
+    // fixed (independent of the thread count) so the summation order and the result are too
+    static constexpr std::size_t chunk_size = 64 * block_size;
+
+    // Helper: validate the box, lower[d] < upper[d] in every dimension
+    static void validate_box(const Point& lower, const Point& upper) {
+        for (std::size_t d = 0; d < D; ++d) {
+            if (!(lower[d] < upper[d])) {
+                throw std::invalid_argument("Invalid interval in dimension " + std::to_string(d)
+                                            + ": require lower < upper");
+            }
+        }
+    }
+
+    // volume of the box
+    static double volume(const Point& lower, const Point& upper) {
+        double v = 1.0;
+        for (std::size_t d = 0; d < D; ++d) {
+            v *= upper[d] - lower[d];
+        }
+        return v;
+    }
+};
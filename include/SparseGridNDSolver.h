@@ -0,0 +1,264 @@
+#pragma once
+#include "SolverND.h"
+#include "ClenshawCurtisRule.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+Dimension-adaptive Smolyak sparse-grid integrator on a D-dimensional box
+(Gerstner & Griebel, "Dimension-adaptive tensor-product quadrature", 2003).
+
+With the nested Clenshaw-Curtis rules Q_l of ClenshawCurtisRule.h and their differences
+Δ_l = Q_l - Q_(l-1), the integral is approximated by a sum of tensor-product difference rules
+    ∫ f ≈ Σ_(k in I) (Δ_k1 ⊗ ... ⊗ Δ_kD) f
+over a downward closed set I of level multi-indices. The classical Smolyak grid takes all k with
+|k|_1 <= level + D - 1, which needs O(2^level level^(D-1)) points instead of the 2^(level D)
+of the full tensor grid. The adaptive version grows I one index at a time: the active index with
+the largest contribution |Δ_k f| is refined by adding its forward neighbours k + e_d whose backward
+neighbours are all refined already. The sum of |Δ_k f| over the active indices is the error
+estimate; the loop stops when it meets max(abs_tol, rel_tol * |value|) or the budget is used up.
+Directions in which f is simple (low degree, weak dependence) stay at low levels.
+
+Points are named by their positions on the finest Clenshaw-Curtis grid, every value of f is kept
+in a hash table: the points shared by different multi-indices (the nested levels and all their
+products) are evaluated once. The new points of a multi-index are handed to FunctionND::evaluate
+in blocks of block_size.
+*/
+template <std::size_t D>
+class SparseGridNDSolver : public SolverND<D> {
+public:
+    using typename SolverND<D>::Point;
+
+    // result of one adaptive integration
+    struct Result {
+        double value;             // approximate integral
+        double error;             // estimated absolute error, Σ |Δ_k f| over the active indices
+        std::size_t evaluations;  // number of distinct points evaluated
+        std::size_t indices;      // number of multi-indices in the sum
+        bool converged;           // false if the budget ran out before the tolerance was met
+    };
+
+    // abs_tol / rel_tol = requested absolute / relative accuracy
+    // max_evaluations = evaluation budget (checked before every refinement step)
+    // max_level = highest Clenshaw-Curtis level per dimension, clamped to [1, 12] (2^(level-1) + 1 nodes)
+    explicit SparseGridNDSolver(double abs_tol = 1e-10, double rel_tol = 1e-10,
+                                std::size_t max_evaluations = 100000,
+                                std::size_t max_level = clenshaw_curtis_max_level)
+        : abs_tol_(abs_tol), rel_tol_(rel_tol), max_evaluations_(max_evaluations),
+          max_level_(std::min(std::max<std::size_t>(max_level, 1), clenshaw_curtis_max_level)) {}
+
+    // integrate method from the SolverND class, returns only the value
+    double integrate(const FunctionND<D>& f, const Point& lower, const Point& upper) const override {
+        return integrate_sparse(f, lower, upper).value;
+    }
+
+    // same integration, also reports error estimate and cost
+    Result integrate_sparse(const FunctionND<D>& f, const Point& lower, const Point& upper) const {
+        this->validate_box(lower, upper);
+        Grid grid(f, lower, upper);
+
+        struct Active {
+            Index k;
+            double delta;
+        };
+        std::vector<Active> active;
+        std::set<Index> refined;
+        std::set<Index> known;
+
+        Index first;
+        first.fill(1);
+        Result result{grid.contribution(first), 0.0, 0, 1, false};
+        active.push_back({first, result.value});
+        known.insert(first);
+
+        while (true) {
+            result.error = 0.0;
+            for (const Active& a : active) {
+                result.error += std::abs(a.delta);
+            }
+            // the first index alone says little (a single point), refine it at least once
+            if (!refined.empty() && result.error <= std::max(abs_tol_, rel_tol_ * std::abs(result.value))) {
+                result.converged = true;
+                break;
+            }
+            if (active.empty() || grid.evaluations() >= max_evaluations_) break;
+
+            const auto largest = std::max_element(active.begin(), active.end(), [](const Active& x, const Active& y) {
+                return std::abs(x.delta) < std::abs(y.delta);
+            });
+            const Index k = largest->k;
+            active.erase(largest);
+            refined.insert(k);
+
+            for (std::size_t d = 0; d < D; ++d) {
+                if (k[d] >= max_level_) continue;
+                Index next = k;
+                ++next[d];
+                if (known.count(next)) continue;
+                // admissible: every backward neighbour of next is refined
+                bool admissible = true;
+                for (std::size_t j = 0; j < D && admissible; ++j) {
+                    if (next[j] == 1) continue;
+                    Index back = next;
+                    --back[j];
+                    admissible = refined.count(back) > 0;
+                }
+                if (!admissible) continue;
+                const double delta = grid.contribution(next);
+                result.value += delta;
+                active.push_back({next, delta});
+                known.insert(next);
+                ++result.indices;
+            }
+        }
+        result.evaluations = grid.evaluations();
+        return result;
+    }
+
+    // rule and parameters, see SolverND::configuration
+    std::string configuration() const override {
+        std::ostringstream out;
+        out << std::setprecision(17) << "SparseGridND<" << D << ">(abs_tol=" << abs_tol_ << ",rel_tol=" << rel_tol_
+            << ",max_evaluations=" << max_evaluations_ << ",max_level=" << max_level_ << ")";
+        return out.str();
+    }
+
+private:
+    // Clenshaw-Curtis level per dimension
+    using Index = std::array<std::size_t, D>;
+    // node positions on the finest grid, the name of a point
+    using Key = std::array<std::uint32_t, D>;
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const {
+            std::uint64_t h = 1469598103934665603ull;  // FNV-1a over the positions
+            for (std::uint32_t v : key) {
+                h = (h ^ v) * 1099511628211ull;
+            }
+            return static_cast<std::size_t>(h);
+        }
+    };
+
+    // the integrand on the box and every value computed so far
+    class Grid {
+    public:
+        Grid(const FunctionND<D>& f, const Point& lower, const Point& upper) : f_(f), lower_(lower), scale_(1.0) {
+            for (std::size_t d = 0; d < D; ++d) {
+                half_[d] = 0.5 * (upper[d] - lower[d]);
+                scale_ *= half_[d];
+            }
+        }
+
+        std::size_t evaluations() const { return values_.size(); }
+
+        // (Δ_k1 ⊗ ... ⊗ Δ_kD) f on the box
+        double contribution(const Index& k) {
+            std::array<ClenshawCurtisRule, D> rules;
+            std::size_t total = 1;
+            for (std::size_t d = 0; d < D; ++d) {
+                rules[d] = clenshaw_curtis_rule(k[d]);
+                total *= rules[d].size;
+            }
+
+            // f on the tensor grid of k (last dimension fastest), known values from the table
+            point_values_.resize(total);
+            missing_.clear();
+            std::array<std::size_t, D> j{};
+            for (std::size_t p = 0; p < total; ++p) {
+                const auto it = values_.find(key(rules, j));
+                if (it != values_.end()) {
+                    point_values_[p] = it->second;
+                } else {
+                    missing_.push_back(p);
+                }
+                next(rules, j);
+            }
+            evaluate_missing(rules);
+
+            double sum = 0.0;
+            j.fill(0);
+            for (std::size_t p = 0; p < total; ++p) {
+                double w = 1.0;
+                for (std::size_t d = 0; d < D; ++d) {
+                    w *= rules[d].differences[j[d]];
+                }
+                sum += w * point_values_[p];
+                next(rules, j);
+            }
+            return scale_ * sum;
+        }
+
+    private:
+        static constexpr std::size_t block = SolverND<D>::block_size;
+
+        static Key key(const std::array<ClenshawCurtisRule, D>& rules, const std::array<std::size_t, D>& j) {
+            Key key;
+            for (std::size_t d = 0; d < D; ++d) {
+                key[d] = rules[d].positions[j[d]];
+            }
+            return key;
+        }
+
+        // odometer step, last dimension fastest
+        static void next(const std::array<ClenshawCurtisRule, D>& rules, std::array<std::size_t, D>& j) {
+            for (std::size_t d = D; d-- > 0;) {
+                if (++j[d] < rules[d].size) return;
+                j[d] = 0;
+            }
+        }
+
+        // evaluate the points listed in missing_ in blocks, store them in point_values_ and the table
+        void evaluate_missing(const std::array<ClenshawCurtisRule, D>& rules) {
+            double xs[D][block];
+            double fx[block];
+            typename FunctionND<D>::Coordinates x;
+            for (std::size_t d = 0; d < D; ++d) {
+                x[d] = xs[d];
+            }
+            for (std::size_t i0 = 0; i0 < missing_.size(); i0 += block) {
+                const std::size_t m = std::min(block, missing_.size() - i0);
+                for (std::size_t i = 0; i < m; ++i) {
+                    std::size_t p = missing_[i0 + i];
+                    for (std::size_t d = D; d-- > 0;) {
+                        const std::size_t jd = p % rules[d].size;
+                        p /= rules[d].size;
+                        xs[d][i] = lower_[d] + half_[d] * (1.0 + rules[d].nodes[jd]);
+                    }
+                }
+                f_.evaluate(x, fx, m);
+                for (std::size_t i = 0; i < m; ++i) {
+                    std::size_t p = missing_[i0 + i];
+                    point_values_[p] = fx[i];
+                    std::array<std::size_t, D> j;
+                    for (std::size_t d = D; d-- > 0;) {
+                        j[d] = p % rules[d].size;
+                        p /= rules[d].size;
+                    }
+                    values_.emplace(key(rules, j), fx[i]);
+                }
+            }
+        }
+
+        const FunctionND<D>& f_;
+        Point lower_;
+        Point half_;
+        double scale_;
+        std::unordered_map<Key, double, KeyHash> values_;
+        std::vector<double> point_values_;
+        std::vector<std::size_t> missing_;
+    };
+
+    double abs_tol_;
+    double rel_tol_;
+    std::size_t max_evaluations_;
+    std::size_t max_level_;
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include "Solver.h"
+#include "ParallelSum.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Stratified Monte Carlo integrator: [a,b] is split into k equal strata and every stratum
+// receives the same share of the n uniform samples. The estimate is the sum of the stratum
+// estimates, its variance only contains the variance of f within each stratum, which removes
+// the large contribution of the overall variation of f (e.g. near the singularities of F3 / F4).
+// Every sample position comes from the Philox counter (seed, sample index) and the strata are
+// summed in order, so the result for a given seed does not depend on the thread count.
+class StratifiedMonteCarloSolver : public Solver {
+public:
+    // result of one integration
+    struct Result {
+        double value;         // Σ_j (stratum width) * mean of f in stratum j
+        double error;         // standard error from the variances inside the strata
+        std::size_t samples;  // number of samples used (n)
+        std::size_t strata;   // number of strata used
+    };
+
+    // n = number of samples (at least 2)
+    // strata = number of strata k, clamped to [1, n/2] so every stratum gets two samples
+    // seed = 0 means "random seed" (non-deterministic)
+    // threads = worker threads, 0 means std::thread::hardware_concurrency()
+    // explicit prevents implicit creation
+    explicit StratifiedMonteCarloSolver(std::size_t n = 10000, std::size_t strata = 100,
+                                        std::uint64_t seed = 0, unsigned threads = 0);
+
+    // integrate method from the Solver class, returns only the value
+    double integrate(const Function& f, double a, double b) const override;
+
+    // same integration, also reports the error estimate
+    Result integrate_stratified(const Function& f, double a, double b) const;
+
+    // rule and parameters, see Solver::configuration
+    std::string configuration() const override;
+
+    // every evaluation is a sample, see Solver::sampling
+    bool sampling() const override { return true; }
+
+private:
+    std::size_t n_;
+    std::size_t strata_;
+    std::uint64_t seed_;
+    unsigned threads_;
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include "Solver.h"
+#include <cstddef>
+#include <string>
+
+// Tanh-sinh (double exponential) integrator.
+// The substitution x = c + h*tanh((pi/2) sinh t) maps [a,b] to the whole real t-axis and makes
+// the transformed integrand decay double exponentially, so the trapezoid rule in t converges
+// exponentially even for integrable endpoint singularities (x^(-1/2), log(x) on [0,1]).
+// The endpoints themselves are never evaluated. Every level halves the step in t and only
+// evaluates the new odd nodes; it stops when two successive levels agree to the tolerance.
+class TanhSinhSolver : public Solver {
+public:
+    // result of one tanh-sinh integration
+    struct Result {
+        double value;             // approximate integral
+        double error;             // |I(k) - I(k-1)| of the last two levels
+        std::size_t evaluations;  // number of integrand evaluations
+        std::size_t levels;       // number of step halvings
+        bool converged;           // false if max_levels was reached before the tolerance
+    };
+
+    // abs_tol / rel_tol = requested absolute / relative agreement of two successive levels
+    // max_levels = maximal number of step halvings
+    // explicit prevents implicit creation
+    explicit TanhSinhSolver(double abs_tol = 1e-10, double rel_tol = 1e-10, std::size_t max_levels = 10)
+        : abs_tol_(abs_tol), rel_tol_(rel_tol), max_levels_(max_levels ? max_levels : 1) {}
+
+    // integrate method from the Solver class, returns only the value
+    double integrate(const Function& f, double a, double b) const override;
+
+    // rule and parameters, see Solver::configuration
+    std::string configuration() const override;
+
+    // same integration, also reports the convergence information
+    Result integrate_tanh_sinh(const Function& f, double a, double b) const;
+
+private:
+    double abs_tol_;
+    double rel_tol_;
+    std::size_t max_levels_;
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include "Accumulator.h"
+#include "Function2D.h"
+#include <cstddef>
+#include <vector>
+
+/*
+Shared kernel of the tensor-product 2D solvers (Trapezoid2D, Simpson2D, Weddle2D, Gauss-Legendre 2D).
+
+A tensor-product rule is fully described by its 1D nodes and weights in each direction:
+    ∫∫ f ≈ Σ_i wx_i Σ_j wy_j f(x_i, y_j)
+The solvers only build these four vectors once, the kernel walks the grid in tiles of
+tile_rows x rows and tile_columns y nodes: a tile column of y nodes and weights stays in L1 cache
+while it is reused for every row of the tile. Tile rows are the work items of parallel_sum,
+the row sums are formed in the same order for every thread count, so the result is bit-identical.
+
+Integrands derived from SeparableFunction2D skip the grid: each term u(x) v(y) is the product of
+the two 1D rule sums Σ_i wx_i u(x_i) and Σ_j wy_j v(y_j), which costs nx + ny evaluations.
+*/
+
+// 1D rule of a tensor-product solver on [lo, hi]: scale * Σ_i weights[i] f(nodes[i]) ≈ ∫ f.
+// The same rules serve the 2D solvers and the N-D solvers of TensorProductND.h.
+struct TensorRule1D {
+    std::vector<double> nodes;
+    std::vector<double> weights;
+    double scale;
+};
+
+// n intervals of width h, weights 1, 2, ..., 2, 1, scale h / 2
+TensorRule1D trapezoid_rule(double lo, double hi, std::size_t n);
+
+// n intervals of width h (n even), weights 1, 4, 2, 4, ..., 2, 4, 1, scale h / 3
+TensorRule1D simpson_rule(double lo, double hi, std::size_t n);
+
+// nodes {lo, midpoints of the n intervals, hi}, weights 1, 2, ..., 2, 1, scale h / 2 (Weddle2D point set)
+TensorRule1D weddle_rule(double lo, double hi, std::size_t n);
+
+// composite Gauss-Legendre rule of the given order on `panels` equal panels, weights already scaled, scale 1
+TensorRule1D gauss_legendre_composite_rule(std::size_t order, std::size_t panels, double lo, double hi);
+
+// Rules on given, strictly increasing nodes (at least 2, e.g. of tabulated samples), weights already scaled,
+// scale 1. Trapezoid: each node gets half of the intervals next to it.
+TensorRule1D trapezoid_rule(const std::vector<double>& nodes);
+
+// Simpson on given nodes: every pair of intervals (h0, h1) integrates the parabola through its three
+// nodes, weights (h0+h1)/6 * {2 - h1/h0, (h0+h1)^2/(h0 h1), 2 - h0/h1}; an odd last interval adds
+// the integral of the parabola through the last three nodes over it (weights 5h/12, 8h/12, -h/12 for
+// equal spacing). A single interval falls back to the trapezoid rule.
+TensorRule1D simpson_rule(const std::vector<double>& nodes);
+
+// x rows per work item and y nodes per evaluate call
+constexpr std::size_t tensor_tile_rows = 16;
+constexpr std::size_t tensor_tile_columns = 256;
+
+// Σ_i x_weights[i] Σ_j y_weights[j] f(x_nodes[i], y_nodes[j]) for every f in fs (result[q] belongs to fs[q]),
+// computed on up to `threads` threads (0 = hardware concurrency) with the given accumulation policy
+std::vector<double> tensor_product_sum(const std::vector<const Function2D*>& fs,
+                                       const std::vector<double>& x_nodes, const std::vector<double>& x_weights,
+                                       const std::vector<double>& y_nodes, const std::vector<double>& y_weights,
+                                       unsigned threads, Summation summation = Summation::Pairwise);
+
+// Σ_i x_weights[i] Σ_j y_weights[j] values[i * ny + j] for a grid of samples (ny = y_weights.size()),
+// the same tiles, work items and summation order as the grid of tensor_product_sum: samples of f at
+// the solver's nodes give the solver's result bit for bit. The rows are read in place.
+double tensor_product_sum(const double* values, const std::vector<double>& x_weights,
+                          const std::vector<double>& y_weights, unsigned threads,
+                          Summation summation = Summation::Pairwise);
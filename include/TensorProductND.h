@@ -0,0 +1,134 @@
+#pragma once
+#include "SolverND.h"
+#include "Accumulator.h"
+#include "ParallelSum.h"
+#include "TensorProduct.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string>
+
+/*
+Shared kernel and base class of the tensor-product N-D solvers (TrapezoidND, SimpsonND, WeddleND,
+Gauss-Legendre ND), the D-dimensional counterpart of TensorProduct.h:
+    ∫ f ≈ s_0 ... s_(D-1) Σ_i0 w0_i0 Σ_i1 w1_i1 ... Σ_i(D-1) w(D-1)_i(D-1) f(x0_i0, ..., x(D-1)_i(D-1))
+with the 1D rules of TensorProduct.h (the same node and weight vectors the 2D solvers use).
+
+The loop nest is generated per dimension by template recursion (TensorSweepND::sum<K>), so the
+compiler sees D fixed loops instead of an index odometer. The innermost dimension is handed to
+FunctionND::evaluate in blocks that point straight into its node vector; the outer coordinates
+are constant over a block and sit in per-work-item stack arrays that are refilled only when
+their index changes. Nothing is allocated per point.
+
+All sums use the default (Pairwise) Accumulator. Work items of parallel_sum are single indices
+of the outermost dimension (for D = 1, fixed chunks of nodes), the summation order is the same
+for every thread count, so the result is bit-identical.
+*/
+
+namespace tensor_nd_detail {
+
+constexpr std::size_t block_size = 256;
+
+// one work item's state: outer coordinates and the block of function values
+template <std::size_t D>
+struct TensorSweepND {
+    const FunctionND<D>& f;
+    const std::array<TensorRule1D, D>& rules;
+    std::size_t fill;                                  // entries of the outer arrays that are used
+    double outer[D > 1 ? D - 1 : 1][block_size];       // outer[k][*] = current node of dimension k
+    double values[block_size];
+    typename FunctionND<D>::Coordinates x;
+
+    TensorSweepND(const FunctionND<D>& function, const std::array<TensorRule1D, D>& r)
+        : f(function), rules(r), fill(std::min(block_size, r[D - 1].nodes.size())) {
+        for (std::size_t k = 0; k + 1 < D; ++k) {
+            x[k] = outer[k];
+        }
+    }
+
+    // Σ over the node ranges of dimension K (innermost: [begin, end)) of weight * inner sum
+    template <std::size_t K>
+    double sum(std::size_t begin, std::size_t end) {
+        const TensorRule1D& rule = rules[K];
+        Accumulator s;
+        if constexpr (K + 1 == D) {
+            for (std::size_t j0 = begin; j0 < end; j0 += block_size) {
+                const std::size_t m = std::min(block_size, end - j0);
+                x[K] = rule.nodes.data() + j0;
+                f.evaluate(x, values, m);
+                s.add_products(rule.weights.data() + j0, values, m);
+            }
+        } else {
+            for (std::size_t i = begin; i < end; ++i) {
+                std::fill(outer[K], outer[K] + fill, rule.nodes[i]);
+                s.add(rule.weights[i] * sum<K + 1>(0, rules[K + 1].nodes.size()));
+            }
+        }
+        return s.sum();
+    }
+};
+
+}
+
+// Σ over the full tensor grid of the product weights times f, without the scale factors
+template <std::size_t D>
+double tensor_product_sum_nd(const FunctionND<D>& f, const std::array<TensorRule1D, D>& rules,
+                             unsigned threads) {
+    using tensor_nd_detail::TensorSweepND;
+    // one outer index per work item, for D = 1 the single dimension is split into node chunks
+    const std::size_t chunk = (D == 1) ? 64 * tensor_nd_detail::block_size : 1;
+    return parallel_sum(rules[0].nodes.size(), chunk, threads, [&](std::size_t begin, std::size_t end) {
+        TensorSweepND<D> sweep(f, rules);
+        return sweep.template sum<0>(begin, end);
+    });
+}
+
+template <std::size_t D>
+class TensorProductNDSolver : public SolverND<D> {
+public:
+    using typename SolverND<D>::Point;
+    using Sizes = std::array<std::size_t, D>;
+
+    double integrate(const FunctionND<D>& f, const Point& lower, const Point& upper) const override {
+        this->validate_box(lower, upper);
+        std::array<TensorRule1D, D> rules;
+        double scale = 1.0;
+        for (std::size_t d = 0; d < D; ++d) {
+            rules[d] = rule(d, lower[d], upper[d]);
+            scale *= rules[d].scale;
+        }
+        return scale * tensor_product_sum_nd(f, rules, threads_);
+    }
+
+    // number of worker threads used by integrate
+    // the result is bit-identical for every thread count
+    unsigned threads() const { return threads_; }
+
+protected:
+    // threads = number of worker threads, 0 means std::thread::hardware_concurrency()
+    explicit TensorProductNDSolver(unsigned threads) : threads_(resolve_threads(threads)) {}
+
+    // 1D rule of dimension d on [lo, hi]
+    virtual TensorRule1D rule(std::size_t d, double lo, double hi) const = 0;
+
+    // "n0xn1x...", used by the configuration strings
+    static std::string join(const Sizes& n) {
+        std::string s = std::to_string(n[0]);
+        for (std::size_t d = 1; d < D; ++d) {
+            s += "x" + std::to_string(n[d]);
+        }
+        return s;
+    }
+
+    // every entry of n replaced by fix(n[d])
+    template <typename Fix>
+    static Sizes fixed(Sizes n, Fix fix) {
+        for (std::size_t& v : n) {
+            v = fix(v);
+        }
+        return n;
+    }
+
+private:
+    unsigned threads_;
+};
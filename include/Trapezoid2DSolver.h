@@ -1,21 +1,42 @@
 #pragma once
 #include "Solver2D.h"
+#include "Accumulator.h"
+#include "ParallelSum.h"
 #include <cstddef>
+#include <string>
+#include <vector>
 
 class Trapezoid2DSolver : public Solver2D {
 public:
     // constructor with explicit argument to prevent implicit creation
     // nx = intervals in x direction, ny = intervals in y direction
-    explicit Trapezoid2DSolver(std::size_t nx = 100, std::size_t ny = 100) 
-        : nx_(nx ? nx : 1), ny_(ny ? ny : 1) {}
+    // threads = number of worker threads, 0 means std::thread::hardware_concurrency()
+    // summation = accumulation policy of the grid sums, see Accumulator.h
+    explicit Trapezoid2DSolver(std::size_t nx = 100, std::size_t ny = 100, unsigned threads = 0,
+                              Summation summation = Summation::Pairwise)
+        : nx_(nx ? nx : 1), ny_(ny ? ny : 1), threads_(resolve_threads(threads)), summation_(summation) {}
     
     // integrate method to be overridden
     double integrate(const Function2D& f, 
                     double a, double b,
                     double c, double d) const override;
 
+    // all integrands in one sweep over the grid, see Solver2D::integrate_many
+    std::vector<double> integrate_many(const std::vector<const Function2D*>& fs,
+                                       double a, double b,
+                                       double c, double d) const override;
+
+    // rule and parameters, see Solver2D::configuration
+    std::string configuration() const override;
+
+    // number of worker threads used by integrate
+    // the result is bit-identical for every thread count
+    unsigned threads() const { return threads_; }
+
 private:
     // private attributes
     std::size_t nx_;
     std::size_t ny_;
+    unsigned threads_;
+    Summation summation_;
 };
\ No newline at end of file
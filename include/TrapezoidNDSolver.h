@@ -0,0 +1,40 @@
+#pragma once
+#include "TensorProductND.h"
+#include <cstddef>
+#include <string>
+
+// Tensor-product trapezoidal rule on a D-dimensional box, the N-D form of Trapezoid2DSolver
+template <std::size_t D>
+class TrapezoidNDSolver : public TensorProductNDSolver<D> {
+public:
+    using typename TensorProductNDSolver<D>::Sizes;
+
+    // n = intervals per dimension (0 falls back to 1)
+    // threads = number of worker threads, 0 means std::thread::hardware_concurrency()
+    explicit TrapezoidNDSolver(const Sizes& n, unsigned threads = 0)
+        : TensorProductNDSolver<D>(threads),
+          n_(this->fixed(n, [](std::size_t v) { return v ? v : std::size_t(1); })) {}
+
+    // the same number of intervals n in every dimension
+    explicit TrapezoidNDSolver(std::size_t n = 20, unsigned threads = 0)
+        : TrapezoidNDSolver(filled(n), threads) {}
+
+    // rule and parameters, see SolverND::configuration
+    std::string configuration() const override {
+        return "TrapezoidND<" + std::to_string(D) + ">(n=" + this->join(n_) + ")";
+    }
+
+protected:
+    TensorRule1D rule(std::size_t d, double lo, double hi) const override {
+        return trapezoid_rule(lo, hi, n_[d]);
+    }
+
+private:
+    static Sizes filled(std::size_t n) {
+        Sizes s;
+        s.fill(n);
+        return s;
+    }
+
+    Sizes n_;
+};
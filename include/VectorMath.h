@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+
+/*
+Vectorized elementary functions used by the block evaluation of the built-in integrands.
+
+Every routine computes out[i] = f(x[i]) for i in [0, n). The arrays may alias (out == x is allowed).
+
+The kernels are compiled in one variant per instruction set: "avx512" (AVX-512F), "avx2", "sse2"
+and "scalar" on x86 with GCC / Clang ("sse2" and "scalar" with MSVC, "scalar" elsewhere), without
+any -m flag. The first call selects the best variant the CPU supports; the environment variable
+VMATH_ISA=avx512|avx2|sse2|scalar forces one (ignored if unknown or not supported by the CPU),
+set_isa switches at run time.
+
+Accuracy: cos/sin/exp/log stay within about 1 ulp of the correctly rounded result,
+rsqrt is 1/sqrt with two correctly rounded operations (same as the scalar expression).
+Lanes outside the fast domain of a kernel (huge arguments, non-positive log arguments,
+overflow / underflow of exp, NaN, inf) are handed to the std:: version, so special values
+behave exactly like <cmath>.
+
+Tolerance between the variants: 0 ulp. Every variant runs the same IEEE operations in the same
+order on every element (no FMA contraction, the vector width only changes how many elements
+share an instruction), so the results are bit for bit those of the scalar variant.
+*/
+
+namespace vmath {
+
+void cos(const double* x, double* out, std::size_t n);
+void sin(const double* x, double* out, std::size_t n);
+void exp(const double* x, double* out, std::size_t n);
+void log(const double* x, double* out, std::size_t n);
+// out[i] = 1 / sqrt(x[i])
+void rsqrt(const double* x, double* out, std::size_t n);
+
+// sum of x[0..n) / w[0..n) * x[0..n) in 8 interleaved lanes (lane l adds the terms l, l + 8, ...),
+// the lanes are combined as ((l0 + l1) + (l2 + l3)) + ((l4 + l5) + (l6 + l7)); the block sums of
+// the Pairwise summation policy (Accumulator.h)
+double sum(const double* x, std::size_t n);
+double dot(const double* w, const double* x, std::size_t n);
+
+// name of the variant in use: "avx512", "avx2", "sse2" or "scalar"
+const char* isa();
+
+// true if this build has the variant name and the CPU can run it
+bool isa_supported(const char* name);
+
+// switches all threads to the variant name (tests, benchmarks),
+// returns false and keeps the current variant if !isa_supported(name)
+bool set_isa(const char* name);
+
+}
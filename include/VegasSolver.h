@@ -0,0 +1,52 @@
+#pragma once
+#include "Solver.h"
+#include "ParallelSum.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// VEGAS-style adaptive Monte Carlo integrator (Lepage 1978) in 1D.
+// The sampling density is piecewise constant on a grid of `bins` intervals that all carry the same
+// probability. The n samples are split over `iterations` passes; after every pass the bins are
+// resized so that each one holds the same share of Σ (f·J)², i.e. the samples move to where |f| is
+// large (the singular end of F3 / F4). The pass estimates are combined with inverse-variance weights.
+// Sample i comes from the Philox counter (seed, i), the result does not depend on the thread count.
+class VegasSolver : public Solver {
+public:
+    // result of one integration
+    struct Result {
+        double value;            // inverse-variance weighted mean of the pass estimates
+        double error;            // standard error of value
+        double chi2_per_dof;     // consistency of the passes, should be around 1 (0 for a single pass)
+        std::size_t samples;     // number of samples used (n)
+        std::size_t iterations;  // number of passes
+    };
+
+    // n = total number of samples (at least 2 per pass)
+    // bins = number of grid intervals (falls back to 1 if 0)
+    // iterations = number of passes, the grid is refined between them (falls back to 1 if 0)
+    // seed = 0 means "random seed" (non-deterministic)
+    // threads = worker threads, 0 means std::thread::hardware_concurrency()
+    // explicit prevents implicit creation
+    explicit VegasSolver(std::size_t n = 200000, std::size_t bins = 100, std::size_t iterations = 10,
+                         std::uint64_t seed = 0, unsigned threads = 0);
+
+    // integrate method from the Solver class, returns only the value
+    double integrate(const Function& f, double a, double b) const override;
+
+    // same integration, also reports the error estimate and the pass consistency
+    Result integrate_vegas(const Function& f, double a, double b) const;
+
+    // rule and parameters, see Solver::configuration
+    std::string configuration() const override;
+
+    // every evaluation is a sample, see Solver::sampling
+    bool sampling() const override { return true; }
+
+private:
+    std::size_t n_;
+    std::size_t bins_;
+    std::size_t iterations_;
+    std::uint64_t seed_;
+    unsigned threads_;
+};
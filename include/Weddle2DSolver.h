@@ -1,21 +1,42 @@
 #pragma once
 #include "Solver2D.h"
+#include "Accumulator.h"
+#include "ParallelSum.h"
 #include <cstddef>
+#include <string>
+#include <vector>
 
 class Weddle2DSolver : public Solver2D {
 public:
     // constructor of the Weddle solver
     // explicit prevents implicit constrcution
     // nx and ny describe the number of discreatization points of the intervals
-    explicit Weddle2DSolver(std::size_t nx = 100, std::size_t ny = 100) 
-        : nx_(nx ? nx : 1), ny_(ny ? ny : 1) {}
+    // threads = number of worker threads, 0 means std::thread::hardware_concurrency()
+    // summation = accumulation policy of the grid sums, see Accumulator.h
+    explicit Weddle2DSolver(std::size_t nx = 100, std::size_t ny = 100, unsigned threads = 0,
+                            Summation summation = Summation::Pairwise)
+        : nx_(nx ? nx : 1), ny_(ny ? ny : 1), threads_(resolve_threads(threads)), summation_(summation) {}
     
     // integrate method to be oevrridden
     double integrate(const Function2D& f,
                     double a, double b,
                     double c, double d) const override;
 
+    // all integrands in one sweep over the grid, see Solver2D::integrate_many
+    std::vector<double> integrate_many(const std::vector<const Function2D*>& fs,
+                                       double a, double b,
+                                       double c, double d) const override;
+
+    // rule and parameters, see Solver2D::configuration
+    std::string configuration() const override;
+
+    // number of worker threads used by integrate
+    // the result is bit-identical for every thread count
+    unsigned threads() const { return threads_; }
+
 private:
     std::size_t nx_;
     std::size_t ny_;
+    unsigned threads_;
+    Summation summation_;
 };
@@ -1,18 +1,45 @@
 #pragma once
 #include "Solver.h"
+#include "IntegrationKernels.h"
+#include "ParallelSum.h"
 #include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 
 
 class WeddleSolver : public Solver {
 public:
     // constructor with explicit keyword to ensure no implicit creation
-    explicit WeddleSolver(std::size_t n = 1000) : n_(n ? n : 1) {}
+    // threads = number of worker threads, 0 means std::thread::hardware_concurrency()
+    // summation = accumulation policy of the node sums, see Accumulator.h
+    explicit WeddleSolver(std::size_t n = 1000, unsigned threads = 0, Summation summation = Summation::Pairwise)
+        : n_(n ? n : 1), threads_(resolve_threads(threads)), summation_(summation) {}
     // integrate method to be overridden
     double integrate(const Function& f, double a, double b) const override;
 
+    // any other callable double(double), e.g. a lambda: same rule with the call inlined,
+    // see IntegrationKernels.h
+    template <typename F, typename = std::enable_if_t<!std::is_base_of<Function, F>::value>>
+    double integrate(const F& f, double a, double b) const {
+        return kernels::weddle(f, a, b, n_, threads_, summation_);
+    }
+
+    // all integrands in one sweep over the nodes, see Solver::integrate_many
+    std::vector<double> integrate_many(const std::vector<const Function*>& fs, double a, double b) const override;
+
+    // rule and parameters, see Solver::configuration
+    std::string configuration() const override;
+
+    // number of worker threads used by integrate
+    // the result is bit-identical for every thread count
+    unsigned threads() const { return threads_; }
+
 private:
     std::size_t n_;  // number of subintervals
+    unsigned threads_;
+    Summation summation_;
 };
 
 
@@ -1,21 +1,37 @@
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <vector>
 #include <iomanip>
 #include <cmath>
+#include <chrono>
+#include <functional>
+#include <string>
 
 #include "FunctionsConcrete.h"
 #include "TrapezoidSolver.h"
 #include "SimpsonSolver.h"
 #include "WeddleSolver.h"
 #include "MonteCarloSolver.h"
+#include "AdaptiveGKSolver.h"
+#include "RombergSolver.h"
+#include "GaussLegendreSolver.h"
+#include "TanhSinhSolver.h"
+#include "QuasiMonteCarloSolver.h"
+#include "StratifiedMonteCarloSolver.h"
+#include "ImportanceMonteCarloSolver.h"
+#include "VegasSolver.h"
+#include "AutoSolver.h"
+#include "Expression.h"
 
 /*
 File to test the different solver algorithms against the four test functions.
 Here only the one dimensional case is evaluated.
+
+./integrate "expression in x" a b  integrates a run-time expression (Expression.h) with the solvers instead.
 */
 
-int main() {
+int main(int argc, char** argv) {
     // Create function objects
     F1 f1;
     F2 f2;
@@ -30,18 +46,44 @@ int main() {
     solvers.emplace_back(std::make_unique<SimpsonSolver>(100000));
     solvers.emplace_back(std::make_unique<WeddleSolver>(100000));
     solvers.emplace_back(std::make_unique<MonteCarloSolver>(1000000, 42));
+    solvers.emplace_back(std::make_unique<AdaptiveGKSolver>(1e-10, 1e-10));
+    solvers.emplace_back(std::make_unique<RombergSolver>(1e-10, 1e-10));
+    solvers.emplace_back(std::make_unique<GaussLegendreSolver>(16));
+    solvers.emplace_back(std::make_unique<TanhSinhSolver>(1e-10, 1e-10));
+    solvers.emplace_back(std::make_unique<QuasiMonteCarloSolver>(4096, 8, 42));
 
     // Names for printing
     const std::vector<std::string> solver_names = {
         "Trapezoid (n=100000)",
         "Simpson   (n=100000)",
         "Weddle      (n=100000)",
-        "Monte Carlo (n=1000000)"
+        "Monte Carlo (n=1000000)",
+        "Adaptive GK15 (tol=1e-10)",
+        "Romberg     (tol=1e-10)",
+        "Gauss-Legendre (order 16)",
+        "Tanh-sinh   (tol=1e-10)",
+        "Quasi-MC Sobol (8x4096)"
     };
 
     std::cout << std::setprecision(12);
 
-    
+    // user-supplied integrand, e.g. ./integrate "x^2*cos(x)" 0 1
+    if (argc == 4) {
+        try {
+            const ExpressionFunction f(argv[1]);
+            const double a = std::stod(argv[2]);
+            const double b = std::stod(argv[3]);
+            std::cout << std::fixed << "integral of " << argv[1] << " from " << a << " to " << b << "\n";
+            for (std::size_t i = 0; i < solvers.size(); ++i) {
+                std::cout << "  " << solver_names[i] << " -> " << solvers[i]->integrate(f, a, b) << "\n";
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "integrate: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
 
 //============================================
 
@@ -102,13 +144,15 @@ int main() {
     solvers_f3.emplace_back(std::make_unique<TrapezoidSolver>(300000));     // 100,000 intervals
     solvers_f3.emplace_back(std::make_unique<SimpsonSolver>(300000));       // 100,000 intervals
     solvers_f3.emplace_back(std::make_unique<WeddleSolver>(300000));      // 100,000 intervals
-    solvers_f3.emplace_back(std::make_unique<MonteCarloSolver>(2000000, 42));
+    solvers_f3.emplace_back(std::make_unique<MonteCarloSolver>(2000000, 42, MonteCarloSolver::Mode::Parallel));
+    solvers_f3.emplace_back(std::make_unique<AdaptiveGKSolver>(1e-10, 1e-10));
     
         const std::vector<std::string> solver_names_f3 = {
         "Trapezoid   (n=300000)",
         "Simpson     (n=300000)",
         "Weddle    (n=300000)",
-        "Monte Carlo (M=2000000)"
+        "Monte Carlo (M=2000000)",
+        "Adaptive GK15 (tol=1e-10)"
     };
     
     for (std::size_t i = 0; i < solvers_f3.size(); ++i) {
@@ -119,6 +163,15 @@ int main() {
                   << "  (error: " << std::scientific << error << std::fixed << ")\n";
     }
 
+    // the tanh-sinh rule never evaluates the endpoints, so it can integrate over the full interval [0,1]
+    {
+        const TanhSinhSolver tanh_sinh(1e-10, 1e-10);
+        const double result = tanh_sinh.integrate(f3, 0.0, 1.0);
+        const double error = std::abs(result - true_f3);
+        std::cout << "  Tanh-sinh on [0,1] (tol=1e-10) -> " << result
+                  << "  (error vs. " << true_f3 << ": " << std::scientific << error << std::fixed << ")\n";
+    }
+
     // epsilon value to approxiate interval [0,1] with [epsilon, 1]
     const double epsilon_f4 = 1e-6;
     // true integral value for this adjusted interval
@@ -135,13 +188,15 @@ int main() {
     solvers_f4.emplace_back(std::make_unique<TrapezoidSolver>(200000));
     solvers_f4.emplace_back(std::make_unique<SimpsonSolver>(200000));
     solvers_f4.emplace_back(std::make_unique<WeddleSolver>(200000));
-    solvers_f4.emplace_back(std::make_unique<MonteCarloSolver>(2000000, 42));
+    solvers_f4.emplace_back(std::make_unique<MonteCarloSolver>(2000000, 42, MonteCarloSolver::Mode::Parallel));
+    solvers_f4.emplace_back(std::make_unique<AdaptiveGKSolver>(1e-10, 1e-10));
     
      const std::vector<std::string> solver_names_f4 = {
         "Trapezoid   (n=200000)",
         "Simpson     (n=200000)",
         "Weddle    (n=200000)",
-        "Monte Carlo (M=2000000)"
+        "Monte Carlo (M=2000000)",
+        "Adaptive GK15 (tol=1e-10)"
     };
     
     for (std::size_t i = 0; i < solvers_f4.size(); ++i) {
@@ -152,6 +207,103 @@ int main() {
                   << "  (error: " << std::scientific << error << std::fixed << ")\n";
     }
 
+    // the tanh-sinh rule never evaluates the endpoints, so it can integrate over the full interval [0,1]
+    {
+        const TanhSinhSolver tanh_sinh(1e-10, 1e-10);
+        const double result = tanh_sinh.integrate(f4, 0.0, 1.0);
+        const double error = std::abs(result - true_f4);
+        std::cout << "  Tanh-sinh on [0,1] (tol=1e-10) -> " << result
+                  << "  (error vs. " << true_f4 << ": " << std::scientific << error << std::fixed << ")\n";
+    }
+
+    // variance-reduced Monte Carlo samples never hit x = 0 either, F3 and F4 on the full interval [0,1]
+    // with 10-100x fewer samples than the plain Monte Carlo runs above
+    std::cout << "\n============================================================\n";
+    std::cout << "VARIANCE-REDUCED MONTE CARLO: F3 and F4 on [0,1]\n";
+    std::cout << "============================================================\n";
+    {
+        std::vector<std::unique_ptr<Solver>> solvers_vr;
+        solvers_vr.emplace_back(std::make_unique<StratifiedMonteCarloSolver>(20000, 10000, 42));
+        solvers_vr.emplace_back(std::make_unique<ImportanceMonteCarloSolver>(20000, std::make_shared<PowerLawProposal>(0.5), 42));
+        solvers_vr.emplace_back(std::make_unique<VegasSolver>(200000, 100, 10, 42));
+        const std::vector<std::string> solver_names_vr = {
+            "Stratified MC (n=20000, k=10000)",
+            "Importance MC (n=20000, x^(-1/2))",
+            "VEGAS         (n=200000)"
+        };
+        for (std::size_t i = 0; i < solvers_vr.size(); ++i) {
+            const double r3 = solvers_vr[i]->integrate(f3, 0.0, 1.0);
+            const double r4 = solvers_vr[i]->integrate(f4, 0.0, 1.0);
+            std::cout << "  " << solver_names_vr[i] << " -> F3 error " << std::scientific << std::abs(r3 - true_f3)
+                      << ", F4 error " << std::abs(r4 - true_f4) << std::fixed << "\n";
+        }
+    }
+
+    // Instead of a hand-picked n per integrand: the auto-tuner pilots every rule on a few small
+    // nested grids, predicts the n each one needs for the tolerance and runs only the cheapest
+    std::cout << "\n============================================================\n";
+    std::cout << "AUTO-TUNED SOLVER: cheapest rule and n for tol=1e-8\n";
+    std::cout << "============================================================\n";
+    {
+        const AutoSolver auto_solver(1e-8, 1e-8, 100000000, 64, 42);
+        const std::vector<std::pair<std::string, std::pair<const Function*, std::pair<double, double>>>> cases = {
+            {"F1", {&f1, {0.0, true_f1}}},
+            {"F2", {&f2, {0.0, true_f2}}},
+            {"F3", {&f3, {epsilon_f3, true_f3_adjusted}}},
+            {"F4", {&f4, {epsilon_f4, true_f4_adjusted}}}
+        };
+        for (const auto& c : cases) {
+            const AutoSolver::Result r = auto_solver.integrate_auto(*c.second.first, c.second.second.first, 1.0);
+            std::cout << "  " << c.first << ": " << AutoSolver::rule_name(r.rule) << " n=" << r.n
+                      << " -> " << r.value << "  (error: " << std::scientific << std::abs(r.value - c.second.second.second)
+                      << ", estimated " << r.error << ", predicted " << r.predicted_error << std::fixed
+                      << ", " << r.evaluations << " evaluations)\n";
+        }
+    }
+
+    // The same trapezoid rule on F2 three ways: one virtual call per node (Function's default
+    // evaluate), one virtual call per block of 256 nodes (F2::evaluate), and a lambda handed to the
+    // templated kernel where the call is inlined into the block loop. All three give the same value.
+    std::cout << "\n============================================================\n";
+    std::cout << "INLINED VS VIRTUAL INTEGRAND: F2 = x^10, trapezoid n=10^7, 1 thread\n";
+    std::cout << "============================================================\n";
+    {
+        // F2 without the block override, every node is a virtual call
+        class PointwiseF2 : public Function {
+        public:
+            double operator()(double x) const override { return f2_(x); }
+        private:
+            F2 f2_;
+        };
+        const PointwiseF2 f2_pointwise;
+        const auto f2_inline = [](double x) {
+            const double x2 = x * x;
+            const double x4 = x2 * x2;
+            const double x8 = x4 * x4;
+            return x8 * x2;
+        };
+        const TrapezoidSolver trapezoid_bench(10000000, 1);
+
+        // best of 3 runs in ns per node
+        auto time = [](const std::function<double()>& run, double& value) {
+            double best = 1e300;
+            for (int r = 0; r < 3; ++r) {
+                const auto start = std::chrono::steady_clock::now();
+                value = run();
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                best = std::min(best, elapsed.count());
+            }
+            return best * 1e9 / 10000000.0;
+        };
+        double v_point = 0.0, v_block = 0.0, v_inline = 0.0;
+        const double t_point = time([&] { return trapezoid_bench.integrate(f2_pointwise, 0.0, 1.0); }, v_point);
+        const double t_block = time([&] { return trapezoid_bench.integrate(f2, 0.0, 1.0); }, v_block);
+        const double t_inline = time([&] { return trapezoid_bench.integrate(f2_inline, 0.0, 1.0); }, v_inline);
+        std::cout << "  virtual per node   -> " << v_point << "  (" << t_point << " ns/node)\n";
+        std::cout << "  virtual per block  -> " << v_block << "  (" << t_block << " ns/node)\n";
+        std::cout << "  inlined lambda     -> " << v_inline << "  (" << t_inline << " ns/node, x"
+                  << t_point / t_inline << " vs per node)\n";
+    }
 
     std::cout << "\n============================================================\n";
     std::cout << "SUMMARY\n";
@@ -161,6 +313,12 @@ int main() {
     std::cout << "  2. Simpson's Rule  - Composite Simpson's 1/3 rule, O(h^4)\n";
     std::cout << "  3. Weddle's Rule   - Endpoint + midpoint weighted sum, O(h^2)\n";
     std::cout << "  4. Monte Carlo     - Random sampling, O(n^(-0.5))\n";
+    std::cout << "  5. Adaptive GK15   - Gauss-Kronrod 7/15 with bisection of the worst subinterval\n";
+    std::cout << "  6. Romberg         - Nested trapezoid sequence + Richardson extrapolation\n";
+    std::cout << "  7. Gauss-Legendre  - Composite Gaussian quadrature, exact to degree 2*order-1\n";
+    std::cout << "  8. Tanh-sinh       - Double exponential substitution, handles endpoint singularities\n";
+    std::cout << "  9. Quasi-MC        - Scrambled Sobol / Halton points, close to O(n^(-1)) for smooth f\n";
+    std::cout << " 10. Stratified / importance / VEGAS Monte Carlo - variance reduction for peaked integrands\n";
     std::cout << "\nNote: Monte Carlo has higher variance but works well in higher dimensions.\n";
     std::cout << "Simpson's Rule typically gives the best accuracy for smooth functions.\n";
 
@@ -0,0 +1,201 @@
+#include "AutoSolver.h"
+#include "CountingFunction.h"
+#include "MonteCarloSolver.h"
+#include "ParallelSum.h"
+#include "SimpsonSolver.h"
+#include "TrapezoidSolver.h"
+#include "WeddleSolver.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+/*
+Implementation of the auto-tuning solver.
+*/
+
+namespace {
+
+// clamp of the observed order: below 0.5 the pilot is not in the asymptotic range yet
+// (or the integrand is singular), above 12 the differences are at rounding level
+constexpr double min_order = 0.5;
+constexpr double max_order = 12.0;
+
+// the final run aims at this fraction of the tolerance, the error model is only an estimate
+constexpr double safety = 0.5;
+
+// number of nested pilot grids n0, 2 n0, 4 n0, 8 n0
+constexpr std::size_t pilot_levels = 4;
+
+// a grid rule doubling up to N evaluates at most about 2 N points
+constexpr double grid_final_factor = 2.0;
+
+double grid_rule(AutoSolver::Rule rule, const Function& f, double a, double b, std::size_t n, unsigned threads) {
+    switch (rule) {
+        case AutoSolver::Rule::Trapezoid: return TrapezoidSolver(n, threads).integrate(f, a, b);
+        case AutoSolver::Rule::Simpson: return SimpsonSolver(n, threads).integrate(f, a, b);
+        default: return WeddleSolver(n, threads).integrate(f, a, b);
+    }
+}
+
+// n rounded up so that n and n/2 are valid for the rule (Simpson needs even subintervals)
+std::size_t round_grid(AutoSolver::Rule rule, double n) {
+    const std::size_t step = (rule == AutoSolver::Rule::Simpson) ? 4 : 2;
+    const std::size_t m = static_cast<std::size_t>(std::ceil(n / static_cast<double>(step)));
+    return std::max<std::size_t>(m, 1) * step;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+}
+
+AutoSolver::AutoSolver(double abs_tol, double rel_tol, std::size_t max_evaluations, std::size_t pilot_n,
+                       std::uint64_t seed, unsigned threads)
+    : abs_tol_(abs_tol), rel_tol_(rel_tol), max_evaluations_(max_evaluations ? max_evaluations : 1),
+      pilot_n_(std::max<std::size_t>(pilot_n, 8)), seed_(seed), threads_(resolve_threads(threads)) {}
+
+double AutoSolver::integrate(const Function& f, double a, double b) const {
+    return integrate_auto(f, a, b).value;
+}
+
+std::string AutoSolver::rule_name(Rule rule) {
+    switch (rule) {
+        case Rule::Trapezoid: return "Trapezoid";
+        case Rule::Simpson: return "Simpson";
+        case Rule::Weddle: return "Weddle";
+        default: return "MonteCarlo";
+    }
+}
+
+AutoSolver::Result AutoSolver::integrate_auto(const Function& f, double a, double b) const {
+    validate_interval(a, b);
+    const std::uint64_t actual_seed = (seed_ != 0) ? seed_ : std::random_device{}();
+    std::atomic<std::uint64_t> evaluations{0};
+    const CountingFunction counted(f, evaluations);
+
+    Result result{};
+    const std::size_t finest = pilot_n_ << (pilot_levels - 1);
+
+    // grid pilots: values on the nested grids, the finest one is kept for a possible early exit
+    struct GridPilot {
+        double finest_value;       // Q(8 n0)
+        double finest_difference;  // |Q(8 n0) - Q(4 n0)|
+    };
+    std::vector<GridPilot> grid_pilots;
+    double reference = 0.0;
+    for (Rule rule : {Rule::Trapezoid, Rule::Simpson, Rule::Weddle}) {
+        double q[pilot_levels];
+        const std::uint64_t before = evaluations.load();
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t k = 0; k < pilot_levels; ++k) {
+            q[k] = grid_rule(rule, counted, a, b, pilot_n_ << k, threads_);
+        }
+        const double seconds = seconds_since(start);
+        const double pilot_evaluations = static_cast<double>(evaluations.load() - before);
+
+        const double d_coarse = std::abs(q[pilot_levels - 2] - q[pilot_levels - 3]);
+        const double d_fine = std::abs(q[pilot_levels - 1] - q[pilot_levels - 2]);
+        double order = max_order;
+        if (d_fine > 0.0) {
+            order = (d_coarse > 0.0) ? std::log2(d_coarse / d_fine) : min_order;
+            order = std::min(std::max(order, min_order), max_order);
+        }
+        const double pilot_error = d_fine / (std::exp2(order) - 1.0);
+        result.candidates.push_back({rule, order, pilot_error, seconds / pilot_evaluations, finest, 0.0, 0.0});
+        grid_pilots.push_back({q[pilot_levels - 1], d_fine});
+        if (rule == Rule::Simpson) reference = q[pilot_levels - 1];
+    }
+
+    // Monte Carlo pilot: standard error of 64 n0 samples
+    {
+        const std::uint64_t before = evaluations.load();
+        const auto start = std::chrono::steady_clock::now();
+        const MonteCarloSolver pilot(64 * pilot_n_, actual_seed, MonteCarloSolver::Mode::Parallel, threads_);
+        const MonteCarloSolver::Result r = pilot.integrate_streaming(counted, a, b, 0.0);
+        const double seconds = seconds_since(start);
+        const double pilot_evaluations = static_cast<double>(evaluations.load() - before);
+        result.candidates.push_back({Rule::MonteCarlo, 0.5, r.error, seconds / pilot_evaluations, r.samples, 0.0, 0.0});
+    }
+    result.pilot_evaluations = evaluations.load();
+
+    // predictions: n that reaches safety * tolerance under e(n) = pilot_error * (n_pilot / n)^order
+    const double tolerance = std::max(abs_tol_, rel_tol_ * std::abs(reference));
+    const double target = safety * tolerance;
+    const double budget = static_cast<double>(max_evaluations_);
+    for (Candidate& c : result.candidates) {
+        const bool grid = c.rule != Rule::MonteCarlo;
+        const double pilot_n = static_cast<double>(c.n);
+        if (c.pilot_error <= target) {
+            // the pilot is already good enough (a grid rule keeps its value, Monte Carlo reruns the pilot)
+            c.predicted_error = c.pilot_error;
+            c.predicted_cost = grid ? 0.0 : pilot_n * c.cost_per_evaluation;
+            continue;
+        }
+        const double cap = grid ? budget / grid_final_factor : budget;
+        const double wanted = pilot_n * std::pow(c.pilot_error / target, 1.0 / c.order);
+        const double n = std::max(std::min(wanted, cap), pilot_n);
+        c.n = grid ? round_grid(c.rule, n) : static_cast<std::size_t>(std::ceil(n));
+        c.predicted_error = c.pilot_error * std::pow(pilot_n / static_cast<double>(c.n), c.order);
+        c.predicted_cost = (grid ? grid_final_factor : 1.0) * static_cast<double>(c.n) * c.cost_per_evaluation;
+    }
+
+    // the cheapest candidate that meets the target (the more accurate one on a tie, e.g. two pilots
+    // that are good enough already), else the most accurate one
+    const Candidate* chosen = nullptr;
+    for (const Candidate& c : result.candidates) {
+        if (c.predicted_error > target) continue;
+        if (!chosen || c.predicted_cost < chosen->predicted_cost
+            || (c.predicted_cost == chosen->predicted_cost && c.predicted_error < chosen->predicted_error)) {
+            chosen = &c;
+        }
+    }
+    if (!chosen) {
+        chosen = &*std::min_element(result.candidates.begin(), result.candidates.end(),
+                                    [](const Candidate& x, const Candidate& y) {
+                                        return x.predicted_error < y.predicted_error;
+                                    });
+    }
+    result.rule = chosen->rule;
+    result.n = chosen->n;
+    result.predicted_error = chosen->predicted_error;
+
+    if (chosen->rule == Rule::MonteCarlo) {
+        const MonteCarloSolver final_run(chosen->n, actual_seed, MonteCarloSolver::Mode::Parallel, threads_);
+        const MonteCarloSolver::Result r = final_run.integrate_streaming(counted, a, b, target);
+        result.value = r.value;
+        result.error = r.error;
+        result.n = r.samples;
+    } else {
+        // doubling from the finest pilot grid up to the predicted n, the order is re-estimated on
+        // every exact doubling, stops as soon as the Richardson estimate meets the target
+        const GridPilot& pilot = grid_pilots[static_cast<std::size_t>(chosen->rule)];
+        double order = chosen->order;
+        double value = pilot.finest_value;
+        double difference = pilot.finest_difference;
+        double error = chosen->pilot_error;
+        std::size_t n = finest;
+        while (error > target && n < chosen->n) {
+            const std::size_t next = std::min(2 * n, chosen->n);
+            const double next_value = grid_rule(chosen->rule, counted, a, b, next, threads_);
+            const double next_difference = std::abs(next_value - value);
+            if (next == 2 * n && next_difference > 0.0 && difference > 0.0) {
+                order = std::min(std::max(std::log2(difference / next_difference), min_order), max_order);
+            }
+            const double ratio = static_cast<double>(next) / static_cast<double>(n);
+            error = next_difference / (std::pow(ratio, order) - 1.0);
+            value = next_value;
+            difference = next_difference;
+            n = next;
+        }
+        result.value = value;
+        result.error = error;
+        result.n = n;
+    }
+    result.evaluations = evaluations.load();
+    result.converged = result.error <= std::max(abs_tol_, rel_tol_ * std::abs(result.value));
+    return result;
+}
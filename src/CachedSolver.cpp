@@ -0,0 +1,106 @@
+#include "CachedSolver.h"
+#include "CountingFunction.h"
+#include <functional>
+#include <typeinfo>
+
+/*
+Implementation of the caching solver wrappers.
+The wrapped solver runs outside the cache lock, so concurrent misses on different keys integrate in parallel
+(two concurrent misses on the same key both integrate, the second store overwrites the identical value).
+*/
+
+namespace {
+
+// the integrand that identifies a call: counting wrappers are replaced by what they count
+const Function& cache_identity(const Function& f) {
+    const Function* p = &f;
+    while (const auto* counting = dynamic_cast<const CountingFunction*>(p)) {
+        p = &counting->wrapped();
+    }
+    return *p;
+}
+
+const Function2D& cache_identity(const Function2D& f) {
+    const Function2D* p = &f;
+    for (;;) {
+        if (const auto* counting = dynamic_cast<const CountingFunction2D*>(p)) {
+            p = &counting->wrapped();
+        } else if (const auto* separable = dynamic_cast<const CountingSeparableFunction2D*>(p)) {
+            p = &separable->wrapped();
+        } else {
+            return *p;
+        }
+    }
+}
+
+}
+
+std::size_t IntegralKeyHash::operator()(const IntegralKey& key) const {
+    // boost::hash_combine style mixing
+    std::size_t seed = std::hash<const void*>{}(key.integrand);
+    auto combine = [&seed](std::size_t h) {
+        seed ^= h + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    };
+    combine(key.type.hash_code());
+    for (double bound : key.bounds) {
+        combine(std::hash<double>{}(bound));
+    }
+    combine(std::hash<std::string>{}(key.configuration));
+    return seed;
+}
+
+double CachedSolver::integrate(const Function& f, double a, double b) const {
+    std::string configuration = solver_->configuration();
+    if (configuration.empty()) {
+        ++bypassed_;
+        return solver_->integrate(f, a, b);
+    }
+
+    const Function& identity = cache_identity(f);
+    const IntegralKey key{&identity, std::type_index(typeid(identity)), {a, b, 0.0, 0.0}, std::move(configuration)};
+    double value = 0.0;
+    if (cache_.get(key, value)) return value;
+
+    value = solver_->integrate(f, a, b);
+    cache_.put(key, value);
+    return value;
+}
+
+CacheStats CachedSolver::stats() const {
+    const auto s = cache_.stats();
+    return {s.hits, s.misses, bypassed_.load(), s.size, s.capacity};
+}
+
+void CachedSolver::clear() {
+    cache_.clear();
+    bypassed_ = 0;
+}
+
+double CachedSolver2D::integrate(const Function2D& f,
+                                 double a, double b,
+                                 double c, double d) const {
+    std::string configuration = solver_->configuration();
+    if (configuration.empty()) {
+        ++bypassed_;
+        return solver_->integrate(f, a, b, c, d);
+    }
+
+    const Function2D& identity = cache_identity(f);
+    const IntegralKey key{&identity, std::type_index(typeid(identity)), {a, b, c, d}, std::move(configuration)};
+    double value = 0.0;
+    if (cache_.get(key, value)) return value;
+
+    value = solver_->integrate(f, a, b, c, d);
+    cache_.put(key, value);
+    return value;
+}
+
+CacheStats CachedSolver2D::stats() const {
+    const auto s = cache_.stats();
+    return {s.hits, s.misses, bypassed_.load(), s.size, s.capacity};
+}
+
+void CachedSolver2D::clear() {
+    cache_.clear();
+    bypassed_ = 0;
+}
@@ -0,0 +1,81 @@
+#include "ClenshawCurtisRule.h"
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+/*
+The Clenshaw-Curtis table, computed once on first use.
+*/
+
+namespace {
+
+struct Level {
+    std::vector<double> nodes;
+    std::vector<double> weights;
+    std::vector<double> differences;
+    std::vector<std::uint32_t> positions;
+};
+
+struct Table {
+    Level levels[clenshaw_curtis_max_level];
+};
+
+Table make_table() {
+    const double pi = 3.14159265358979323846;
+    Table table;
+    for (std::size_t l = 1; l <= clenshaw_curtis_max_level; ++l) {
+        Level& level = table.levels[l - 1];
+        if (l == 1) {
+            level.nodes = {0.0};
+            level.weights = {2.0};
+            level.differences = {2.0};
+            level.positions = {clenshaw_curtis_positions / 2};
+            continue;
+        }
+        const std::size_t n = std::size_t(1) << (l - 1);  // intervals
+        level.nodes.resize(n + 1);
+        level.weights.resize(n + 1);
+        level.positions.resize(n + 1);
+        for (std::size_t j = 0; j <= n; ++j) {
+            // -cos(pi j / n) written as a sine: exactly antisymmetric, exactly 0 in the middle
+            level.nodes[j] = std::sin(pi * (2.0 * static_cast<double>(j) - static_cast<double>(n))
+                                      / (2.0 * static_cast<double>(n)));
+            level.positions[j] = static_cast<std::uint32_t>(j << (clenshaw_curtis_max_level - l));
+
+            // w_j = c_j / n (1 - Σ_k b_k / (4k^2 - 1) cos(2 pi k j / n)), c = 1 at the ends, b = 1 for k = n/2
+            double s = 0.0;
+            for (std::size_t k = 1; k <= n / 2; ++k) {
+                const double b = (2 * k == n) ? 1.0 : 2.0;
+                s += b / static_cast<double>(4 * k * k - 1)
+                   * std::cos(2.0 * pi * static_cast<double>(k * j % n) / static_cast<double>(n));
+            }
+            const double c = (j == 0 || j == n) ? 1.0 : 2.0;
+            level.weights[j] = c / static_cast<double>(n) * (1.0 - s);
+        }
+
+        // Q_l - Q_(l-1): the nodes of level l - 1 are the even nodes of level l
+        // (for l = 2 the single midpoint of level 1 is node 1)
+        const Level& coarse = table.levels[l - 2];
+        level.differences = level.weights;
+        for (std::size_t j = 0; j < coarse.nodes.size(); ++j) {
+            const std::size_t fine = (l == 2) ? 1 : 2 * j;
+            level.differences[fine] -= coarse.weights[j];
+        }
+    }
+    return table;
+}
+
+const Table& table() {
+    static const Table t = make_table();
+    return t;
+}
+
+}
+
+ClenshawCurtisRule clenshaw_curtis_rule(std::size_t level) {
+    if (level < 1 || level > clenshaw_curtis_max_level) {
+        throw std::invalid_argument("Clenshaw-Curtis level must be in [1, 12]");
+    }
+    const Level& l = table().levels[level - 1];
+    return {l.nodes.data(), l.weights.data(), l.differences.data(), l.positions.data(), l.nodes.size()};
+}
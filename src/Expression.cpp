@@ -0,0 +1,847 @@
+#include "Expression.h"
+#include "VectorMath.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+/*
+Implementation of the expression integrands: parser, DAG with folding and common subexpressions,
+register allocation and the block interpreter.
+*/
+
+namespace {
+
+// values per register, the block size of the solvers
+constexpr std::size_t block = 256;
+
+// integer exponents up to this become multiplication chains
+constexpr double max_chain_exponent = 64.0;
+
+// sums (and, with expand, products of sums) split into at most this many separable terms
+constexpr std::size_t max_separable_terms = 16;
+
+// deepest nesting the parser accepts (parentheses, signs, exponents, operator chains), the parser,
+// the lowering and the syntax tree itself recurse once per level
+constexpr std::size_t max_nesting = 1000;
+
+enum class Op : std::uint8_t {
+    Const, Var, Neg, Add, Sub, Mul, Div, Pow, Min, Max, Abs, Sqrt, Rsqrt, Sin, Cos, Tan, Exp, Log
+};
+
+const char* op_name(Op op) {
+    switch (op) {
+        case Op::Const: return "const";
+        case Op::Var: return "var";
+        case Op::Neg: return "neg";
+        case Op::Add: return "add";
+        case Op::Sub: return "sub";
+        case Op::Mul: return "mul";
+        case Op::Div: return "div";
+        case Op::Pow: return "pow";
+        case Op::Min: return "min";
+        case Op::Max: return "max";
+        case Op::Abs: return "abs";
+        case Op::Sqrt: return "sqrt";
+        case Op::Rsqrt: return "rsqrt";
+        case Op::Sin: return "sin";
+        case Op::Cos: return "cos";
+        case Op::Tan: return "tan";
+        case Op::Exp: return "exp";
+        default: return "log";
+    }
+}
+
+bool is_binary(Op op) {
+    return op == Op::Add || op == Op::Sub || op == Op::Mul || op == Op::Div
+        || op == Op::Pow || op == Op::Min || op == Op::Max;
+}
+
+// the scalar meaning of every operation, used for constant folding
+double apply_scalar(Op op, double u, double v) {
+    switch (op) {
+        case Op::Neg: return -u;
+        case Op::Add: return u + v;
+        case Op::Sub: return u - v;
+        case Op::Mul: return u * v;
+        case Op::Div: return u / v;
+        case Op::Pow: return std::pow(u, v);
+        case Op::Min: return std::fmin(u, v);
+        case Op::Max: return std::fmax(u, v);
+        case Op::Abs: return std::abs(u);
+        case Op::Sqrt: return std::sqrt(u);
+        case Op::Rsqrt: return 1.0 / std::sqrt(u);
+        case Op::Sin: return std::sin(u);
+        case Op::Cos: return std::cos(u);
+        case Op::Tan: return std::tan(u);
+        case Op::Exp: return std::exp(u);
+        case Op::Log: return std::log(u);
+        default: return u;
+    }
+}
+
+std::string format_number(double v) {
+    std::ostringstream out;
+    out.precision(17);
+    out << v;
+    return out.str();
+}
+
+
+// ============================================================
+// syntax tree
+// ============================================================
+
+struct Ast {
+    enum class Kind { Number, Name, Negate, Binary, Call };
+    Kind kind;
+    std::size_t position;   // offset in the source, for error messages
+    double value = 0.0;     // Number
+    std::string name;       // Name, Call
+    char op = 0;            // Binary: + - * / ^
+    std::size_t depth = 1;  // levels of the tree below and including this node
+    std::vector<std::unique_ptr<Ast>> args;
+};
+
+std::invalid_argument syntax_error(const std::string& source, const std::string& what, std::size_t position) {
+    return std::invalid_argument("expression \"" + source + "\": " + what + " at position " + std::to_string(position));
+}
+
+// expression := term {('+' | '-') term}
+// term       := unary {('*' | '/') unary}
+// unary      := ('-' | '+') unary | power
+// power      := primary ['^' unary]
+// primary    := number | name | name '(' expression {',' expression} ')' | '(' expression ')'
+class Parser {
+public:
+    explicit Parser(const std::string& source) : s_(source) {}
+
+    std::unique_ptr<Ast> parse() {
+        std::unique_ptr<Ast> e = expression();
+        skip_spaces();
+        if (pos_ < s_.size()) throw syntax_error(s_, std::string("unexpected '") + s_[pos_] + "'", pos_);
+        return e;
+    }
+
+private:
+    void skip_spaces() {
+        while (pos_ < s_.size() && std::isspace(static_cast<unsigned char>(s_[pos_]))) ++pos_;
+    }
+
+    // consumes c if it is the next character
+    bool accept(char c) {
+        skip_spaces();
+        if (pos_ < s_.size() && s_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!accept(c)) {
+            throw syntax_error(s_, std::string("expected '") + c + "'", pos_);
+        }
+    }
+
+    std::unique_ptr<Ast> node(Ast::Kind kind, std::size_t position) {
+        std::unique_ptr<Ast> a = std::make_unique<Ast>();
+        a->kind = kind;
+        a->position = position;
+        return a;
+    }
+
+    // attaches the operand to a and checks the depth of the tree
+    void add_argument(Ast& a, std::unique_ptr<Ast> arg) {
+        a.depth = std::max(a.depth, arg->depth + 1);
+        if (a.depth > max_nesting) throw too_deep(a.position);
+        a.args.push_back(std::move(arg));
+    }
+
+    std::unique_ptr<Ast> binary(char op, std::size_t position, std::unique_ptr<Ast> l, std::unique_ptr<Ast> r) {
+        std::unique_ptr<Ast> a = node(Ast::Kind::Binary, position);
+        a->op = op;
+        add_argument(*a, std::move(l));
+        add_argument(*a, std::move(r));
+        return a;
+    }
+
+    std::invalid_argument too_deep(std::size_t position) const {
+        return syntax_error(s_, "nested deeper than " + std::to_string(max_nesting) + " levels", position);
+    }
+
+    std::unique_ptr<Ast> expression() {
+        std::unique_ptr<Ast> e = term();
+        for (;;) {
+            const std::size_t position = pos_;
+            if (accept('+')) e = binary('+', position, std::move(e), term());
+            else if (accept('-')) e = binary('-', position, std::move(e), term());
+            else return e;
+        }
+    }
+
+    std::unique_ptr<Ast> term() {
+        std::unique_ptr<Ast> e = unary();
+        for (;;) {
+            const std::size_t position = pos_;
+            if (accept('*')) e = binary('*', position, std::move(e), unary());
+            else if (accept('/')) e = binary('/', position, std::move(e), unary());
+            else return e;
+        }
+    }
+
+    // every recursion of the parser (parentheses, arguments, signs, exponents) passes through here
+    std::unique_ptr<Ast> unary() {
+        skip_spaces();
+        const std::size_t position = pos_;
+        if (nesting_ == max_nesting) throw too_deep(position);
+        ++nesting_;
+        std::unique_ptr<Ast> e;
+        if (accept('-')) {
+            e = node(Ast::Kind::Negate, position);
+            add_argument(*e, unary());
+        } else if (accept('+')) {
+            e = unary();
+        } else {
+            e = power();
+        }
+        --nesting_;
+        return e;
+    }
+
+    std::unique_ptr<Ast> power() {
+        std::unique_ptr<Ast> base = primary();
+        const std::size_t position = pos_;
+        if (accept('^')) return binary('^', position, std::move(base), unary());
+        return base;
+    }
+
+    std::unique_ptr<Ast> primary() {
+        skip_spaces();
+        const std::size_t position = pos_;
+        if (pos_ >= s_.size()) throw syntax_error(s_, "unexpected end", pos_);
+        const char c = s_[pos_];
+
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            // decimal literals only: digits [. digits] [e [+-] digits]; strtod alone would also take
+            // hexadecimal ("0x10"), so the literal is delimited here and must not run into a name
+            std::size_t end = pos_;
+            auto digits = [&] {
+                const std::size_t start = end;
+                while (end < s_.size() && std::isdigit(static_cast<unsigned char>(s_[end]))) ++end;
+                return end > start;
+            };
+            bool mantissa = digits();
+            if (end < s_.size() && s_[end] == '.') {
+                ++end;
+                mantissa = digits() || mantissa;
+            }
+            if (!mantissa) throw syntax_error(s_, "invalid number", pos_);
+            if (end < s_.size() && (s_[end] == 'e' || s_[end] == 'E')) {
+                ++end;
+                if (end < s_.size() && (s_[end] == '+' || s_[end] == '-')) ++end;
+                if (!digits()) throw syntax_error(s_, "invalid number", pos_);
+            }
+            if (end < s_.size() && (std::isalnum(static_cast<unsigned char>(s_[end])) || s_[end] == '_' || s_[end] == '.')) {
+                throw syntax_error(s_, "invalid number", pos_);
+            }
+            const double value = std::strtod(s_.substr(pos_, end - pos_).c_str(), nullptr);
+            pos_ = end;
+            std::unique_ptr<Ast> a = node(Ast::Kind::Number, position);
+            a->value = value;
+            return a;
+        }
+
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            std::size_t end = pos_;
+            while (end < s_.size() && (std::isalnum(static_cast<unsigned char>(s_[end])) || s_[end] == '_')) ++end;
+            std::string name = s_.substr(pos_, end - pos_);
+            pos_ = end;
+            if (!accept('(')) {
+                std::unique_ptr<Ast> a = node(Ast::Kind::Name, position);
+                a->name = std::move(name);
+                return a;
+            }
+            std::unique_ptr<Ast> a = node(Ast::Kind::Call, position);
+            a->name = std::move(name);
+            do {
+                add_argument(*a, expression());
+            } while (accept(','));
+            expect(')');
+            return a;
+        }
+
+        if (accept('(')) {
+            std::unique_ptr<Ast> e = expression();
+            expect(')');
+            return e;
+        }
+        throw syntax_error(s_, std::string("unexpected '") + c + "'", pos_);
+    }
+
+    const std::string& s_;
+    std::size_t pos_ = 0;
+    std::size_t nesting_ = 0; // active unary() calls
+};
+
+
+// ============================================================
+// DAG: every node exists once, constant operands are folded
+// ============================================================
+
+struct Node {
+    Op op;
+    int a;            // operands (node indices), -1 if unused
+    int b;
+    double value;     // Const
+    int variable;     // Var
+    unsigned deps;    // bit v set if the node depends on variable v
+};
+
+class Graph {
+public:
+    int constant(double v) {
+        return intern({Op::Const, -1, -1, v, -1, 0u});
+    }
+
+    int variable(int index) {
+        return intern({Op::Var, -1, -1, 0.0, index, 1u << index});
+    }
+
+    // op applied to a (and b), folded and simplified where the result is exact
+    int make(Op op, int a, int b = -1) {
+        const bool binary = is_binary(op);
+        if (is_constant(a) && (!binary || is_constant(b))) {
+            return constant(apply_scalar(op, nodes_[a].value, binary ? nodes_[b].value : 0.0));
+        }
+        switch (op) {
+            case Op::Mul:
+                if (is_constant(a, 1.0)) return b;
+                if (is_constant(b, 1.0)) return a;
+                if (is_constant(a, -1.0)) return make(Op::Neg, b);
+                if (is_constant(b, -1.0)) return make(Op::Neg, a);
+                break;
+            case Op::Div:
+                if (is_constant(b, 1.0)) return a;
+                // 1 / sqrt(u) is the rsqrt kernel (the same two rounded operations)
+                if (is_constant(a, 1.0) && nodes_[b].op == Op::Sqrt) return make(Op::Rsqrt, nodes_[b].a);
+                break;
+            case Op::Sub:
+                if (is_constant(b, 0.0)) return a;
+                break;
+            case Op::Neg:
+                if (nodes_[a].op == Op::Neg) return nodes_[a].a;
+                break;
+            default:
+                break;
+        }
+        // commutative operations get a canonical operand order, so x*y and y*x are one node
+        if ((op == Op::Add || op == Op::Mul || op == Op::Min || op == Op::Max) && b < a) std::swap(a, b);
+        return intern({op, a, b, 0.0, -1, nodes_[a].deps | (b >= 0 ? nodes_[b].deps : 0u)});
+    }
+
+    // base^exponent: multiplication chains for integer exponents, sqrt / rsqrt for +-1/2
+    int power(int base, int exponent) {
+        if (is_constant(exponent) && !is_constant(base)) {
+            const double c = nodes_[exponent].value;
+            if (c == 0.5) return make(Op::Sqrt, base);
+            if (c == -0.5) return make(Op::Rsqrt, base);
+            if (c == std::floor(c) && std::abs(c) <= max_chain_exponent) {
+                const int p = integer_power(base, static_cast<unsigned>(std::abs(c)));
+                return c < 0 ? make(Op::Div, constant(1.0), p) : p;
+            }
+        }
+        return make(Op::Pow, base, exponent);
+    }
+
+    const Node& operator[](int i) const { return nodes_[static_cast<std::size_t>(i)]; }
+    std::size_t size() const { return nodes_.size(); }
+
+    bool is_constant(int i) const { return nodes_[i].op == Op::Const; }
+    bool is_constant(int i, double v) const { return is_constant(i) && nodes_[i].value == v; }
+
+    unsigned dependencies(int i) const { return nodes_[i].deps; }
+
+    // the node as fully parenthesized source text
+    std::string source(int i, const std::vector<std::string>& names) const {
+        const Node& n = nodes_[i];
+        switch (n.op) {
+            case Op::Const:
+                if (std::isnan(n.value)) return "(0/0)";
+                if (std::isinf(n.value)) return n.value > 0 ? "(1/0)" : "(-1/0)";
+                return "(" + format_number(n.value) + ")";
+            case Op::Var: return names[static_cast<std::size_t>(n.variable)];
+            case Op::Neg: return "(-" + source(n.a, names) + ")";
+            case Op::Add: return "(" + source(n.a, names) + "+" + source(n.b, names) + ")";
+            case Op::Sub: return "(" + source(n.a, names) + "-" + source(n.b, names) + ")";
+            case Op::Mul: return "(" + source(n.a, names) + "*" + source(n.b, names) + ")";
+            case Op::Div: return "(" + source(n.a, names) + "/" + source(n.b, names) + ")";
+            case Op::Rsqrt: return "(1/sqrt(" + source(n.a, names) + "))";
+            default:
+                if (is_binary(n.op)) {
+                    return std::string(op_name(n.op)) + "(" + source(n.a, names) + "," + source(n.b, names) + ")";
+                }
+                return std::string(op_name(n.op)) + "(" + source(n.a, names) + ")";
+        }
+    }
+
+private:
+    // x^p by squaring, x^10 = x^8 * x^2 like F2
+    int integer_power(int base, unsigned p) {
+        int result = -1;
+        int square = base;
+        for (;;) {
+            if (p & 1u) result = (result < 0) ? square : make(Op::Mul, result, square);
+            p >>= 1;
+            if (!p) break;
+            square = make(Op::Mul, square, square);
+        }
+        return result < 0 ? constant(1.0) : result;
+    }
+
+    int intern(const Node& n) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &n.value, sizeof bits);
+        const auto key = std::make_tuple(static_cast<int>(n.op), n.a, n.b, bits, n.variable);
+        const auto it = index_.find(key);
+        if (it != index_.end()) return it->second;
+        nodes_.push_back(n);
+        const int i = static_cast<int>(nodes_.size()) - 1;
+        index_.emplace(key, i);
+        return i;
+    }
+
+    std::vector<Node> nodes_;
+    std::map<std::tuple<int, int, int, std::uint64_t, int>, int> index_;
+};
+
+struct Builtin {
+    const char* name;
+    Op op;
+    std::size_t arity;
+};
+
+const Builtin builtins[] = {
+    {"sin", Op::Sin, 1}, {"cos", Op::Cos, 1}, {"tan", Op::Tan, 1}, {"exp", Op::Exp, 1},
+    {"log", Op::Log, 1}, {"sqrt", Op::Sqrt, 1}, {"abs", Op::Abs, 1},
+    {"pow", Op::Pow, 2}, {"min", Op::Min, 2}, {"max", Op::Max, 2},
+};
+
+const Builtin* find_function(const std::string& name) {
+    for (const Builtin& f : builtins) {
+        if (name == f.name) return &f;
+    }
+    return nullptr;
+}
+
+bool is_reserved(const std::string& name) {
+    return name == "pi" || name == "e" || find_function(name) != nullptr;
+}
+
+// lowers the syntax tree into the graph, returns the root node
+class Lowering {
+public:
+    Lowering(Graph& graph, const std::string& source, const std::vector<std::string>& variables)
+        : graph_(graph), source_(source), variables_(variables) {}
+
+    int lower(const Ast& a) {
+        switch (a.kind) {
+            case Ast::Kind::Number:
+                return graph_.constant(a.value);
+            case Ast::Kind::Name: {
+                const auto it = std::find(variables_.begin(), variables_.end(), a.name);
+                if (it != variables_.end()) return graph_.variable(static_cast<int>(it - variables_.begin()));
+                if (a.name == "pi") return graph_.constant(3.14159265358979323846);
+                if (a.name == "e") return graph_.constant(2.71828182845904523536);
+                if (find_function(a.name)) throw syntax_error(source_, "function " + a.name + " needs arguments", a.position);
+                throw syntax_error(source_, "unknown name " + a.name, a.position);
+            }
+            case Ast::Kind::Negate:
+                return graph_.make(Op::Neg, lower(*a.args[0]));
+            case Ast::Kind::Binary: {
+                const int l = lower(*a.args[0]);
+                const int r = lower(*a.args[1]);
+                switch (a.op) {
+                    case '+': return graph_.make(Op::Add, l, r);
+                    case '-': return graph_.make(Op::Sub, l, r);
+                    case '*': return graph_.make(Op::Mul, l, r);
+                    case '/': return graph_.make(Op::Div, l, r);
+                    default: return graph_.power(l, r);
+                }
+            }
+            default: {
+                const Builtin* f = find_function(a.name);
+                if (!f) throw syntax_error(source_, "unknown function " + a.name, a.position);
+                if (a.args.size() != f->arity) {
+                    throw syntax_error(source_, a.name + " takes " + std::to_string(f->arity)
+                                       + (f->arity == 1 ? " argument" : " arguments"), a.position);
+                }
+                const int u = lower(*a.args[0]);
+                if (f->op == Op::Pow) return graph_.power(u, lower(*a.args[1]));
+                return f->arity == 1 ? graph_.make(f->op, u) : graph_.make(f->op, u, lower(*a.args[1]));
+            }
+        }
+    }
+
+private:
+    Graph& graph_;
+    const std::string& source_;
+    const std::vector<std::string>& variables_;
+};
+
+// identifiers that are not reserved, each once, at most 32 (the dependency bit masks)
+void check_variables(const std::vector<std::string>& variables) {
+    if (variables.size() > 32) throw std::invalid_argument("expression: at most 32 variables");
+    for (std::size_t v = 0; v < variables.size(); ++v) {
+        const std::string& name = variables[v];
+        bool identifier = !name.empty() && !std::isdigit(static_cast<unsigned char>(name[0]));
+        for (const char c : name) identifier &= std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+        if (!identifier || is_reserved(name)) {
+            throw std::invalid_argument("expression: invalid variable name \"" + name + "\"");
+        }
+        for (std::size_t w = 0; w < v; ++w) {
+            if (variables[w] == name) throw std::invalid_argument("expression: variable \"" + name + "\" given twice");
+        }
+    }
+}
+
+// parses source and lowers it into graph, returns the root node
+int build(Graph& graph, const std::string& source, const std::vector<std::string>& variables) {
+    check_variables(variables);
+    const std::unique_ptr<Ast> ast = Parser(source).parse();
+    return Lowering(graph, source, variables).lower(*ast);
+}
+
+
+// ============================================================
+// separation into products of one-variable factors
+// ============================================================
+
+// f = Σ_k x_factor_k * y_factor_k (node indices), variables 0 = x and 1 = y
+using Terms = std::vector<std::pair<int, int>>;
+
+// without expand only sums of products of one-variable factors are taken apart, which only
+// reassociates the products; expand also distributes products (and quotients) of sums and splits exp
+bool separate(Graph& g, int node, Terms& terms, bool expand) {
+    const unsigned deps = g.dependencies(node);
+    if ((deps & 2u) == 0) {
+        terms = {{node, g.constant(1.0)}};
+        return true;
+    }
+    if ((deps & 1u) == 0) {
+        terms = {{g.constant(1.0), node}};
+        return true;
+    }
+    const Node n = g[node];
+    Terms a;
+    Terms b;
+    switch (n.op) {
+        case Op::Add:
+        case Op::Sub:
+            if (!separate(g, n.a, a, expand) || !separate(g, n.b, b, expand)) return false;
+            if (a.size() + b.size() > max_separable_terms) return false;
+            terms = a;
+            for (const auto& t : b) terms.push_back({n.op == Op::Sub ? g.make(Op::Neg, t.first) : t.first, t.second});
+            return true;
+        case Op::Neg:
+            if (!separate(g, n.a, a, expand)) return false;
+            for (const auto& t : a) terms.push_back({g.make(Op::Neg, t.first), t.second});
+            return true;
+        case Op::Mul:
+            // (x - y) * (x - y) expanded cancels catastrophically for x ~ y far from 0
+            if (!separate(g, n.a, a, expand) || !separate(g, n.b, b, expand)) return false;
+            if (!expand && (a.size() > 1 || b.size() > 1)) return false;
+            if (a.size() * b.size() > max_separable_terms) return false;
+            for (const auto& s : a) {
+                for (const auto& t : b) terms.push_back({g.make(Op::Mul, s.first, t.first), g.make(Op::Mul, s.second, t.second)});
+            }
+            return true;
+        case Op::Div: {
+            // a / u(x) or a / v(y)
+            const unsigned divisor = g.dependencies(n.b);
+            if (divisor == 3u || !separate(g, n.a, a, expand)) return false;
+            if (!expand && a.size() > 1) return false;
+            for (const auto& t : a) {
+                terms.push_back(divisor & 1u ? std::make_pair(g.make(Op::Div, t.first, n.b), t.second)
+                                             : std::make_pair(t.first, g.make(Op::Div, t.second, n.b)));
+            }
+            return true;
+        }
+        case Op::Exp: {
+            // exp(u(x) + v(y)) = exp(u(x)) * exp(v(y)) if the argument is a sum of one-variable terms;
+            // the factors can overflow where the integrand is finite (exp(800 x - 800 y))
+            if (!expand || !separate(g, n.a, a, expand)) return false;
+            int u = -1;
+            int v = -1;
+            for (const auto& t : a) {
+                int& sum = g.is_constant(t.second) ? u : v;
+                if (!g.is_constant(t.first) && !g.is_constant(t.second)) return false;
+                const int part = g.make(Op::Mul, t.first, t.second);
+                sum = (sum < 0) ? part : g.make(Op::Add, sum, part);
+            }
+            if (u < 0) u = g.constant(0.0);
+            if (v < 0) v = g.constant(0.0);
+            terms = {{g.make(Op::Exp, u), g.make(Op::Exp, v)}};
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+
+// ============================================================
+// bytecode
+// ============================================================
+
+// operand slots: [0, variables) the arguments, variables the output, variables + 1 + r register r;
+// an operand -1 is the constant of the instruction
+struct Instruction {
+    Op op;
+    int dst;
+    int a;
+    int b;
+    double constant;
+};
+
+}
+
+struct ExpressionProgram {
+    std::size_t variables = 0;
+    std::size_t registers = 0;
+    std::vector<Instruction> code;
+    // without code the result is a variable (result_variable >= 0) or a constant
+    int result_variable = -1;
+    double result_constant = 0.0;
+};
+
+namespace {
+
+// schedules the nodes reachable from root in creation order (operands come first),
+// a register is released after the last instruction that reads it
+std::shared_ptr<ExpressionProgram> compile(const Graph& g, int root, std::size_t variables) {
+    auto program = std::make_shared<ExpressionProgram>();
+    program->variables = variables;
+    if (g[root].op == Op::Const) {
+        program->result_constant = g[root].value;
+        return program;
+    }
+    if (g[root].op == Op::Var) {
+        program->result_variable = g[root].variable;
+        return program;
+    }
+
+    const std::size_t size = static_cast<std::size_t>(root) + 1;
+    std::vector<char> needed(size, 0);
+    needed[static_cast<std::size_t>(root)] = 1;
+    for (int i = root; i >= 0; --i) {
+        const Node& n = g[i];
+        if (!needed[static_cast<std::size_t>(i)]) continue;
+        if (n.a >= 0) needed[static_cast<std::size_t>(n.a)] = 1;
+        if (n.b >= 0) needed[static_cast<std::size_t>(n.b)] = 1;
+    }
+    std::vector<int> last_use(size, -1);
+    for (int i = 0; i <= root; ++i) {
+        const Node& n = g[i];
+        if (!needed[static_cast<std::size_t>(i)] || n.op == Op::Const || n.op == Op::Var) continue;
+        last_use[static_cast<std::size_t>(n.a)] = i;
+        if (n.b >= 0) last_use[static_cast<std::size_t>(n.b)] = i;
+    }
+
+    const int output = static_cast<int>(variables);
+    std::vector<int> slot(size, -1);
+    std::vector<int> free_registers;
+    for (int i = 0; i <= root; ++i) {
+        const Node& n = g[i];
+        if (!needed[static_cast<std::size_t>(i)]) continue;
+        if (n.op == Op::Var) {
+            slot[static_cast<std::size_t>(i)] = n.variable;
+            continue;
+        }
+        if (n.op == Op::Const) continue;
+
+        Instruction ins{n.op, 0, -1, -1, 0.0};
+        for (const int operand : {n.a, n.b}) {
+            if (operand < 0) continue;
+            int& target = (operand == n.a) ? ins.a : ins.b;
+            if (g[operand].op == Op::Const) {
+                ins.constant = g[operand].value;
+            } else {
+                target = slot[static_cast<std::size_t>(operand)];
+            }
+        }
+        if (n.b >= 0 && n.a == n.b) ins.b = ins.a;
+        // operands read for the last time free their registers, the result may reuse one
+        // (every instruction works element by element)
+        for (const int operand : {n.a, n.b}) {
+            if (operand < 0 || last_use[static_cast<std::size_t>(operand)] != i) continue;
+            const int s = slot[static_cast<std::size_t>(operand)];
+            if (s > output && std::find(free_registers.begin(), free_registers.end(), s) == free_registers.end()) {
+                free_registers.push_back(s);
+            }
+        }
+        if (i == root) {
+            ins.dst = output;
+        } else if (!free_registers.empty()) {
+            ins.dst = free_registers.back();
+            free_registers.pop_back();
+        } else {
+            ins.dst = output + 1 + static_cast<int>(program->registers++);
+        }
+        slot[static_cast<std::size_t>(i)] = ins.dst;
+        program->code.push_back(ins);
+    }
+    return program;
+}
+
+// d[k] = f(a[k], b[k]), a missing operand (nullptr) is the constant c
+template <class F>
+void binary(const double* a, const double* b, double c, double* d, std::size_t m, F f) {
+    if (!a) {
+        for (std::size_t k = 0; k < m; ++k) d[k] = f(c, b[k]);
+    } else if (!b) {
+        for (std::size_t k = 0; k < m; ++k) d[k] = f(a[k], c);
+    } else {
+        for (std::size_t k = 0; k < m; ++k) d[k] = f(a[k], b[k]);
+    }
+}
+
+template <class F>
+void unary(const double* a, double* d, std::size_t m, F f) {
+    for (std::size_t k = 0; k < m; ++k) d[k] = f(a[k]);
+}
+
+/*
+Runs the program on n points. variable(v, i0) returns the values of argument v from point i0 on.
+The registers are per thread, the solvers call evaluate from several worker threads.
+*/
+template <class Variable>
+void run(const ExpressionProgram& p, Variable variable, double* out, std::size_t n) {
+    if (p.code.empty()) {
+        if (p.result_variable < 0) {
+            std::fill(out, out + n, p.result_constant);
+        } else {
+            // memmove: out may be the argument itself
+            const double* x = variable(static_cast<std::size_t>(p.result_variable), 0);
+            if (x != out && n) std::memmove(out, x, n * sizeof(double));
+        }
+        return;
+    }
+
+    thread_local std::vector<double> registers;
+    if (registers.size() < p.registers * block) registers.resize(p.registers * block);
+    const int output = static_cast<int>(p.variables);
+
+    for (std::size_t i0 = 0; i0 < n; i0 += block) {
+        const std::size_t m = std::min(block, n - i0);
+        auto source = [&](int s) -> const double* {
+            if (s < 0) return nullptr;
+            if (s < output) return variable(static_cast<std::size_t>(s), i0);
+            if (s == output) return out + i0;
+            return registers.data() + static_cast<std::size_t>(s - output - 1) * block;
+        };
+        for (const Instruction& ins : p.code) {
+            const double* a = source(ins.a);
+            const double* b = source(ins.b);
+            double* d = (ins.dst == output) ? out + i0
+                                            : registers.data() + static_cast<std::size_t>(ins.dst - output - 1) * block;
+            const double c = ins.constant;
+            switch (ins.op) {
+                case Op::Neg: unary(a, d, m, [](double u) { return -u; }); break;
+                case Op::Abs: unary(a, d, m, [](double u) { return std::abs(u); }); break;
+                case Op::Sqrt: unary(a, d, m, [](double u) { return std::sqrt(u); }); break;
+                case Op::Tan: unary(a, d, m, [](double u) { return std::tan(u); }); break;
+                case Op::Rsqrt: vmath::rsqrt(a, d, m); break;
+                case Op::Sin: vmath::sin(a, d, m); break;
+                case Op::Cos: vmath::cos(a, d, m); break;
+                case Op::Exp: vmath::exp(a, d, m); break;
+                case Op::Log: vmath::log(a, d, m); break;
+                case Op::Add: binary(a, b, c, d, m, [](double u, double v) { return u + v; }); break;
+                case Op::Sub: binary(a, b, c, d, m, [](double u, double v) { return u - v; }); break;
+                case Op::Mul: binary(a, b, c, d, m, [](double u, double v) { return u * v; }); break;
+                case Op::Div: binary(a, b, c, d, m, [](double u, double v) { return u / v; }); break;
+                case Op::Pow: binary(a, b, c, d, m, [](double u, double v) { return std::pow(u, v); }); break;
+                case Op::Min: binary(a, b, c, d, m, [](double u, double v) { return std::fmin(u, v); }); break;
+                case Op::Max: binary(a, b, c, d, m, [](double u, double v) { return std::fmax(u, v); }); break;
+                default: break;
+            }
+        }
+    }
+}
+
+}
+
+Expression::Expression(const std::string& source, std::vector<std::string> variables)
+    : source_(source), variables_(std::move(variables)) {
+    Graph graph;
+    const int root = build(graph, source_, variables_);
+    program_ = compile(graph, root, variables_.size());
+}
+
+double Expression::operator()(const double* args) const {
+    double out;
+    run(*program_, [args](std::size_t v, std::size_t) { return args + v; }, &out, 1);
+    return out;
+}
+
+void Expression::evaluate(const double* const* args, double* out, std::size_t n) const {
+    run(*program_, [args](std::size_t v, std::size_t i0) { return args[v] + i0; }, out, n);
+}
+
+std::size_t Expression::instructions() const {
+    return program_->code.size();
+}
+
+std::size_t Expression::registers() const {
+    return program_->registers;
+}
+
+std::string Expression::disassemble() const {
+    const int output = static_cast<int>(variables_.size());
+    auto name = [&](int s, double c) {
+        if (s < 0) return format_number(c);
+        if (s < output) return variables_[static_cast<std::size_t>(s)];
+        if (s == output) return std::string("out");
+        return "r" + std::to_string(s - output - 1);
+    };
+    std::ostringstream out;
+    if (program_->code.empty()) {
+        out << "out = " << name(program_->result_variable, program_->result_constant) << "\n";
+    }
+    for (const Instruction& ins : program_->code) {
+        out << name(ins.dst, 0.0) << " = " << op_name(ins.op) << " " << name(ins.a, ins.constant);
+        if (is_binary(ins.op)) out << ", " << name(ins.b, ins.constant);
+        out << "\n";
+    }
+    return out.str();
+}
+
+std::unique_ptr<Function2D> make_expression_function_2d(const std::string& source,
+                                                        const std::string& x, const std::string& y, bool expand) {
+    const std::vector<std::string> names = {x, y};
+    Graph graph;
+    const int root = build(graph, source, names);
+    Terms terms;
+    if (!separate(graph, root, terms, expand)) return std::make_unique<ExpressionFunction2D>(source, x, y);
+
+    // a product that occurs k times ((x+y)^2 has x*y twice) becomes one term with k times the x factor
+    std::map<std::pair<int, int>, int> count;
+    Terms merged;
+    for (const auto& t : terms) {
+        if (count[t]++ == 0) merged.push_back(t);
+    }
+    std::vector<SeparableFunction2D::Term> factors;
+    for (auto t : merged) {
+        if (count[t] > 1) t.first = graph.make(Op::Mul, t.first, graph.constant(count[t]));
+        factors.push_back({std::make_shared<ExpressionFunction>(graph.source(t.first, names), x),
+                           std::make_shared<ExpressionFunction>(graph.source(t.second, names), y)});
+    }
+    return std::make_unique<SeparableExpressionFunction2D>(source, std::move(factors), x, y);
+}
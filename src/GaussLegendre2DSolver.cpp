@@ -0,0 +1,37 @@
+#include "GaussLegendre2DSolver.h"
+#include "GaussLegendreRule.h"
+#include "TensorProduct.h"
+#include <algorithm>
+#include <vector>
+
+/*
+Implementation of the tensor-product Gauss-Legendre solver.
+∫∫ f ≈ Σ_i Σ_j wx_i wy_j f(x_i, y_j) with the composite 1D nodes / weights in each direction.
+*/
+
+GaussLegendre2DSolver::GaussLegendre2DSolver(std::size_t order, std::size_t panels_x, std::size_t panels_y,
+                                             unsigned threads, Summation summation)
+    : order_(std::min(std::max<std::size_t>(order, 1), gauss_legendre_max_order)),
+      panels_x_(panels_x ? panels_x : 1), panels_y_(panels_y ? panels_y : 1),
+      threads_(resolve_threads(threads)), summation_(summation) {}
+
+double GaussLegendre2DSolver::integrate(const Function2D& f,
+                                        double a, double b,
+                                        double c, double d) const {
+    return integrate_many({&f}, a, b, c, d)[0];
+}
+
+std::vector<double> GaussLegendre2DSolver::integrate_many(const std::vector<const Function2D*>& fs,
+                                                          double a, double b,
+                                                          double c, double d) const {
+    validate_intervals(a, b, c, d);
+    const TensorRule1D x_rule = gauss_legendre_composite_rule(order_, panels_x_, a, b);
+    const TensorRule1D y_rule = gauss_legendre_composite_rule(order_, panels_y_, c, d);
+
+    return tensor_product_sum(fs, x_rule.nodes, x_rule.weights, y_rule.nodes, y_rule.weights, threads_, summation_);
+}
+
+std::string GaussLegendre2DSolver::configuration() const {
+    return "GaussLegendre2D(order=" + std::to_string(order_) + ",panels_x=" + std::to_string(panels_x_)
+         + ",panels_y=" + std::to_string(panels_y_) + summation_suffix(summation_) + ")";
+}
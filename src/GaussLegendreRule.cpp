@@ -0,0 +1,34 @@
+#include "GaussLegendreRule.h"
+#include <stdexcept>
+
+/*
+The Gauss-Legendre table, evaluated at compile time.
+*/
+
+namespace {
+
+constexpr gauss_legendre_detail::Table table = gauss_legendre_detail::make_table();
+
+// sanity checks done by the compiler: the two point rule has nodes -+1/sqrt(3)
+// and the weights of every rule sum to the length 2 of [-1, 1]
+constexpr bool weights_sum_to_two() {
+    for (std::size_t n = 1; n <= gauss_legendre_max_order; ++n) {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < n; ++i) sum += table.weights[gauss_legendre_detail::offset(n) + i];
+        if (gauss_legendre_detail::abs(sum - 2.0) > 1e-13) return false;
+    }
+    return true;
+}
+static_assert(gauss_legendre_detail::abs(table.nodes[gauss_legendre_detail::offset(2) + 1] - 0.57735026918962576451) < 1e-16,
+              "Gauss-Legendre table: wrong 2 point rule");
+static_assert(weights_sum_to_two(), "Gauss-Legendre table: weights do not sum to 2");
+
+}
+
+GaussLegendreRule gauss_legendre_rule(std::size_t order) {
+    if (order < 1 || order > gauss_legendre_max_order) {
+        throw std::invalid_argument("Gauss-Legendre order must be in [1, 64]");
+    }
+    const std::size_t base = gauss_legendre_detail::offset(order);
+    return {table.nodes.data() + base, table.weights.data() + base, order};
+}
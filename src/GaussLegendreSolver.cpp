@@ -0,0 +1,57 @@
+#include "GaussLegendreSolver.h"
+#include "GaussLegendreRule.h"
+#include <algorithm>
+
+/*
+Implementation of the composite Gauss-Legendre solver.
+
+Panel p = [a + p*H, a + (p+1)*H], H = (b-a)/panels
+∫ f ≈ Σ_p (H/2) Σ_i w_i f(c_p + (H/2) t_i),  c_p = panel center, (t_i, w_i) the rule on [-1,1]
+*/
+
+GaussLegendreSolver::GaussLegendreSolver(std::size_t order, std::size_t panels, Summation summation)
+    : order_(std::min(std::max<std::size_t>(order, 1), gauss_legendre_max_order)),
+      panels_(panels ? panels : 1), summation_(summation) {}
+
+double GaussLegendreSolver::integrate(const Function& f, double a, double b) const {
+    return kernels::gauss_legendre(f, a, b, order_, panels_, summation_);
+}
+
+std::vector<double> GaussLegendreSolver::integrate_many(const std::vector<const Function*>& fs,
+                                                        double a, double b) const {
+    validate_interval(a, b);
+    const GaussLegendreRule rule = gauss_legendre_rule(order_);
+    const double H = (b - a) / static_cast<double>(panels_);
+    const double half = 0.5 * H;
+
+    // the nodes of all panels are numbered k = p*order + i and generated in blocks,
+    // every integrand is evaluated on the same block
+    const std::size_t count = panels_ * order_;
+    double xs[block_size];
+    double ws[block_size];
+    double fx[block_size];
+    std::vector<Accumulator> sums(fs.size(), Accumulator(summation_));
+    for (std::size_t k0 = 0; k0 < count; k0 += block_size) {
+        const std::size_t m = std::min(block_size, count - k0);
+        for (std::size_t k = 0; k < m; ++k) {
+            const std::size_t p = (k0 + k) / order_;
+            const std::size_t i = (k0 + k) % order_;
+            const double center = a + (static_cast<double>(p) + 0.5) * H;
+            xs[k] = center + half * rule.nodes[i];
+            ws[k] = rule.weights[i];
+        }
+        for (std::size_t q = 0; q < fs.size(); ++q) {
+            fs[q]->evaluate(xs, fx, m);
+            sums[q].add_products(ws, fx, m);
+        }
+    }
+    std::vector<double> result(fs.size());
+    for (std::size_t q = 0; q < fs.size(); ++q) {
+        result[q] = sums[q].sum() * half;
+    }
+    return result;
+}
+
+std::string GaussLegendreSolver::configuration() const {
+    return "GaussLegendre(order=" + std::to_string(order_) + ",panels=" + std::to_string(panels_) + summation_suffix(summation_) + ")";
+}
@@ -0,0 +1,57 @@
+#include "ImportanceMonteCarloSolver.h"
+#include "Philox.h"
+#include "RunningStats.h"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/*
+Implementation of the importance sampling Monte Carlo solver.
+
+x_i = P^-1(u_i), u_i uniform in (0,1):  Q = (1/n) Σ f(x_i) / p(x_i),  E[Q] = ∫ f
+*/
+
+ImportanceMonteCarloSolver::ImportanceMonteCarloSolver(std::size_t n, std::shared_ptr<const Proposal> proposal,
+                                                       std::uint64_t seed, unsigned threads)
+    : n_(n ? n : 1), proposal_(std::move(proposal)), seed_(seed), threads_(resolve_threads(threads)) {
+    if (!proposal_) throw std::invalid_argument("ImportanceMonteCarloSolver: proposal must not be null");
+}
+
+double ImportanceMonteCarloSolver::integrate(const Function& f, double a, double b) const {
+    return integrate_importance(f, a, b).value;
+}
+
+ImportanceMonteCarloSolver::Result ImportanceMonteCarloSolver::integrate_importance(const Function& f,
+                                                                                   double a, double b) const {
+    validate_interval(a, b);
+    const std::uint64_t actual_seed = (seed_ != 0) ? seed_ : std::random_device{}();
+    const Philox4x32 rng(actual_seed);
+    const Proposal& proposal = *proposal_;
+
+    // statistics of the weights per chunk, merged in chunk order afterwards
+    const std::size_t chunks = (n_ + chunk_size - 1) / chunk_size;
+    std::vector<RunningStats> partial(chunks);
+    parallel_chunks(n_, chunk_size, threads_, [&](std::size_t c, std::size_t begin, std::size_t end) {
+        double xs[block_size];
+        double fx[block_size];
+        for (std::size_t i = begin; i < end; i += block_size) {
+            const std::size_t m = std::min(block_size, end - i);
+            for (std::size_t k = 0; k < m; ++k) {
+                const Philox4x32::result_type r = rng(static_cast<std::uint64_t>(i + k));
+                xs[k] = proposal.inverse_cdf(Philox4x32::to_open_unit(r[0], r[1]), a, b);
+            }
+            f.evaluate(xs, fx, m);
+            for (std::size_t k = 0; k < m; ++k) {
+                partial[c].add(fx[k] / proposal.density(xs[k], a, b));
+            }
+        }
+    });
+
+    RunningStats stats;
+    for (const RunningStats& chunk : partial) {
+        stats.merge(chunk);
+    }
+    return Result{stats.mean(), stats.standard_error(), n_};
+}
@@ -0,0 +1,205 @@
+#include "InstrumentedSolver.h"
+#include <chrono>
+#include <ctime>
+#include <deque>
+#include <iomanip>
+#include <sstream>
+
+/*
+Implementation of the instrumenting solver wrappers.
+The wrapped solver runs outside the lock, only the totals are updated under it (once per call).
+*/
+
+namespace {
+
+// wall-clock and process CPU time since construction
+class Stopwatch {
+public:
+    Stopwatch() : wall_(std::chrono::steady_clock::now()), cpu_(std::clock()) {}
+
+    double wall_seconds() const {
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - wall_;
+        return elapsed.count();
+    }
+
+    double cpu_seconds() const { return static_cast<double>(std::clock() - cpu_) / CLOCKS_PER_SEC; }
+
+private:
+    std::chrono::steady_clock::time_point wall_;
+    std::clock_t cpu_;
+};
+
+double per_second(std::uint64_t evaluations, double seconds) {
+    return seconds > 0.0 ? static_cast<double>(evaluations) / seconds : 0.0;
+}
+
+// name as a JSON string, escaping quotes, backslashes and control characters
+std::string json_string(const std::string& s) {
+    std::ostringstream out;
+    out << '"';
+    for (const char c : s) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+std::string name_or_configuration(std::string name, const std::string& configuration) {
+    return name.empty() ? configuration : name;
+}
+
+}
+
+double CallStats::evaluations_per_second() const {
+    return per_second(evaluations, wall_seconds);
+}
+
+double SolverStats::evaluations_per_second() const {
+    return per_second(evaluations, wall_seconds);
+}
+
+std::string SolverStats::to_text() const {
+    std::ostringstream out;
+    out << std::setprecision(6) << (name.empty() ? "(unnamed)" : name) << ": calls=" << calls
+        << " evaluations=" << evaluations << " samples=" << samples << " wall=" << wall_seconds
+        << "s cpu=" << cpu_seconds << "s evaluations/s=" << evaluations_per_second()
+        << " last: evaluations=" << last.evaluations << " wall=" << last.wall_seconds << "s";
+    return out.str();
+}
+
+std::string SolverStats::to_json() const {
+    std::ostringstream out;
+    out << std::setprecision(9) << "{\"name\": " << json_string(name) << ", \"calls\": " << calls
+        << ", \"evaluations\": " << evaluations << ", \"samples\": " << samples
+        << ", \"wall_seconds\": " << wall_seconds << ", \"cpu_seconds\": " << cpu_seconds
+        << ", \"evaluations_per_second\": " << evaluations_per_second()
+        << ", \"last\": {\"evaluations\": " << last.evaluations << ", \"samples\": " << last.samples
+        << ", \"wall_seconds\": " << last.wall_seconds << ", \"cpu_seconds\": " << last.cpu_seconds << "}}";
+    return out.str();
+}
+
+std::string to_json(const std::vector<SolverStats>& stats) {
+    std::string out = "[";
+    for (std::size_t i = 0; i < stats.size(); ++i) {
+        out += (i ? ",\n " : "") + stats[i].to_json();
+    }
+    return out + "]";
+}
+
+void SolverInstrumentation::record(const CallStats& call) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++totals_.calls;
+    totals_.evaluations += call.evaluations;
+    totals_.samples += call.samples;
+    totals_.wall_seconds += call.wall_seconds;
+    totals_.cpu_seconds += call.cpu_seconds;
+    totals_.last = call;
+}
+
+SolverStats SolverInstrumentation::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SolverStats stats = totals_;
+    stats.name = name_;
+    return stats;
+}
+
+void SolverInstrumentation::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    totals_ = SolverStats{};
+}
+
+InstrumentedSolver::InstrumentedSolver(std::unique_ptr<Solver> solver, std::string name)
+    : solver_(std::move(solver)),
+      instrumentation_(name_or_configuration(std::move(name), solver_->configuration())) {}
+
+double InstrumentedSolver::integrate(const Function& f, double a, double b) const {
+    if (!instrumentation_.enabled()) return solver_->integrate(f, a, b);
+    return integrate_instrumented(f, a, b).value;
+}
+
+InstrumentedSolver::Result InstrumentedSolver::integrate_instrumented(const Function& f, double a, double b) const {
+    std::atomic<std::uint64_t> evaluations{0};
+    const CountingFunction counted(f, evaluations);
+    const Stopwatch watch;
+    const double value = solver_->integrate(counted, a, b);
+    const std::uint64_t n = evaluations.load();
+    const CallStats stats{n, solver_->sampling() ? n : 0, watch.wall_seconds(), watch.cpu_seconds()};
+    if (instrumentation_.enabled()) instrumentation_.record(stats);
+    return {value, stats};
+}
+
+std::vector<double> InstrumentedSolver::integrate_many(const std::vector<const Function*>& fs,
+                                                       double a, double b) const {
+    if (!instrumentation_.enabled()) return solver_->integrate_many(fs, a, b);
+    // std::deque: the counters are neither copyable nor movable
+    std::deque<std::atomic<std::uint64_t>> evaluations(fs.size());
+    std::deque<CountingFunction> counted;
+    std::vector<const Function*> wrapped;
+    for (std::size_t q = 0; q < fs.size(); ++q) {
+        counted.emplace_back(*fs[q], evaluations[q]);
+        wrapped.push_back(&counted.back());
+    }
+    const Stopwatch watch;
+    std::vector<double> result = solver_->integrate_many(wrapped, a, b);
+    const double share = fs.empty() ? 0.0 : 1.0 / static_cast<double>(fs.size());
+    const double wall = watch.wall_seconds() * share;
+    const double cpu = watch.cpu_seconds() * share;
+    for (const std::atomic<std::uint64_t>& count : evaluations) {
+        const std::uint64_t n = count.load();
+        instrumentation_.record({n, solver_->sampling() ? n : 0, wall, cpu});
+    }
+    return result;
+}
+
+InstrumentedSolver2D::InstrumentedSolver2D(std::unique_ptr<Solver2D> solver, std::string name)
+    : solver_(std::move(solver)),
+      instrumentation_(name_or_configuration(std::move(name), solver_->configuration())) {}
+
+double InstrumentedSolver2D::integrate(const Function2D& f,
+                                       double a, double b,
+                                       double c, double d) const {
+    if (!instrumentation_.enabled()) return solver_->integrate(f, a, b, c, d);
+    return integrate_instrumented(f, a, b, c, d).value;
+}
+
+InstrumentedSolver2D::Result InstrumentedSolver2D::integrate_instrumented(const Function2D& f,
+                                                                          double a, double b,
+                                                                          double c, double d) const {
+    std::atomic<std::uint64_t> evaluations{0};
+    const std::unique_ptr<Function2D> counted = counting_function(f, evaluations);
+    const Stopwatch watch;
+    const double value = solver_->integrate(*counted, a, b, c, d);
+    const std::uint64_t n = evaluations.load();
+    const CallStats stats{n, solver_->sampling() ? n : 0, watch.wall_seconds(), watch.cpu_seconds()};
+    if (instrumentation_.enabled()) instrumentation_.record(stats);
+    return {value, stats};
+}
+
+std::vector<double> InstrumentedSolver2D::integrate_many(const std::vector<const Function2D*>& fs,
+                                                         double a, double b,
+                                                         double c, double d) const {
+    if (!instrumentation_.enabled()) return solver_->integrate_many(fs, a, b, c, d);
+    std::deque<std::atomic<std::uint64_t>> evaluations(fs.size());
+    std::vector<std::unique_ptr<Function2D>> counted;
+    std::vector<const Function2D*> wrapped;
+    for (std::size_t q = 0; q < fs.size(); ++q) {
+        counted.push_back(counting_function(*fs[q], evaluations[q]));
+        wrapped.push_back(counted.back().get());
+    }
+    const Stopwatch watch;
+    std::vector<double> result = solver_->integrate_many(wrapped, a, b, c, d);
+    const double share = fs.empty() ? 0.0 : 1.0 / static_cast<double>(fs.size());
+    const double wall = watch.wall_seconds() * share;
+    const double cpu = watch.cpu_seconds() * share;
+    for (const std::atomic<std::uint64_t>& count : evaluations) {
+        const std::uint64_t n = count.load();
+        instrumentation_.record({n, solver_->sampling() ? n : 0, wall, cpu});
+    }
+    return result;
+}
@@ -0,0 +1,160 @@
+#include "LowDiscrepancy.h"
+#include "Philox.h"
+#include <algorithm>
+#include <stdexcept>
+
+/*
+Implementation of the scrambled Sobol and the shifted Halton sequence.
+*/
+
+namespace {
+
+// Joe & Kuo, "Constructing Sobol sequences with better two-dimensional projections" (2008),
+// file new-joe-kuo-6.21201: degree s, coefficients a and initial direction numbers m_1..m_s
+// of the coordinates 2..8 (coordinate 1 is the van der Corput sequence)
+struct SobolPolynomial {
+    unsigned s;
+    unsigned a;
+    std::array<std::uint32_t, 5> m;
+};
+
+constexpr SobolPolynomial sobol_polynomials[SobolSequence::max_dimensions - 1] = {
+    {1, 0, {1, 0, 0, 0, 0}},
+    {2, 1, {1, 3, 0, 0, 0}},
+    {3, 1, {1, 3, 1, 0, 0}},
+    {3, 2, {1, 1, 1, 0, 0}},
+    {4, 1, {1, 1, 3, 3, 0}},
+    {4, 4, {1, 3, 5, 13, 0}},
+    {5, 2, {1, 1, 5, 5, 17}},
+};
+
+using DirectionNumbers = std::array<std::array<std::uint32_t, 32>, SobolSequence::max_dimensions>;
+
+// v[d][k] = k-th direction number of coordinate d, scaled to 32 bits
+DirectionNumbers make_direction_numbers() {
+    DirectionNumbers v{};
+    for (unsigned k = 0; k < 32; ++k) {
+        v[0][k] = std::uint32_t(1) << (31 - k);
+    }
+    for (std::size_t d = 1; d < SobolSequence::max_dimensions; ++d) {
+        const SobolPolynomial& p = sobol_polynomials[d - 1];
+        for (unsigned k = 0; k < 32; ++k) {
+            if (k < p.s) {
+                v[d][k] = p.m[k] << (31 - k);
+                continue;
+            }
+            std::uint32_t value = v[d][k - p.s] ^ (v[d][k - p.s] >> p.s);
+            for (unsigned l = 1; l < p.s; ++l) {
+                if ((p.a >> (p.s - 1 - l)) & 1u) value ^= v[d][k - l];
+            }
+            v[d][k] = value;
+        }
+    }
+    return v;
+}
+
+const DirectionNumbers& direction_numbers() {
+    static const DirectionNumbers v = make_direction_numbers();
+    return v;
+}
+
+// index of the lowest set bit, x != 0
+unsigned trailing_zeros(std::uint32_t x) {
+    unsigned k = 0;
+    while (!(x & 1u)) {
+        x >>= 1;
+        ++k;
+    }
+    return k;
+}
+
+std::uint32_t reverse_bits(std::uint32_t x) {
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+// nested uniform scrambling (Burley, "Practical hash-based Owen scrambling", JCGT 2020):
+// on the bit-reversed value every step only propagates bits towards the more significant end,
+// so each output bit depends on the bits above it in the original value, like an Owen tree
+std::uint32_t owen_scramble(std::uint32_t x, std::uint32_t seed) {
+    x = reverse_bits(x);
+    x += seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return reverse_bits(x);
+}
+
+constexpr unsigned halton_bases[HaltonSequence::max_dimensions] = {2, 3, 5, 7, 11, 13, 17, 19};
+
+}
+
+SobolSequence::SobolSequence(std::size_t dimensions, std::uint64_t seed)
+    : dimensions_(std::min(std::max<std::size_t>(dimensions, 1), max_dimensions)) {
+    const Philox4x32 rng(seed);
+    for (std::size_t d = 0; d < max_dimensions; ++d) {
+        scramble_[d] = rng(static_cast<std::uint64_t>(d))[0];
+    }
+}
+
+void SobolSequence::generate(std::size_t dimension, std::uint64_t begin, double* out, std::size_t n) const {
+    if (dimension >= dimensions_) throw std::out_of_range("SobolSequence: dimension out of range");
+    if (begin > max_points || n > max_points - begin) {
+        throw std::out_of_range("SobolSequence: more than 2^32 points");
+    }
+    if (n == 0) return;
+    const std::array<std::uint32_t, 32>& v = direction_numbers()[dimension];
+
+    // point i is the XOR of the direction numbers selected by the bits of gray(i) = i ^ (i >> 1),
+    // the first point of the block is built directly, every further one differs in a single bit
+    const std::uint32_t first = static_cast<std::uint32_t>(begin);
+    const std::uint32_t gray = first ^ (first >> 1);
+    std::uint32_t x = 0;
+    for (unsigned k = 0; k < 32; ++k) {
+        if ((gray >> k) & 1u) x ^= v[k];
+    }
+    const std::uint32_t seed = scramble_[dimension];
+    for (std::size_t i = 0; i < n; ++i) {
+        if (i > 0) {
+            const std::uint32_t index = static_cast<std::uint32_t>(begin + i);
+            x ^= v[trailing_zeros(index)];
+        }
+        // center of the 2^-32 cell: strictly inside (0, 1)
+        out[i] = (static_cast<double>(owen_scramble(x, seed)) + 0.5) * 0x1p-32;
+    }
+}
+
+HaltonSequence::HaltonSequence(std::size_t dimensions, std::uint64_t seed)
+    : dimensions_(std::min(std::max<std::size_t>(dimensions, 1), max_dimensions)) {
+    const Philox4x32 rng(seed);
+    for (std::size_t d = 0; d < max_dimensions; ++d) {
+        const Philox4x32::result_type r = rng(static_cast<std::uint64_t>(d));
+        shift_[d] = Philox4x32::to_unit(r[0], r[1]);
+    }
+}
+
+void HaltonSequence::generate(std::size_t dimension, std::uint64_t begin, double* out, std::size_t n) const {
+    if (dimension >= dimensions_) throw std::out_of_range("HaltonSequence: dimension out of range");
+    const unsigned base = halton_bases[dimension];
+    const double inv_base = 1.0 / base;
+    const double shift = shift_[dimension];
+    for (std::size_t i = 0; i < n; ++i) {
+        // radical inverse of index + 1 (index 0 would be the point 0 before the shift)
+        std::uint64_t index = begin + i + 1;
+        double r = 0.0;
+        double scale = inv_base;
+        while (index > 0) {
+            r += static_cast<double>(index % base) * scale;
+            index /= base;
+            scale *= inv_base;
+        }
+        double u = r + shift;
+        if (u >= 1.0) u -= 1.0;
+        // the shifted point can round to exactly 0, keep it inside (0, 1)
+        out[i] = (u > 0.0) ? u : 0x1p-53;
+    }
+}
@@ -0,0 +1,81 @@
+#include "MappedFile.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+Implementation of the read-only file mapping.
+*/
+
+namespace {
+
+std::runtime_error map_error(const std::string& path, const char* what) {
+    return std::runtime_error("cannot map \"" + path + "\": " + what);
+}
+
+}
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path) : path_(path) {
+    const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) throw map_error(path, "cannot open file");
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw map_error(path, "cannot read file size");
+    }
+    size_ = static_cast<std::size_t>(size.QuadPart);
+    if (size_ == 0) {
+        CloseHandle(file);
+        return;
+    }
+    // the view keeps the mapping and the file alive, the handles can be closed right away
+    const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) throw map_error(path, "CreateFileMapping failed");
+    data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+    if (!data_) throw map_error(path, "MapViewOfFile failed");
+}
+
+MappedFile::~MappedFile() {
+    if (data_) UnmapViewOfFile(data_);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) : path_(path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw map_error(path, "cannot open file");
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        close(fd);
+        throw map_error(path, "cannot read file size");
+    }
+    size_ = static_cast<std::size_t>(status.st_size);
+    if (size_ == 0) {
+        close(fd);
+        return;
+    }
+    // the mapping keeps the file alive, the descriptor can be closed right away
+    void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) throw map_error(path, "mmap failed");
+    posix_madvise(p, size_, POSIX_MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(p);
+}
+
+MappedFile::~MappedFile() {
+    if (data_) munmap(const_cast<char*>(data_), size_);
+}
+
+#endif
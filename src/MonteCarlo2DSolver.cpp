@@ -1,9 +1,26 @@
 #include "MonteCarlo2DSolver.h"
+#include "Philox.h"
+#include "RunningStats.h"
+#include <algorithm>
+#include <cmath>
 #include <random>
+#include <vector>
 
 /*
 Implementation of the Monte Carlo solver for 2D functions.
 */
+
+namespace {
+
+// the standard error is not trusted before this many samples
+constexpr std::size_t min_streaming_samples = 1024;
+
+// Parallel streaming: one round = streaming_round_chunks chunks of streaming_chunk samples,
+// fixed sizes so the stopping point does not depend on the thread count
+constexpr std::size_t streaming_chunk = 1024;
+constexpr std::size_t streaming_round_chunks = 64;
+
+}
 double MonteCarlo2DSolver::integrate(const Function2D& f,
                                      double a, double b,
                                      double c, double d) const {
@@ -13,19 +30,163 @@ double MonteCarlo2DSolver::integrate(const Function2D& f,
     
     
     const std::uint64_t actual_seed = (seed_ != 0) ? seed_ : std::random_device{}();
-    std::mt19937_64 rng(actual_seed);
+
+    const double sum = (mode_ == Mode::Parallel)
+        ? integrate_parallel(f, a, b, c, d, actual_seed)
+        : integrate_sequential(f, a, b, c, d, actual_seed);
+    
+    double area = (b - a) * (d - c);
+    return area * sum / static_cast<double>(n_);
+}
+
+// sum of f over n_ samples from one mt19937_64 stream
+double MonteCarlo2DSolver::integrate_sequential(const Function2D& f, double a, double b,
+                                                double c, double d, std::uint64_t seed) const {
+    std::mt19937_64 rng(seed);
     std::uniform_real_distribution<double> dist_x(a, b);
     std::uniform_real_distribution<double> dist_y(c, d);
     
-    double sum = 0.0;
+    Accumulator sum(summation_);
     // sample points from the 2d interval
     // evaluate the function at these points and calculate the average
-    for (std::size_t i = 0; i < n_; ++i) {
-        double x = dist_x(rng);
-        double y = dist_y(rng);
-        sum += f(x, y);
+    // points are drawn in blocks and evaluated with one call per block
+    double xs[block_size];
+    double ys[block_size];
+    double fxy[block_size];
+    for (std::size_t i = 0; i < n_; i += block_size) {
+        const std::size_t m = std::min(block_size, n_ - i);
+        for (std::size_t k = 0; k < m; ++k) {
+            xs[k] = dist_x(rng);
+            ys[k] = dist_y(rng);
+        }
+        f.evaluate(xs, ys, fxy, m);
+        sum.add(fxy, m);
     }
-    
-    double area = (b - a) * (d - c);
-    return area * sum / static_cast<double>(n_);
-}
\ No newline at end of file
+    return sum.sum();
+}
+
+// sum of f over n_ samples, both coordinates of sample i come from the Philox counter (seed, i)
+// the sample indices are split into fixed chunks, see parallel_sum
+double MonteCarlo2DSolver::integrate_parallel(const Function2D& f, double a, double b,
+                                              double c, double d, std::uint64_t seed) const {
+    const Philox4x32 rng(seed);
+    const double width_x = b - a;
+    const double width_y = d - c;
+
+    return parallel_sum(n_, chunk_size, threads_, [&](std::size_t begin, std::size_t end) {
+        double xs[block_size];
+        double ys[block_size];
+        double fxy[block_size];
+        Accumulator chunk(summation_);
+        for (std::size_t i = begin; i < end; i += block_size) {
+            const std::size_t m = std::min(block_size, end - i);
+            for (std::size_t k = 0; k < m; ++k) {
+                const Philox4x32::result_type r = rng(static_cast<std::uint64_t>(i + k));
+                xs[k] = a + width_x * Philox4x32::to_unit(r[0], r[1]);
+                ys[k] = c + width_y * Philox4x32::to_unit(r[2], r[3]);
+            }
+            f.evaluate(xs, ys, fxy, m);
+            chunk.add(fxy, m);
+        }
+        return chunk.sum();
+    });
+}
+
+MonteCarlo2DSolver::Result MonteCarlo2DSolver::integrate_streaming(const Function2D& f,
+                                                                  double a, double b,
+                                                                  double c, double d,
+                                                                  double abs_tol, double rel_tol) const {
+    validate_intervals(a, b, c, d);
+    const std::uint64_t actual_seed = (seed_ != 0) ? seed_ : std::random_device{}();
+    return (mode_ == Mode::Parallel)
+        ? streaming_parallel(f, a, b, c, d, abs_tol, rel_tol, actual_seed)
+        : streaming_sequential(f, a, b, c, d, abs_tol, rel_tol, actual_seed);
+}
+
+// same stream as integrate_sequential, the statistics are checked after every block
+MonteCarlo2DSolver::Result MonteCarlo2DSolver::streaming_sequential(const Function2D& f, double a, double b,
+                                                                   double c, double d,
+                                                                   double abs_tol, double rel_tol,
+                                                                   std::uint64_t seed) const {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> dist_x(a, b);
+    std::uniform_real_distribution<double> dist_y(c, d);
+    const double area = (b - a) * (d - c);
+
+    double xs[block_size];
+    double ys[block_size];
+    double fxy[block_size];
+    RunningStats stats;
+    Result result{0.0, 0.0, 0, false};
+    for (std::size_t i = 0; i < n_ && !result.converged; i += block_size) {
+        const std::size_t m = std::min(block_size, n_ - i);
+        for (std::size_t k = 0; k < m; ++k) {
+            xs[k] = dist_x(rng);
+            ys[k] = dist_y(rng);
+        }
+        f.evaluate(xs, ys, fxy, m);
+        for (std::size_t k = 0; k < m; ++k) {
+            stats.add(fxy[k]);
+        }
+        result.value = area * stats.mean();
+        result.error = area * stats.standard_error();
+        result.converged = stats.count() >= min_streaming_samples
+                        && result.error <= std::max(abs_tol, rel_tol * std::abs(result.value));
+    }
+    result.samples = stats.count();
+    return result;
+}
+
+// same samples as integrate_parallel, drawn in rounds of fixed chunks;
+// the per-chunk statistics are merged in chunk order after every round
+MonteCarlo2DSolver::Result MonteCarlo2DSolver::streaming_parallel(const Function2D& f, double a, double b,
+                                                                 double c, double d,
+                                                                 double abs_tol, double rel_tol,
+                                                                 std::uint64_t seed) const {
+    const Philox4x32 rng(seed);
+    const double width_x = b - a;
+    const double width_y = d - c;
+    const double area = width_x * width_y;
+
+    RunningStats stats;
+    std::vector<RunningStats> chunk_stats(streaming_round_chunks);
+    Result result{0.0, 0.0, 0, false};
+    for (std::size_t start = 0; start < n_ && !result.converged;
+         start += streaming_round_chunks * streaming_chunk) {
+        const std::size_t count = std::min(streaming_round_chunks * streaming_chunk, n_ - start);
+        std::fill(chunk_stats.begin(), chunk_stats.end(), RunningStats());
+        parallel_chunks(count, streaming_chunk, threads_, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+            double xs[block_size];
+            double ys[block_size];
+            double fxy[block_size];
+            for (std::size_t i = start + begin; i < start + end; i += block_size) {
+                const std::size_t m = std::min(block_size, start + end - i);
+                for (std::size_t k = 0; k < m; ++k) {
+                    const Philox4x32::result_type r = rng(static_cast<std::uint64_t>(i + k));
+                    xs[k] = a + width_x * Philox4x32::to_unit(r[0], r[1]);
+                    ys[k] = c + width_y * Philox4x32::to_unit(r[2], r[3]);
+                }
+                f.evaluate(xs, ys, fxy, m);
+                for (std::size_t k = 0; k < m; ++k) {
+                    chunk_stats[chunk].add(fxy[k]);
+                }
+            }
+        });
+        for (const RunningStats& partial : chunk_stats) {
+            stats.merge(partial);
+        }
+        result.value = area * stats.mean();
+        result.error = area * stats.standard_error();
+        result.converged = stats.count() >= min_streaming_samples
+                        && result.error <= std::max(abs_tol, rel_tol * std::abs(result.value));
+    }
+    result.samples = stats.count();
+    return result;
+}
+
+std::string MonteCarlo2DSolver::configuration() const {
+    // seed 0 draws a new random seed on every call, the result is not reproducible
+    if (seed_ == 0) return std::string();
+    return "MonteCarlo2D(n=" + std::to_string(n_) + ",seed=" + std::to_string(seed_)
+         + (mode_ == Mode::Parallel ? ",mode=parallel" : ",mode=sequential") + summation_suffix(summation_) + ")";
+}
@@ -1,21 +1,40 @@
 #include "MonteCarloSolver.h"
+#include "ParallelSum.h"
+#include "Philox.h"
+#include "RunningStats.h"
+#include <cmath>
+#include <algorithm>
 #include <random>
 #include <stdexcept>
 #include <limits>
+#include <vector>
 
 
 /*
 Implementation of the Monte Carlo solver for 1d functions.
 */
 
+namespace {
+
+// the standard error is not trusted before this many samples
+constexpr std::size_t min_streaming_samples = 1024;
+
+// Parallel streaming: one round = streaming_round_chunks chunks of streaming_chunk samples,
+// fixed sizes so the stopping point does not depend on the thread count
+constexpr std::size_t streaming_chunk = 1024;
+constexpr std::size_t streaming_round_chunks = 64;
+
+}
+
 /*
 // 2D Monte Carlo Integration
 // Sample (Xᵢ,Yᵢ) ~ Uniform([a,b]×[c,d]), then:
 // Area · (1/n)·Σf(Xᵢ,Yᵢ) → ∫∫f(x,y)dydx
 // Key advantage: error O(n^(-1/2)) regardless of dimension
 */
-MonteCarloSolver::MonteCarloSolver(std::size_t n, std::uint64_t seed)
-    : n_(n ? n : 1), seed_(seed) {}
+MonteCarloSolver::MonteCarloSolver(std::size_t n, std::uint64_t seed, Mode mode, unsigned threads,
+                                   Summation summation)
+    : n_(n ? n : 1), seed_(seed), mode_(mode), threads_(resolve_threads(threads)), summation_(summation) {}
 
 // integrate method
 double MonteCarloSolver::integrate(const Function& f, double a, double b) const {
@@ -23,17 +42,96 @@ double MonteCarloSolver::integrate(const Function& f, double a, double b) const
 
     // choose seed: if user provided seed_ != 0, use it; otherwise use random_device
     const std::uint64_t actual_seed = (seed_ != 0) ? seed_ : std::random_device{}();
-    std::mt19937_64 rng(actual_seed);
+
+    return (mode_ == Mode::Parallel)
+        ? kernels::monte_carlo_parallel(f, a, b, n_, actual_seed, threads_, summation_)
+        : kernels::monte_carlo(f, a, b, n_, actual_seed, summation_);
+}
+
+MonteCarloSolver::Result MonteCarloSolver::integrate_streaming(const Function& f, double a, double b,
+                                                              double abs_tol, double rel_tol) const {
+    validate_interval(a, b);
+    const std::uint64_t actual_seed = (seed_ != 0) ? seed_ : std::random_device{}();
+    return (mode_ == Mode::Parallel)
+        ? streaming_parallel(f, a, b, abs_tol, rel_tol, actual_seed)
+        : streaming_sequential(f, a, b, abs_tol, rel_tol, actual_seed);
+}
+
+// same stream as kernels::monte_carlo, the statistics are checked after every block
+MonteCarloSolver::Result MonteCarloSolver::streaming_sequential(const Function& f, double a, double b,
+                                                               double abs_tol, double rel_tol,
+                                                               std::uint64_t seed) const {
+    std::mt19937_64 rng(seed);
     std::uniform_real_distribution<double> dist(a, b);
+    const double width = b - a;
+
+    double xs[block_size];
+    double fx[block_size];
+    RunningStats stats;
+    Result result{0.0, 0.0, 0, false};
+    for (std::size_t i = 0; i < n_ && !result.converged; i += block_size) {
+        const std::size_t m = std::min(block_size, n_ - i);
+        for (std::size_t k = 0; k < m; ++k) {
+            xs[k] = dist(rng);
+        }
+        f.evaluate(xs, fx, m);
+        for (std::size_t k = 0; k < m; ++k) {
+            stats.add(fx[k]);
+        }
+        result.value = width * stats.mean();
+        result.error = width * stats.standard_error();
+        result.converged = stats.count() >= min_streaming_samples
+                        && result.error <= std::max(abs_tol, rel_tol * std::abs(result.value));
+    }
+    result.samples = stats.count();
+    return result;
+}
 
-    // sample points from the interval and evaluate the function, finally compute the average
-    // accumulate in double; for very large n you might want a compensated sum.
-    double sum = 0.0;
-    for (std::size_t i = 0; i < n_; ++i) {
-        const double x = dist(rng);
-        sum += f(x);
+// same samples as kernels::monte_carlo_parallel (sample i from the Philox counter (seed, i)), drawn in rounds
+// of fixed chunks; the per-chunk statistics are merged in chunk order after every round
+MonteCarloSolver::Result MonteCarloSolver::streaming_parallel(const Function& f, double a, double b,
+                                                             double abs_tol, double rel_tol,
+                                                             std::uint64_t seed) const {
+    const Philox4x32 rng(seed);
+    const double width = b - a;
+
+    RunningStats stats;
+    std::vector<RunningStats> chunk_stats(streaming_round_chunks);
+    Result result{0.0, 0.0, 0, false};
+    for (std::size_t start = 0; start < n_ && !result.converged;
+         start += streaming_round_chunks * streaming_chunk) {
+        const std::size_t count = std::min(streaming_round_chunks * streaming_chunk, n_ - start);
+        std::fill(chunk_stats.begin(), chunk_stats.end(), RunningStats());
+        parallel_chunks(count, streaming_chunk, threads_, [&](std::size_t c, std::size_t begin, std::size_t end) {
+            double xs[block_size];
+            double fx[block_size];
+            for (std::size_t i = start + begin; i < start + end; i += block_size) {
+                const std::size_t m = std::min(block_size, start + end - i);
+                for (std::size_t k = 0; k < m; ++k) {
+                    const Philox4x32::result_type r = rng(static_cast<std::uint64_t>(i + k));
+                    xs[k] = a + width * Philox4x32::to_unit(r[0], r[1]);
+                }
+                f.evaluate(xs, fx, m);
+                for (std::size_t k = 0; k < m; ++k) {
+                    chunk_stats[c].add(fx[k]);
+                }
+            }
+        });
+        for (const RunningStats& chunk : chunk_stats) {
+            stats.merge(chunk);
+        }
+        result.value = width * stats.mean();
+        result.error = width * stats.standard_error();
+        result.converged = stats.count() >= min_streaming_samples
+                        && result.error <= std::max(abs_tol, rel_tol * std::abs(result.value));
     }
+    result.samples = stats.count();
+    return result;
+}
 
-    const double factor = (b - a) / static_cast<double>(n_);
-    return factor * sum;
+std::string MonteCarloSolver::configuration() const {
+    // seed 0 draws a new random seed on every call, the result is not reproducible
+    if (seed_ == 0) return std::string();
+    return "MonteCarlo(n=" + std::to_string(n_) + ",seed=" + std::to_string(seed_)
+         + (mode_ == Mode::Parallel ? ",mode=parallel" : ",mode=sequential") + summation_suffix(summation_) + ")";
 }
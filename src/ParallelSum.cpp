@@ -0,0 +1,178 @@
+#include "ParallelSum.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+Implementation of the deterministic chunked parallel sum.
+*/
+
+unsigned resolve_threads(unsigned requested) {
+    if (requested != 0) return requested;
+    const unsigned hw = std::thread::hardware_concurrency();
+    return hw ? hw : 1;
+}
+
+namespace {
+
+// one parallel_chunks call: its chunks are claimed by the caller and by pool workers through `next`
+struct Job {
+    const std::function<void(std::size_t, std::size_t, std::size_t)>* work;
+    std::size_t count;
+    std::size_t chunk_size;
+    std::size_t chunks;
+    std::size_t max_helpers;        // threads - 1
+    std::atomic<std::size_t> next{0};
+    std::size_t helpers = 0;        // pool workers currently in the job, guarded by the pool mutex
+    std::exception_ptr error;       // first exception of a chunk, guarded by error_mutex
+    std::mutex error_mutex;
+
+    // claims and runs chunks until none are left, an exception stops the remaining chunks
+    void run() {
+        for (std::size_t c = next++; c < chunks; c = next++) {
+            const std::size_t begin = c * chunk_size;
+            const std::size_t end = std::min(begin + chunk_size, count);
+            try {
+                (*work)(c, begin, end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) error = std::current_exception();
+                next = chunks;
+            }
+        }
+    }
+};
+
+// Worker threads shared by every parallel_chunks call of the process, started on first use and
+// grown on demand up to the largest thread count requested, so an integration does not pay for
+// creating and joining threads. The caller of parallel_chunks always works on its own job, the
+// workers only help: a job never waits for a worker that has not started on it, which keeps
+// nested calls (a chunk that calls parallel_chunks again) and concurrent callers deadlock free.
+class ThreadPool {
+public:
+    static ThreadPool& instance() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        work_available_.notify_all();
+        for (std::thread& t : workers_) {
+            t.join();
+        }
+    }
+
+    void run(Job& job) {
+        if (job.max_helpers > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            while (workers_.size() < job.max_helpers) {
+                workers_.emplace_back([this] { work(); });
+            }
+            jobs_.push_back(&job);
+        }
+        if (job.max_helpers > 1) {
+            work_available_.notify_all();
+        } else if (job.max_helpers == 1) {
+            work_available_.notify_one();
+        }
+
+        job.run();
+
+        if (job.max_helpers > 0) {
+            // no worker can join once the job is out of the list, wait for the ones inside
+            std::unique_lock<std::mutex> lock(mutex_);
+            jobs_.erase(std::find(jobs_.begin(), jobs_.end(), &job));
+            job_left_.wait(lock, [&] { return job.helpers == 0; });
+        }
+    }
+
+private:
+    ThreadPool() = default;
+
+    // a listed job with unclaimed chunks and a free helper slot, nullptr if there is none
+    Job* find_job() {
+        for (Job* job : jobs_) {
+            if (job->helpers < job->max_helpers && job->next.load() < job->chunks) return job;
+        }
+        return nullptr;
+    }
+
+    void work() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            Job* job = nullptr;
+            work_available_.wait(lock, [&] { return stop_ || (job = find_job()) != nullptr; });
+            if (stop_) return;
+            ++job->helpers;
+            lock.unlock();
+            job->run();
+            lock.lock();
+            --job->helpers;
+            job_left_.notify_all();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable job_left_;
+    std::vector<Job*> jobs_;
+    std::vector<std::thread> workers_;
+    bool stop_ = false;
+};
+
+}
+
+void parallel_chunks(std::size_t count, std::size_t chunk_size, unsigned threads,
+                     const std::function<void(std::size_t, std::size_t, std::size_t)>& chunk_work) {
+    if (count == 0) return;
+    Job job;
+    job.work = &chunk_work;
+    job.count = count;
+    job.chunk_size = std::max<std::size_t>(chunk_size, 1);
+    job.chunks = (count + job.chunk_size - 1) / job.chunk_size;
+    // the calling thread works too, only ask for helpers if there is more than one chunk
+    job.max_helpers = std::min<std::size_t>(resolve_threads(threads), job.chunks) - 1;
+
+    ThreadPool::instance().run(job);
+    if (job.error) std::rethrow_exception(job.error);
+}
+
+std::vector<double> parallel_sum(std::size_t count, std::size_t chunk_size, unsigned threads, std::size_t width,
+                                 const std::function<void(std::size_t, std::size_t, double*)>& chunk_sum) {
+    std::vector<double> total(width, 0.0);
+    if (count == 0 || width == 0) return total;
+    chunk_size = std::max<std::size_t>(chunk_size, 1);
+    const std::size_t chunks = (count + chunk_size - 1) / chunk_size;
+
+    // one row of `width` slots per chunk, the row a chunk writes to does not depend on the thread computing it
+    std::vector<double> partial(chunks * width, 0.0);
+    parallel_chunks(count, chunk_size, threads, [&](std::size_t c, std::size_t begin, std::size_t end) {
+        chunk_sum(begin, end, partial.data() + c * width);
+    });
+
+    // combine neighbours pairwise until one row is left: fixed tree, fixed rounding
+    for (std::size_t stride = 1; stride < chunks; stride *= 2) {
+        for (std::size_t i = 0; i + stride < chunks; i += 2 * stride) {
+            for (std::size_t q = 0; q < width; ++q) {
+                partial[i * width + q] += partial[(i + stride) * width + q];
+            }
+        }
+    }
+    std::copy(partial.begin(), partial.begin() + width, total.begin());
+    return total;
+}
+
+double parallel_sum(std::size_t count, std::size_t chunk_size, unsigned threads,
+                    const std::function<double(std::size_t, std::size_t)>& chunk_sum) {
+    return parallel_sum(count, chunk_size, threads, 1, [&](std::size_t begin, std::size_t end, double* partial) {
+        partial[0] = chunk_sum(begin, end);
+    })[0];
+}
@@ -0,0 +1,39 @@
+#include "Proposal.h"
+#include <cmath>
+#include <stdexcept>
+
+/*
+Implementation of the built-in proposal densities.
+*/
+
+PowerLawProposal::PowerLawProposal(double alpha) : alpha_(alpha) {
+    if (!(alpha > 0.0) || !std::isfinite(alpha)) {
+        throw std::invalid_argument("PowerLawProposal: require alpha > 0");
+    }
+}
+
+double PowerLawProposal::density(double x, double a, double b) const {
+    const double L = b - a;
+    return alpha_ * std::pow(x - a, alpha_ - 1.0) / std::pow(L, alpha_);
+}
+
+// CDF(x) = ((x-a)/(b-a))^alpha
+double PowerLawProposal::inverse_cdf(double u, double a, double b) const {
+    return a + (b - a) * std::pow(u, 1.0 / alpha_);
+}
+
+ExponentialProposal::ExponentialProposal(double rate) : rate_(rate) {
+    if (rate == 0.0 || !std::isfinite(rate)) {
+        throw std::invalid_argument("ExponentialProposal: require a finite rate != 0");
+    }
+}
+
+double ExponentialProposal::density(double x, double a, double b) const {
+    // -expm1(-rate L) = 1 - e^(-rate L), accurate for small rate L
+    return rate_ * std::exp(-rate_ * (x - a)) / -std::expm1(-rate_ * (b - a));
+}
+
+// CDF(x) = (1 - e^(-rate (x-a))) / (1 - e^(-rate (b-a)))
+double ExponentialProposal::inverse_cdf(double u, double a, double b) const {
+    return a - std::log1p(u * std::expm1(-rate_ * (b - a))) / rate_;
+}
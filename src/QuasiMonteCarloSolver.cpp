@@ -0,0 +1,114 @@
+#include "QuasiMonteCarloSolver.h"
+#include "LowDiscrepancy.h"
+#include "Philox.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+/*
+Implementation of the randomized quasi-Monte Carlo solver for 1d functions.
+
+Replicate r integrates with the sequence randomized by seed_r = Philox(seed)(r):
+    Q_r = (b-a)/n · Σ_i f(a + (b-a) u_i^(r))
+value = mean of the Q_r, error = sqrt(Σ (Q_r - value)^2 / (R (R-1)))
+*/
+
+namespace {
+
+// per-replicate sums Σ_i f(a + width * u_i), the points are split into fixed chunks,
+// see parallel_sum, so the result does not depend on the thread count
+template <class Sequence>
+std::vector<double> replicate_sums(const Function& f, double a, double width, std::size_t n,
+                                   const std::vector<Sequence>& sequences, std::size_t block_size,
+                                   std::size_t chunk_size, unsigned threads, Summation summation) {
+    const std::size_t replicates = sequences.size();
+    return parallel_sum(n, chunk_size, threads, replicates,
+        [&](std::size_t begin, std::size_t end, double* chunk) {
+            std::vector<double> xs(block_size);
+            std::vector<double> fx(block_size);
+            std::vector<Accumulator> sums(replicates, Accumulator(summation));
+            for (std::size_t r = 0; r < replicates; ++r) {
+                for (std::size_t i = begin; i < end; i += block_size) {
+                    const std::size_t m = std::min(block_size, end - i);
+                    sequences[r].generate(0, i, xs.data(), m);
+                    for (std::size_t k = 0; k < m; ++k) {
+                        xs[k] = a + width * xs[k];
+                    }
+                    f.evaluate(xs.data(), fx.data(), m);
+                    sums[r].add(fx.data(), m);
+                }
+            }
+            for (std::size_t r = 0; r < replicates; ++r) {
+                chunk[r] = sums[r].sum();
+            }
+        });
+}
+
+}
+
+QuasiMonteCarloSolver::QuasiMonteCarloSolver(std::size_t n, std::size_t replicates, std::uint64_t seed,
+                                             Sequence sequence, unsigned threads,
+                                             Summation summation)
+    : n_(n ? n : 1), replicates_(std::max<std::size_t>(replicates, 2)), seed_(seed),
+      sequence_(sequence), threads_(resolve_threads(threads)), summation_(summation) {
+    if (sequence_ == Sequence::Sobol && n_ > SobolSequence::max_points) {
+        throw std::invalid_argument("QuasiMonteCarloSolver: at most 2^32 Sobol points per replicate");
+    }
+}
+
+double QuasiMonteCarloSolver::integrate(const Function& f, double a, double b) const {
+    return integrate_qmc(f, a, b).value;
+}
+
+QuasiMonteCarloSolver::Result QuasiMonteCarloSolver::integrate_qmc(const Function& f, double a, double b) const {
+    validate_interval(a, b);
+
+    // choose seed like MonteCarloSolver: seed_ != 0 is used as is, otherwise random_device
+    const std::uint64_t actual_seed = (seed_ != 0) ? seed_ : std::random_device{}();
+    const Philox4x32 rng(actual_seed);
+    auto replicate_seed = [&](std::size_t r) {
+        const Philox4x32::result_type w = rng(static_cast<std::uint64_t>(r));
+        return (static_cast<std::uint64_t>(w[0]) << 32) | w[1];
+    };
+
+    const double width = b - a;
+    std::vector<double> sums;
+    if (sequence_ == Sequence::Sobol) {
+        std::vector<SobolSequence> sequences;
+        for (std::size_t r = 0; r < replicates_; ++r) sequences.emplace_back(1, replicate_seed(r));
+        sums = replicate_sums(f, a, width, n_, sequences, block_size, chunk_size, threads_, summation_);
+    } else {
+        std::vector<HaltonSequence> sequences;
+        for (std::size_t r = 0; r < replicates_; ++r) sequences.emplace_back(1, replicate_seed(r));
+        sums = replicate_sums(f, a, width, n_, sequences, block_size, chunk_size, threads_, summation_);
+    }
+
+    const double R = static_cast<double>(replicates_);
+    double mean = 0.0;
+    for (double& s : sums) {
+        s *= width / static_cast<double>(n_);
+        mean += s;
+    }
+    mean /= R;
+    double squares = 0.0;
+    for (double s : sums) {
+        squares += (s - mean) * (s - mean);
+    }
+
+    Result result;
+    result.value = mean;
+    result.error = std::sqrt(squares / (R * (R - 1.0)));
+    result.evaluations = n_ * replicates_;
+    result.replicates = replicates_;
+    return result;
+}
+
+std::string QuasiMonteCarloSolver::configuration() const {
+    // seed 0 draws a new random seed on every call, the result is not reproducible
+    if (seed_ == 0) return std::string();
+    return "QuasiMonteCarlo(n=" + std::to_string(n_) + ",replicates=" + std::to_string(replicates_)
+         + ",seed=" + std::to_string(seed_)
+         + (sequence_ == Sequence::Sobol ? ",sequence=sobol" : ",sequence=halton") + summation_suffix(summation_) + ")";
+}
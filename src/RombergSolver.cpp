@@ -0,0 +1,75 @@
+#include "RombergSolver.h"
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/*
+Implementation of the Romberg solver.
+
+Trapezoid sequence: T(0) = (b-a)/2 * (f(a) + f(b)),
+                    T(k) = T(k-1)/2 + h_k * Σ f(a + (2i-1) h_k),  h_k = (b-a)/2^k, i = 1..2^(k-1)
+Richardson extrapolation: R(k,j) = R(k,j-1) + (R(k,j-1) - R(k-1,j-1)) / (4^j - 1)
+Error of R(k,j): O(h_k^(2j+2)) for smooth integrands
+*/
+
+double RombergSolver::integrate(const Function& f, double a, double b) const {
+    return integrate_romberg(f, a, b).value;
+}
+
+RombergSolver::Result RombergSolver::integrate_romberg(const Function& f, double a, double b) const {
+    validate_interval(a, b);
+
+    // only the previous and the current row of the Romberg table are kept
+    std::vector<double> previous{0.5 * (b - a) * (f(a) + f(b))};
+    std::vector<double> current;
+    std::size_t evaluations = 2;
+
+    double xs[block_size];
+    double fx[block_size];
+
+    for (std::size_t k = 1; k <= max_levels_; ++k) {
+        // new midpoints of level k
+        const std::size_t count = std::size_t{1} << (k - 1);
+        const double h = (b - a) / static_cast<double>(2 * count);
+        Accumulator mid(summation_);
+        for (std::size_t i = 0; i < count; i += block_size) {
+            const std::size_t m = std::min(block_size, count - i);
+            for (std::size_t j = 0; j < m; ++j) {
+                xs[j] = a + static_cast<double>(2 * (i + j) + 1) * h;
+            }
+            f.evaluate(xs, fx, m);
+            mid.add(fx, m);
+        }
+        evaluations += count;
+
+        // Richardson extrapolation along the row
+        current.assign(k + 1, 0.0);
+        current[0] = 0.5 * previous[0] + h * mid.sum();
+        double factor = 1.0;
+        for (std::size_t j = 1; j <= k; ++j) {
+            factor *= 4.0;
+            current[j] = current[j - 1] + (current[j - 1] - previous[j - 1]) / (factor - 1.0);
+        }
+
+        // compare successive diagonal entries, the first levels are too coarse to be trusted
+        const double error = std::abs(current[k] - previous[k - 1]);
+        if (k >= 3 && error <= std::max(abs_tol_, rel_tol_ * std::abs(current[k]))) {
+            return {current[k], error, evaluations, k, true};
+        }
+        if (k == max_levels_) {
+            return {current[k], error, evaluations, k, false};
+        }
+        previous.swap(current);
+    }
+    // not reached, max_levels_ >= 1
+    return {previous.back(), 0.0, evaluations, 0, false};
+}
+
+std::string RombergSolver::configuration() const {
+    std::ostringstream out;
+    out << std::setprecision(17) << "Romberg(abs_tol=" << abs_tol_ << ",rel_tol=" << rel_tol_
+        << ",max_levels=" << max_levels_ << summation_suffix(summation_) << ")";
+    return out.str();
+}
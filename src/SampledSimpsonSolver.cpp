@@ -0,0 +1,113 @@
+#include "SampledSimpsonSolver.h"
+#include "IntegrationKernels.h"
+#include "TensorProduct.h"
+#include <algorithm>
+#include <stdexcept>
+
+/*
+Implementation of the Simpson rule on tabulated samples.
+*/
+
+namespace {
+
+std::invalid_argument not_increasing(std::size_t i) {
+    return std::invalid_argument("samples: nodes must be strictly increasing, x[" + std::to_string(i)
+                                 + "] >= x[" + std::to_string(i + 1) + "]");
+}
+
+}
+
+double SampledSimpsonSolver::integrate(const Samples1D& samples) const {
+    const std::size_t n = samples.count() - 1;
+
+    // one interval: trapezoid
+    if (n == 1) {
+        const double h = samples.uniform() ? samples.b() - samples.a() : samples.node(1) - samples.node(0);
+        if (!(h > 0.0)) throw not_increasing(0);
+        return 0.5 * h * (samples.value(0) + samples.value(1));
+    }
+    // Simpson on the first even number of intervals, an odd last one is added separately
+    const std::size_t even_n = n - n % 2;
+
+    if (samples.uniform()) {
+        // interior samples i = 1..even_n-1, weight 4 at odd and 2 at even indices,
+        // in the chunks and blocks of kernels::simpson
+        const double h = samples.h();
+        const double interior = parallel_sum(even_n - 1, kernels::chunk_size, threads_, [&](std::size_t begin, std::size_t end) {
+            double buffer[kernels::block_size];
+            double odd[kernels::block_size / 2];
+            double even[kernels::block_size / 2];
+            Accumulator s_odd(summation_);
+            Accumulator s_even(summation_);
+            for (std::size_t j = begin; j < end; j += kernels::block_size) {
+                const std::size_t m = std::min(kernels::block_size, end - j);
+                const double* f = samples.values(j + 1, m, buffer);
+                // j is even, so sample index j + k + 1 is odd for even k
+                for (std::size_t k = 0; k < m; ++k) {
+                    (k % 2 == 0 ? odd : even)[k / 2] = f[k];
+                }
+                s_odd.add(odd, (m + 1) / 2);
+                s_even.add(even, m / 2);
+            }
+            return 4.0 * s_odd.sum() + 2.0 * s_even.sum();
+        });
+        double s = samples.value(0) + samples.value(even_n);
+        s += interior;
+        double result = s * (h / 3.0);
+        if (n != even_n) {
+            result += (h / 12.0) * (5.0 * samples.value(n) + 8.0 * samples.value(n - 1) - samples.value(n - 2));
+        }
+        return result;
+    }
+
+    // pairs of intervals p = 0..even_n/2-1 on the samples 2p, 2p+1, 2p+2
+    const double sum = parallel_sum(even_n / 2, kernels::chunk_size, threads_, [&](std::size_t begin, std::size_t end) {
+        double x_buffer[2 * kernels::block_size + 1];
+        double f_buffer[2 * kernels::block_size + 1];
+        double terms[kernels::block_size];
+        Accumulator chunk(summation_);
+        for (std::size_t p = begin; p < end; p += kernels::block_size) {
+            const std::size_t m = std::min(kernels::block_size, end - p);
+            const double* x = samples.nodes(2 * p, 2 * m + 1, x_buffer);
+            const double* f = samples.values(2 * p, 2 * m + 1, f_buffer);
+            for (std::size_t k = 0; k < m; ++k) {
+                const double h0 = x[2 * k + 1] - x[2 * k];
+                const double h1 = x[2 * k + 2] - x[2 * k + 1];
+                if (!(h0 > 0.0)) throw not_increasing(2 * (p + k));
+                if (!(h1 > 0.0)) throw not_increasing(2 * (p + k) + 1);
+                const double h = h0 + h1;
+                terms[k] = h / 6.0 * ((2.0 - h1 / h0) * f[2 * k] + h * h / (h0 * h1) * f[2 * k + 1]
+                                      + (2.0 - h0 / h1) * f[2 * k + 2]);
+            }
+            chunk.add(terms, m);
+        }
+        return chunk.sum();
+    });
+    if (n == even_n) return sum;
+
+    // last interval: integral of the parabola through the last three samples over [x_{n-1}, x_n]
+    const double h0 = samples.node(n - 1) - samples.node(n - 2);
+    const double h1 = samples.node(n) - samples.node(n - 1);
+    if (!(h1 > 0.0)) throw not_increasing(n - 1);
+    return sum + (2.0 * h1 * h1 + 3.0 * h0 * h1) / (6.0 * (h0 + h1)) * samples.value(n)
+               + (h1 * h1 + 3.0 * h0 * h1) / (6.0 * h0) * samples.value(n - 1)
+               - h1 * h1 * h1 / (6.0 * h0 * (h0 + h1)) * samples.value(n - 2);
+}
+
+double SampledSimpsonSolver::integrate(const Samples2D& samples) const {
+    // equally spaced grids with even numbers of intervals get the weights of Simpson2DSolver
+    // (1, 4, 2, ..., 4, 1 times h / 3), everything else the rule on the nodes
+    const bool x_simpson = samples.uniform() && (samples.nx() - 1) % 2 == 0;
+    const bool y_simpson = samples.uniform() && (samples.ny() - 1) % 2 == 0;
+    const TensorRule1D x_rule = x_simpson ? simpson_rule(samples.a(), samples.b(), samples.nx() - 1)
+                                          : simpson_rule(samples.x_nodes());
+    const TensorRule1D y_rule = y_simpson ? simpson_rule(samples.c(), samples.d(), samples.ny() - 1)
+                                          : simpson_rule(samples.y_nodes());
+    return tensor_product_sum(samples.values(), x_rule.weights, y_rule.weights, threads_, summation_)
+         * (x_rule.scale * y_rule.scale);
+}
+
+std::string SampledSimpsonSolver::configuration() const {
+    const std::string suffix = summation_suffix(summation_);
+    return suffix.empty() ? "SampledSimpson" : "SampledSimpson(" + suffix.substr(1) + ")";
+}
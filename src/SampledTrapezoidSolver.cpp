@@ -0,0 +1,73 @@
+#include "SampledTrapezoidSolver.h"
+#include "IntegrationKernels.h"
+#include "TensorProduct.h"
+#include <algorithm>
+#include <stdexcept>
+
+/*
+Implementation of the trapezoidal rule on tabulated samples.
+*/
+
+double SampledTrapezoidSolver::integrate(const Samples1D& samples) const {
+    const std::size_t n = samples.count() - 1;
+
+    if (samples.uniform()) {
+        // h·[f_0/2 + Σ f_i + f_n/2], the interior samples i = 1..n-1 in the chunks of kernels::trapezoid,
+        // contiguous samples are summed in place
+        const double h = samples.h();
+        const double interior = parallel_sum(n - 1, kernels::chunk_size, threads_, [&](std::size_t begin, std::size_t end) {
+            double buffer[kernels::block_size];
+            Accumulator chunk(summation_);
+            for (std::size_t i = begin; i < end; i += kernels::block_size) {
+                const std::size_t m = std::min(kernels::block_size, end - i);
+                chunk.add(samples.values(i + 1, m, buffer), m);
+            }
+            return chunk.sum();
+        });
+        double s = 0.5 * (samples.value(0) + samples.value(n));
+        s += interior;
+        return s * h;
+    }
+
+    // Σ (x_{i+1} - x_i)(f_i + f_{i+1}) / 2 over the intervals i = 0..n-1
+    const double sum = parallel_sum(n, kernels::chunk_size, threads_, [&](std::size_t begin, std::size_t end) {
+        double x_buffer[kernels::block_size + 1];
+        double f_buffer[kernels::block_size + 1];
+        double terms[kernels::block_size];
+        Accumulator chunk(summation_);
+        for (std::size_t i = begin; i < end; i += kernels::block_size) {
+            const std::size_t m = std::min(kernels::block_size, end - i);
+            const double* x = samples.nodes(i, m + 1, x_buffer);
+            const double* f = samples.values(i, m + 1, f_buffer);
+            for (std::size_t k = 0; k < m; ++k) {
+                const double dx = x[k + 1] - x[k];
+                if (!(dx > 0.0)) {
+                    throw std::invalid_argument("samples: nodes must be strictly increasing, x[" + std::to_string(i + k)
+                                                + "] >= x[" + std::to_string(i + k + 1) + "]");
+                }
+                terms[k] = dx * (f[k] + f[k + 1]);
+            }
+            chunk.add(terms, m);
+        }
+        return chunk.sum();
+    });
+    return 0.5 * sum;
+}
+
+double SampledTrapezoidSolver::integrate(const Samples2D& samples) const {
+    // equally spaced grids get the weights of Trapezoid2DSolver (1, 2, ..., 2, 1 times h / 2)
+    if (samples.uniform()) {
+        const TensorRule1D x_rule = trapezoid_rule(samples.a(), samples.b(), samples.nx() - 1);
+        const TensorRule1D y_rule = trapezoid_rule(samples.c(), samples.d(), samples.ny() - 1);
+        return tensor_product_sum(samples.values(), x_rule.weights, y_rule.weights, threads_, summation_)
+             * (x_rule.scale * y_rule.scale);
+    }
+    const TensorRule1D x_rule = trapezoid_rule(samples.x_nodes());
+    const TensorRule1D y_rule = trapezoid_rule(samples.y_nodes());
+    return tensor_product_sum(samples.values(), x_rule.weights, y_rule.weights, threads_, summation_);
+}
+
+std::string SampledTrapezoidSolver::configuration() const {
+    const std::string suffix = summation_suffix(summation_);
+    return suffix.empty() ? "SampledTrapezoid" : "SampledTrapezoid(" + suffix.substr(1) + ")";
+}
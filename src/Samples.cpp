@@ -0,0 +1,316 @@
+#include "Samples.h"
+#include "MappedFile.h"
+#include "ParallelSum.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+/*
+Implementation of the sample views and the raw / CSV loaders.
+*/
+
+namespace {
+
+// CSV text per parse work item, cut at the next line end
+constexpr std::size_t csv_piece_bytes = std::size_t(1) << 20;
+
+// longest number in a CSV field
+constexpr std::size_t csv_max_field = 64;
+
+bool little_endian_host() {
+    const std::uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+void require_interval(double lo, double hi, const char* message) {
+    if (!(lo < hi)) throw std::invalid_argument(message);
+}
+
+void require_increasing(const std::vector<double>& nodes, const char* name) {
+    for (std::size_t i = 1; i < nodes.size(); ++i) {
+        if (!(nodes[i - 1] < nodes[i])) {
+            throw std::invalid_argument(std::string("samples: ") + name + " nodes must be strictly increasing");
+        }
+    }
+}
+
+std::vector<double> equally_spaced(double lo, double hi, std::size_t n) {
+    const double h = (hi - lo) / static_cast<double>(n - 1);
+    std::vector<double> nodes(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        nodes[i] = lo + i * h;
+    }
+    return nodes;
+}
+
+// the doubles of a raw file: the mapping itself on a little-endian host, a byte-swapped copy otherwise
+std::shared_ptr<const void> map_doubles(const std::string& path, const double*& data, std::size_t& count) {
+    auto file = std::make_shared<const MappedFile>(path);
+    if (file->size() % sizeof(double) != 0) {
+        throw std::invalid_argument("raw file \"" + path + "\": size is not a multiple of 8 bytes");
+    }
+    count = file->size() / sizeof(double);
+    if (little_endian_host()) {
+        data = reinterpret_cast<const double*>(file->data());
+        return file;
+    }
+    auto swapped = std::make_shared<std::vector<double>>(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        unsigned char bytes[sizeof(double)];
+        std::memcpy(bytes, file->data() + i * sizeof(double), sizeof(double));
+        std::reverse(bytes, bytes + sizeof(double));
+        std::memcpy(swapped->data() + i, bytes, sizeof(double));
+    }
+    data = swapped->data();
+    return swapped;
+}
+
+bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// reads the fields of the line [p, end) into fields, false if one of them is not a number
+bool parse_line(const char* p, const char* end, std::vector<double>& fields) {
+    fields.clear();
+    while (p < end && is_space(*p)) ++p;
+    while (p < end) {
+        const char* field = p;
+        while (p < end && *p != ',' && *p != ';' && !is_space(*p)) ++p;
+        const std::size_t length = static_cast<std::size_t>(p - field);
+        if (length == 0 || length >= csv_max_field) return false;
+        // strtod needs a terminated string, the mapped text is not
+        char buffer[csv_max_field];
+        std::memcpy(buffer, field, length);
+        buffer[length] = '\0';
+        char* parsed;
+        fields.push_back(std::strtod(buffer, &parsed));
+        if (parsed != buffer + length) return false;
+        while (p < end && is_space(*p)) ++p;
+        if (p < end && (*p == ',' || *p == ';')) {
+            ++p;
+            while (p < end && is_space(*p)) ++p;
+            if (p == end) return false; // trailing separator = empty last field
+        }
+    }
+    return true;
+}
+
+bool is_blank(const char* p, const char* end) {
+    while (p < end && is_space(*p)) ++p;
+    return p == end || *p == '#';
+}
+
+const char* line_end(const char* p, const char* end) {
+    const void* newline = std::memchr(p, '\n', static_cast<std::size_t>(end - p));
+    return newline ? static_cast<const char*>(newline) : end;
+}
+
+// rows of a CSV file, the kept fields of every row one after the other
+struct CsvTable {
+    std::vector<double> values;
+    std::size_t rows = 0;
+    std::size_t columns = 0; // kept fields per row
+};
+
+// columns = indices of the fields to keep (every row needs them), empty = all fields
+// (every row needs as many as the first one)
+CsvTable read_csv(const std::string& path, const std::vector<std::size_t>& columns, unsigned threads) {
+    const MappedFile file(path);
+    const char* const text = file.data();
+    const char* const end = text + file.size();
+    auto error = [&](std::size_t line, const std::string& what) {
+        return std::invalid_argument("CSV file \"" + path + "\", line " + std::to_string(line) + ": " + what);
+    };
+
+    // first data line: an unparsable first line is the header
+    std::vector<double> fields;
+    const char* data = text;
+    std::size_t line = 0;
+    bool header_allowed = true;
+    std::size_t width = 0;
+    while (data < end) {
+        const char* e = line_end(data, end);
+        ++line;
+        if (!is_blank(data, e)) {
+            if (parse_line(data, e, fields)) {
+                width = fields.size();
+                break;
+            }
+            if (!header_allowed) throw error(line, "invalid number");
+            header_allowed = false;
+        }
+        data = (e < end) ? e + 1 : end;
+    }
+    if (width == 0) throw std::invalid_argument("CSV file \"" + path + "\": no data");
+    const std::size_t lines_before = line - 1;
+
+    CsvTable table;
+    table.columns = columns.empty() ? width : columns.size();
+    const std::size_t required = columns.empty() ? width : *std::max_element(columns.begin(), columns.end()) + 1;
+
+    // pieces of whole lines, the boundaries only depend on the text
+    std::vector<const char*> bounds{data};
+    while (bounds.back() < end) {
+        const char* p = bounds.back() + std::min<std::size_t>(csv_piece_bytes, static_cast<std::size_t>(end - bounds.back()));
+        p = (p < end) ? line_end(p, end) : end;
+        bounds.push_back((p < end) ? p + 1 : end);
+    }
+    const std::size_t pieces = bounds.size() - 1;
+
+    struct Piece {
+        std::vector<double> values;
+        std::size_t rows = 0;
+        std::size_t lines = 0;       // lines read, including the failing one
+        std::string error;           // empty = no error
+    };
+    std::vector<Piece> parsed(pieces);
+    parallel_chunks(pieces, 1, threads, [&](std::size_t c, std::size_t, std::size_t) {
+        Piece& piece = parsed[c];
+        std::vector<double> row;
+        for (const char* p = bounds[c]; p < bounds[c + 1];) {
+            const char* e = line_end(p, bounds[c + 1]);
+            ++piece.lines;
+            if (!is_blank(p, e)) {
+                if (!parse_line(p, e, row)) {
+                    piece.error = "invalid number";
+                    return;
+                }
+                if (columns.empty() ? row.size() != width : row.size() < required) {
+                    piece.error = std::to_string(row.size()) + " fields, expected "
+                                + (columns.empty() ? "" : "at least ") + std::to_string(required);
+                    return;
+                }
+                if (columns.empty()) {
+                    piece.values.insert(piece.values.end(), row.begin(), row.end());
+                } else {
+                    for (std::size_t column : columns) piece.values.push_back(row[column]);
+                }
+                ++piece.rows;
+            }
+            p = e + 1;
+        }
+    });
+
+    std::vector<std::size_t> offsets(pieces + 1, 0);
+    std::size_t lines = lines_before;
+    for (std::size_t c = 0; c < pieces; ++c) {
+        if (!parsed[c].error.empty()) throw error(lines + parsed[c].lines, parsed[c].error);
+        lines += parsed[c].lines;
+        offsets[c + 1] = offsets[c] + parsed[c].values.size();
+        table.rows += parsed[c].rows;
+    }
+
+    table.values.resize(offsets[pieces]);
+    parallel_chunks(pieces, 1, threads, [&](std::size_t c, std::size_t, std::size_t) {
+        std::copy(parsed[c].values.begin(), parsed[c].values.end(), table.values.begin() + offsets[c]);
+        std::vector<double>().swap(parsed[c].values);
+    });
+    return table;
+}
+
+}
+
+Samples1D::Samples1D(const double* values, std::size_t count, double a, double b, std::size_t stride)
+    : values_(values), count_(count), stride_(stride ? stride : 1), a_(a), b_(b) {
+    if (count < 2) throw std::invalid_argument("samples: need at least 2 values");
+    require_interval(a, b, "Invalid x interval: require a < b");
+}
+
+Samples1D::Samples1D(const double* x, const double* values, std::size_t count, std::size_t stride)
+    : x_(x), values_(values), count_(count), stride_(stride ? stride : 1) {
+    if (count < 2) throw std::invalid_argument("samples: need at least 2 values");
+}
+
+Samples1D Samples1D::load_raw(const std::string& path, double a, double b) {
+    const double* data = nullptr;
+    std::size_t count = 0;
+    std::shared_ptr<const void> storage = map_doubles(path, data, count);
+    Samples1D samples(data, count, a, b);
+    samples.storage_ = std::move(storage);
+    return samples;
+}
+
+Samples1D Samples1D::load_raw_pairs(const std::string& path) {
+    const double* data = nullptr;
+    std::size_t count = 0;
+    std::shared_ptr<const void> storage = map_doubles(path, data, count);
+    if (count % 2 != 0) throw std::invalid_argument("raw file \"" + path + "\": odd number of values, expected (x, f) pairs");
+    Samples1D samples(data, data + 1, count / 2, 2);
+    samples.storage_ = std::move(storage);
+    return samples;
+}
+
+Samples1D Samples1D::load_csv(const std::string& path, std::size_t x_column, std::size_t value_column,
+                              unsigned threads) {
+    auto table = std::make_shared<CsvTable>(read_csv(path, {x_column, value_column}, threads));
+    Samples1D samples(table->values.data(), table->values.data() + 1, table->rows, 2);
+    samples.storage_ = std::move(table);
+    return samples;
+}
+
+Samples1D Samples1D::load_csv_values(const std::string& path, std::size_t value_column, double a, double b,
+                                     unsigned threads) {
+    auto table = std::make_shared<CsvTable>(read_csv(path, {value_column}, threads));
+    Samples1D samples(table->values.data(), table->rows, a, b);
+    samples.storage_ = std::move(table);
+    return samples;
+}
+
+Samples2D::Samples2D(const double* values, std::size_t nx, std::size_t ny, double a, double b, double c, double d)
+    : values_(values), uniform_(true), a_(a), b_(b), c_(c), d_(d) {
+    if (nx < 2 || ny < 2) throw std::invalid_argument("samples: need at least 2 x 2 values");
+    require_interval(a, b, "Invalid x interval: require a < b");
+    require_interval(c, d, "Invalid y interval: require c < d");
+    x_ = equally_spaced(a, b, nx);
+    y_ = equally_spaced(c, d, ny);
+}
+
+Samples2D::Samples2D(const double* values, std::vector<double> x, std::vector<double> y)
+    : values_(values), x_(std::move(x)), y_(std::move(y)), uniform_(false) {
+    if (x_.size() < 2 || y_.size() < 2) throw std::invalid_argument("samples: need at least 2 x 2 values");
+    require_increasing(x_, "x");
+    require_increasing(y_, "y");
+    a_ = x_.front();
+    b_ = x_.back();
+    c_ = y_.front();
+    d_ = y_.back();
+}
+
+Samples2D Samples2D::load_raw(const std::string& path, std::size_t nx, std::size_t ny,
+                              double a, double b, double c, double d) {
+    const double* data = nullptr;
+    std::size_t count = 0;
+    std::shared_ptr<const void> storage = map_doubles(path, data, count);
+    if (count != nx * ny) {
+        throw std::invalid_argument("raw file \"" + path + "\": " + std::to_string(count) + " values, expected "
+                                    + std::to_string(nx) + " x " + std::to_string(ny));
+    }
+    Samples2D samples(data, nx, ny, a, b, c, d);
+    samples.storage_ = std::move(storage);
+    return samples;
+}
+
+Samples2D Samples2D::load_raw(const std::string& path, std::vector<double> x, std::vector<double> y) {
+    const double* data = nullptr;
+    std::size_t count = 0;
+    std::shared_ptr<const void> storage = map_doubles(path, data, count);
+    if (count != x.size() * y.size()) {
+        throw std::invalid_argument("raw file \"" + path + "\": " + std::to_string(count) + " values, expected "
+                                    + std::to_string(x.size()) + " x " + std::to_string(y.size()));
+    }
+    Samples2D samples(data, std::move(x), std::move(y));
+    samples.storage_ = std::move(storage);
+    return samples;
+}
+
+Samples2D Samples2D::load_csv(const std::string& path, double a, double b, double c, double d, unsigned threads) {
+    auto table = std::make_shared<CsvTable>(read_csv(path, {}, threads));
+    Samples2D samples(table->values.data(), table->rows, table->columns, a, b, c, d);
+    samples.storage_ = std::move(table);
+    return samples;
+}
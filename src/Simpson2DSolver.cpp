@@ -1,4 +1,5 @@
 #include "Simpson2DSolver.h"
+#include "TensorProduct.h"
 
 
 /*
@@ -7,42 +8,25 @@ Implementation of the Simpson2DSolver method for integration.
 double Simpson2DSolver::integrate(const Function2D& f,
                                   double a, double b,
                                   double c, double d) const {
+    return integrate_many({&f}, a, b, c, d)[0];
+}
+
+std::vector<double> Simpson2DSolver::integrate_many(const std::vector<const Function2D*>& fs,
+                                                    double a, double b,
+                                                    double c, double d) const {
     validate_intervals(a, b, c, d);
     
-    const double hx = (b - a) / static_cast<double>(nx_);
-    const double hy = (d - c) / static_cast<double>(ny_);
-    
-    double sum = 0.0;
-    
-    for (std::size_t i = 0; i <= nx_; ++i) {
-        double x = a + i * hx;
-        
-        // Weight in x direction
-        double wx;
-        if (i == 0 || i == nx_) {
-            wx = 1.0;
-        } else if (i % 2 == 1) {
-            wx = 4.0;
-        } else {
-            wx = 2.0;
-        }
-        
-        for (std::size_t j = 0; j <= ny_; ++j) {
-            double y = c + j * hy;
-            
-            // Weight in y direction
-            double wy;
-            if (j == 0 || j == ny_) {
-                wy = 1.0;
-            } else if (j % 2 == 1) {
-                wy = 4.0;
-            } else {
-                wy = 2.0;
-            }
-            
-            sum += wx * wy * f(x, y);
-        }
+    const TensorRule1D x_rule = simpson_rule(a, b, nx_);
+    const TensorRule1D y_rule = simpson_rule(c, d, ny_);
+
+    std::vector<double> sum = tensor_product_sum(fs, x_rule.nodes, x_rule.weights,
+                                                 y_rule.nodes, y_rule.weights, threads_, summation_);
+    for (double& s : sum) {
+        s *= x_rule.scale * y_rule.scale;
     }
-    
-    return (hx * hy / 9.0) * sum;
-}
\ No newline at end of file
+    return sum;
+}
+
+std::string Simpson2DSolver::configuration() const {
+    return "Simpson2D(nx=" + std::to_string(nx_) + ",ny=" + std::to_string(ny_) + summation_suffix(summation_) + ")";
+}
@@ -1,4 +1,5 @@
 #include "SimpsonSolver.h"
+#include <algorithm>
 #include <cmath>
 
 /*
@@ -6,20 +7,57 @@ Implementation of the SimpsonSolver integrate method.
 */
 
 double SimpsonSolver::integrate(const Function& f, double a, double b) const {
+    return kernels::simpson(f, a, b, n_, threads_, summation_);
+}
+
+std::vector<double> SimpsonSolver::integrate_many(const std::vector<const Function*>& fs, double a, double b) const {
     validate_interval(a, b);
     const std::size_t n = n_;
+    const std::size_t count = fs.size();
     const double h = (b - a) / static_cast<double>(n);
-    double s = f(a) + f(b);
 
-    // odd indices
-    for (std::size_t i = 1; i < n; i += 2) {
-        double x = a + i * h;
-        s += 4.0 * f(x);
-    }
-    // even indices
-    for (std::size_t i = 2; i < n; i += 2) {
-        double x = a + i * h;
-        s += 2.0 * f(x);
+    // interior nodes x_i, i = 1..n-1, weight 4 at odd and 2 at even indices
+    // the range is split into fixed chunks that are summed in parallel,
+    // within a chunk the nodes are generated in blocks, every integrand is evaluated on the same block
+    const std::vector<double> interior = parallel_sum(n - 1, chunk_size, threads_, count,
+        [&](std::size_t begin, std::size_t end, double* chunk) {
+            double xs[block_size];
+            double fx[block_size];
+            double odd[block_size / 2];
+            double even[block_size / 2];
+            std::vector<Accumulator> s_odd(count, Accumulator(summation_));
+            std::vector<Accumulator> s_even(count, Accumulator(summation_));
+            for (std::size_t j = begin; j < end; j += block_size) {
+                const std::size_t m = std::min(block_size, end - j);
+                for (std::size_t k = 0; k < m; ++k) {
+                    xs[k] = a + (j + k + 1) * h;
+                }
+                for (std::size_t q = 0; q < count; ++q) {
+                    fs[q]->evaluate(xs, fx, m);
+                    // chunk_size and block_size are even, so j is even and node index i = j + k + 1
+                    // is odd for even k
+                    for (std::size_t k = 0; k < m; ++k) {
+                        (k % 2 == 0 ? odd : even)[k / 2] = fx[k];
+                    }
+                    s_odd[q].add(odd, (m + 1) / 2);
+                    s_even[q].add(even, m / 2);
+                }
+            }
+            for (std::size_t q = 0; q < count; ++q) {
+                chunk[q] = 4.0 * s_odd[q].sum() + 2.0 * s_even[q].sum();
+            }
+        });
+
+    std::vector<double> result(count);
+    for (std::size_t q = 0; q < count; ++q) {
+        const Function& f = *fs[q];
+        double s = f(a) + f(b);
+        s += interior[q];
+        result[q] = s * (h / 3.0);
     }
-    return s * (h / 3.0);
+    return result;
+}
+
+std::string SimpsonSolver::configuration() const {
+    return "Simpson(n=" + std::to_string(n_) + summation_suffix(summation_) + ")";
 }
@@ -0,0 +1,30 @@
+#include "SparseGrid2DSolver.h"
+#include "FunctionND.h"
+#include <iomanip>
+#include <sstream>
+
+/*
+Implementation of the 2D sparse-grid solver: the integrand is viewed as FunctionND<2>
+and handed to the N-D engine.
+*/
+
+double SparseGrid2DSolver::integrate(const Function2D& f,
+                                     double a, double b,
+                                     double c, double d) const {
+    return integrate_sparse(f, a, b, c, d).value;
+}
+
+SparseGrid2DSolver::Result SparseGrid2DSolver::integrate_sparse(const Function2D& f,
+                                                                double a, double b,
+                                                                double c, double d) const {
+    validate_intervals(a, b, c, d);
+    const Function2DAsND view(f);
+    return solver_.integrate_sparse(view, {a, c}, {b, d});
+}
+
+std::string SparseGrid2DSolver::configuration() const {
+    std::ostringstream out;
+    out << std::setprecision(17) << "SparseGrid2D(abs_tol=" << abs_tol_ << ",rel_tol=" << rel_tol_
+        << ",max_evaluations=" << max_evaluations_ << ",max_level=" << max_level_ << ")";
+    return out.str();
+}
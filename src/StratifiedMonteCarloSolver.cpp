@@ -0,0 +1,83 @@
+#include "StratifiedMonteCarloSolver.h"
+#include "Philox.h"
+#include "RunningStats.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+/*
+Implementation of the stratified Monte Carlo solver.
+
+Stratum j = [a + j H, a + (j+1) H], H = (b-a)/k, with n_j samples:
+    Q = Σ_j H · mean_j(f),   Var(Q) ≈ Σ_j H² · s_j² / n_j
+*/
+
+StratifiedMonteCarloSolver::StratifiedMonteCarloSolver(std::size_t n, std::size_t strata,
+                                                       std::uint64_t seed, unsigned threads)
+    : n_(std::max<std::size_t>(n, 2)),
+      strata_(std::min(std::max<std::size_t>(strata, 1), std::max<std::size_t>(n, 2) / 2)),
+      seed_(seed), threads_(resolve_threads(threads)) {}
+
+double StratifiedMonteCarloSolver::integrate(const Function& f, double a, double b) const {
+    return integrate_stratified(f, a, b).value;
+}
+
+StratifiedMonteCarloSolver::Result StratifiedMonteCarloSolver::integrate_stratified(const Function& f,
+                                                                                   double a, double b) const {
+    validate_interval(a, b);
+    const std::uint64_t actual_seed = (seed_ != 0) ? seed_ : std::random_device{}();
+    const Philox4x32 rng(actual_seed);
+    const std::size_t k = strata_;
+    const double H = (b - a) / static_cast<double>(k);
+
+    // stratum j gets base or base + 1 samples (the first n mod k strata one more), the samples of
+    // stratum j have the consecutive indices offset(j) .. offset(j) + count(j) - 1
+    const std::size_t base = n_ / k;
+    const std::size_t extra = n_ % k;
+    auto offset = [&](std::size_t j) { return j * base + std::min(j, extra); };
+
+    // work items are groups of whole strata, each stratum stores its contribution to value and variance
+    std::vector<double> value(k);
+    std::vector<double> variance(k);
+    const std::size_t strata_per_chunk = std::max<std::size_t>(1, chunk_size / base);
+    parallel_chunks(k, strata_per_chunk, threads_, [&](std::size_t, std::size_t begin, std::size_t end) {
+        double xs[block_size];
+        double fx[block_size];
+        for (std::size_t j = begin; j < end; ++j) {
+            const std::size_t first = offset(j);
+            const std::size_t count = offset(j + 1) - first;
+            const double lo = a + static_cast<double>(j) * H;
+            RunningStats stats;
+            for (std::size_t i = 0; i < count; i += block_size) {
+                const std::size_t m = std::min(block_size, count - i);
+                for (std::size_t q = 0; q < m; ++q) {
+                    const Philox4x32::result_type r = rng(static_cast<std::uint64_t>(first + i + q));
+                    xs[q] = lo + H * Philox4x32::to_open_unit(r[0], r[1]);
+                }
+                f.evaluate(xs, fx, m);
+                for (std::size_t q = 0; q < m; ++q) {
+                    stats.add(fx[q]);
+                }
+            }
+            value[j] = H * stats.mean();
+            variance[j] = H * H * stats.variance() / static_cast<double>(stats.count());
+        }
+    });
+
+    Result result{0.0, 0.0, n_, k};
+    double total_variance = 0.0;
+    for (std::size_t j = 0; j < k; ++j) {
+        result.value += value[j];
+        total_variance += variance[j];
+    }
+    result.error = std::sqrt(total_variance);
+    return result;
+}
+
+std::string StratifiedMonteCarloSolver::configuration() const {
+    // seed 0 draws a new random seed on every call, the result is not reproducible
+    if (seed_ == 0) return std::string();
+    return "StratifiedMonteCarlo(n=" + std::to_string(n_) + ",strata=" + std::to_string(strata_)
+         + ",seed=" + std::to_string(seed_) + ")";
+}
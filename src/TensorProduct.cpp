@@ -0,0 +1,204 @@
+#include "TensorProduct.h"
+#include "GaussLegendreRule.h"
+#include "ParallelSum.h"
+#include "SeparableFunction2D.h"
+#include <algorithm>
+
+/*
+Implementation of the 1D rules and the tiled tensor-product kernel.
+*/
+
+TensorRule1D trapezoid_rule(double lo, double hi, std::size_t n) {
+    const double h = (hi - lo) / static_cast<double>(n);
+    TensorRule1D rule{std::vector<double>(n + 1), std::vector<double>(n + 1, 2.0), h / 2.0};
+    for (std::size_t i = 0; i <= n; ++i) {
+        rule.nodes[i] = lo + i * h;
+    }
+    rule.weights.front() = 1.0;
+    rule.weights.back() = 1.0;
+    return rule;
+}
+
+TensorRule1D simpson_rule(double lo, double hi, std::size_t n) {
+    const double h = (hi - lo) / static_cast<double>(n);
+    TensorRule1D rule{std::vector<double>(n + 1), std::vector<double>(n + 1), h / 3.0};
+    for (std::size_t i = 0; i <= n; ++i) {
+        rule.nodes[i] = lo + i * h;
+        rule.weights[i] = (i % 2 == 1) ? 4.0 : 2.0;
+    }
+    rule.weights.front() = 1.0;
+    rule.weights.back() = 1.0;
+    return rule;
+}
+
+TensorRule1D weddle_rule(double lo, double hi, std::size_t n) {
+    const double h = (hi - lo) / static_cast<double>(n);
+    TensorRule1D rule{std::vector<double>(n + 2), std::vector<double>(n + 2, 2.0), h / 2.0};
+    rule.nodes.front() = lo;
+    for (std::size_t i = 0; i < n; ++i) {
+        rule.nodes[i + 1] = lo + (static_cast<double>(i) + 0.5) * h;
+    }
+    rule.nodes.back() = hi;
+    rule.weights.front() = 1.0;
+    rule.weights.back() = 1.0;
+    return rule;
+}
+
+TensorRule1D gauss_legendre_composite_rule(std::size_t order, std::size_t panels, double lo, double hi) {
+    const GaussLegendreRule gl = gauss_legendre_rule(order);
+    const double H = (hi - lo) / static_cast<double>(panels);
+    const double half = 0.5 * H;
+    TensorRule1D rule{std::vector<double>(panels * gl.order), std::vector<double>(panels * gl.order), 1.0};
+    for (std::size_t p = 0; p < panels; ++p) {
+        const double center = lo + (static_cast<double>(p) + 0.5) * H;
+        for (std::size_t i = 0; i < gl.order; ++i) {
+            rule.nodes[p * gl.order + i] = center + half * gl.nodes[i];
+            rule.weights[p * gl.order + i] = half * gl.weights[i];
+        }
+    }
+    return rule;
+}
+
+TensorRule1D trapezoid_rule(const std::vector<double>& nodes) {
+    const std::size_t n = nodes.size() - 1;
+    TensorRule1D rule{nodes, std::vector<double>(n + 1, 0.0), 1.0};
+    for (std::size_t i = 0; i < n; ++i) {
+        const double half = 0.5 * (nodes[i + 1] - nodes[i]);
+        rule.weights[i] += half;
+        rule.weights[i + 1] += half;
+    }
+    return rule;
+}
+
+TensorRule1D simpson_rule(const std::vector<double>& nodes) {
+    const std::size_t n = nodes.size() - 1;
+    if (n < 2) return trapezoid_rule(nodes);
+    TensorRule1D rule{nodes, std::vector<double>(n + 1, 0.0), 1.0};
+    for (std::size_t i = 0; i + 2 <= n; i += 2) {
+        const double h0 = nodes[i + 1] - nodes[i];
+        const double h1 = nodes[i + 2] - nodes[i + 1];
+        const double w = (h0 + h1) / 6.0;
+        rule.weights[i] += w * (2.0 - h1 / h0);
+        rule.weights[i + 1] += w * (h0 + h1) * (h0 + h1) / (h0 * h1);
+        rule.weights[i + 2] += w * (2.0 - h0 / h1);
+    }
+    if (n % 2 == 1) {
+        const double h0 = nodes[n - 1] - nodes[n - 2];
+        const double h1 = nodes[n] - nodes[n - 1];
+        rule.weights[n] += (2.0 * h1 * h1 + 3.0 * h0 * h1) / (6.0 * (h0 + h1));
+        rule.weights[n - 1] += (h1 * h1 + 3.0 * h0 * h1) / (6.0 * h0);
+        rule.weights[n - 2] -= h1 * h1 * h1 / (6.0 * h0 * (h0 + h1));
+    }
+    return rule;
+}
+
+namespace {
+
+// Σ_i weights[i] u(nodes[i]), nodes evaluated in blocks of tensor_tile_columns
+double rule_sum(const Function& u, const std::vector<double>& nodes, const std::vector<double>& weights,
+                Summation summation) {
+    double values[tensor_tile_columns];
+    Accumulator s(summation);
+    for (std::size_t i0 = 0; i0 < nodes.size(); i0 += tensor_tile_columns) {
+        const std::size_t m = std::min(tensor_tile_columns, nodes.size() - i0);
+        u.evaluate(nodes.data() + i0, values, m);
+        s.add_products(weights.data() + i0, values, m);
+    }
+    return s.sum();
+}
+
+// Σ_i Σ_j wx_i wy_j f(x_i, y_j) for every f in fs on the full grid
+std::vector<double> grid_sum(const std::vector<const Function2D*>& fs,
+                             const std::vector<double>& x_nodes, const std::vector<double>& x_weights,
+                             const std::vector<double>& y_nodes, const std::vector<double>& y_weights,
+                             unsigned threads, Summation summation) {
+    const std::size_t count = fs.size();
+    const std::size_t ny = y_nodes.size();
+
+    // one work item = one tile row, i.e. tensor_tile_rows consecutive x rows
+    return parallel_sum(x_nodes.size(), tensor_tile_rows, threads, count,
+        [&](std::size_t begin, std::size_t end, double* chunk) {
+            const std::size_t rows = end - begin;
+            double xs[tensor_tile_columns];
+            double fxy[tensor_tile_columns];
+            // row[r * count + q] = Σ_j wy_j f_q(x_{begin+r}, y_j), accumulated tile by tile in j order
+            std::vector<Accumulator> row(rows * count, Accumulator(summation));
+
+            for (std::size_t j0 = 0; j0 < ny; j0 += tensor_tile_columns) {
+                const std::size_t m = std::min(tensor_tile_columns, ny - j0);
+                const double* ys = y_nodes.data() + j0;
+                const double* wy = y_weights.data() + j0;
+                for (std::size_t r = 0; r < rows; ++r) {
+                    std::fill(xs, xs + m, x_nodes[begin + r]);
+                    for (std::size_t q = 0; q < count; ++q) {
+                        fs[q]->evaluate(xs, ys, fxy, m);
+                        row[r * count + q].add_products(wy, fxy, m);
+                    }
+                }
+            }
+
+            for (std::size_t q = 0; q < count; ++q) {
+                Accumulator s(summation);
+                for (std::size_t r = 0; r < rows; ++r) {
+                    s.add(x_weights[begin + r] * row[r * count + q].sum());
+                }
+                chunk[q] = s.sum();
+            }
+        });
+}
+
+}
+
+std::vector<double> tensor_product_sum(const std::vector<const Function2D*>& fs,
+                                       const std::vector<double>& x_nodes, const std::vector<double>& x_weights,
+                                       const std::vector<double>& y_nodes, const std::vector<double>& y_weights,
+                                       unsigned threads, Summation summation) {
+    std::vector<double> result(fs.size(), 0.0);
+
+    // separable integrands are done right away, the others are collected for one sweep over the grid
+    std::vector<const Function2D*> grid;
+    std::vector<std::size_t> grid_index;
+    for (std::size_t q = 0; q < fs.size(); ++q) {
+        const auto* separable = dynamic_cast<const SeparableFunction2D*>(fs[q]);
+        if (!separable) {
+            grid.push_back(fs[q]);
+            grid_index.push_back(q);
+            continue;
+        }
+        for (std::size_t k = 0; k < separable->terms(); ++k) {
+            const SeparableFunction2D::Term& t = separable->term(k);
+            result[q] += rule_sum(*t.x, x_nodes, x_weights, summation) * rule_sum(*t.y, y_nodes, y_weights, summation);
+        }
+    }
+
+    if (!grid.empty()) {
+        const std::vector<double> sums = grid_sum(grid, x_nodes, x_weights, y_nodes, y_weights, threads, summation);
+        for (std::size_t g = 0; g < grid.size(); ++g) {
+            result[grid_index[g]] = sums[g];
+        }
+    }
+    return result;
+}
+
+double tensor_product_sum(const double* values, const std::vector<double>& x_weights,
+                          const std::vector<double>& y_weights, unsigned threads, Summation summation) {
+    const std::size_t ny = y_weights.size();
+
+    // the work items and the order of the row sums of grid_sum, the tile of y weights stays in
+    // cache while it is applied to the rows of the work item
+    return parallel_sum(x_weights.size(), tensor_tile_rows, threads, [&](std::size_t begin, std::size_t end) {
+        const std::size_t rows = end - begin;
+        std::vector<Accumulator> row(rows, Accumulator(summation));
+        for (std::size_t j0 = 0; j0 < ny; j0 += tensor_tile_columns) {
+            const std::size_t m = std::min(tensor_tile_columns, ny - j0);
+            for (std::size_t r = 0; r < rows; ++r) {
+                row[r].add_products(y_weights.data() + j0, values + (begin + r) * ny + j0, m);
+            }
+        }
+        Accumulator s(summation);
+        for (std::size_t r = 0; r < rows; ++r) {
+            s.add(x_weights[begin + r] * row[r].sum());
+        }
+        return s.sum();
+    });
+}
@@ -1,4 +1,5 @@
 #include "Trapezoid2DSolver.h"
+#include "TensorProduct.h"
 
 /*
 Implementation of the Trapezoid2dSolver integrate method.
@@ -7,38 +8,25 @@ Implementation of the Trapezoid2dSolver integrate method.
 double Trapezoid2DSolver::integrate(const Function2D& f,
                                     double a, double b,
                                     double c, double d) const {
+    return integrate_many({&f}, a, b, c, d)[0];
+}
+
+std::vector<double> Trapezoid2DSolver::integrate_many(const std::vector<const Function2D*>& fs,
+                                                      double a, double b,
+                                                      double c, double d) const {
     validate_intervals(a, b, c, d);
     
-    const double hx = (b - a) / static_cast<double>(nx_);
-    const double hy = (d - c) / static_cast<double>(ny_);
-    
-    double sum = 0.0;
-    
-    for (std::size_t i = 0; i <= nx_; ++i) {
-        double x = a + i * hx;
-        
-        for (std::size_t j = 0; j <= ny_; ++j) {
-            double y = c + j * hy;
-            
-            // Determine weight based on position
-            double weight = 1.0;
-            
-            // Interior points: weight 4
-            if (i > 0 && i < nx_ && j > 0 && j < ny_) {
-                weight = 4.0;
-            }
-            // Edge points (not corners): weight 2
-            else if ((i == 0 || i == nx_) && (j > 0 && j < ny_)) {
-                weight = 2.0;
-            }
-            else if ((j == 0 || j == ny_) && (i > 0 && i < nx_)) {
-                weight = 2.0;
-            }
-            // Corners: weight 1 (already set)
-            
-            sum += weight * f(x, y);
-        }
+    const TensorRule1D x_rule = trapezoid_rule(a, b, nx_);
+    const TensorRule1D y_rule = trapezoid_rule(c, d, ny_);
+
+    std::vector<double> sum = tensor_product_sum(fs, x_rule.nodes, x_rule.weights,
+                                                 y_rule.nodes, y_rule.weights, threads_, summation_);
+    for (double& s : sum) {
+        s *= x_rule.scale * y_rule.scale;
     }
-    
-    return (hx * hy / 4.0) * sum;
-}
\ No newline at end of file
+    return sum;
+}
+
+std::string Trapezoid2DSolver::configuration() const {
+    return "Trapezoid2D(nx=" + std::to_string(nx_) + ",ny=" + std::to_string(ny_) + summation_suffix(summation_) + ")";
+}
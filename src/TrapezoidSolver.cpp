@@ -1,4 +1,5 @@
 #include "TrapezoidSolver.h"
+#include <algorithm>
 #include <cmath>
 
 
@@ -12,17 +13,50 @@ Error: O(h²) where h = (b-a)/n
 */
 
 double TrapezoidSolver::integrate(const Function& f, double a, double b) const {
+    return kernels::trapezoid(f, a, b, n_, threads_, summation_);
+}
+
+std::vector<double> TrapezoidSolver::integrate_many(const std::vector<const Function*>& fs, double a, double b) const {
     validate_interval(a, b);
     const std::size_t n = n_;
+    const std::size_t count = fs.size();
     const double h = (b - a) / static_cast<double>(n);
 
     // Trapezoidal formula: (h/2)[f(a) + 2·Σf(xᵢ) + f(b)]
     // Rewritten as: h·[f(a)/2 + Σf(xᵢ) + f(b)/2]
-    
-    double s = 0.5 * (f(a) + f(b));
-    for (std::size_t i = 1; i < n; ++i) {
-        double x = a + i * h;
-        s += f(x);
+
+    // interior nodes x_i, i = 1..n-1, split into fixed chunks that are summed in parallel
+    // within a chunk the nodes are generated in blocks, every integrand is evaluated on the same block
+    const std::vector<double> interior = parallel_sum(n - 1, chunk_size, threads_, count,
+        [&](std::size_t begin, std::size_t end, double* chunk) {
+            double xs[block_size];
+            double fx[block_size];
+            std::vector<Accumulator> sums(count, Accumulator(summation_));
+            for (std::size_t i = begin; i < end; i += block_size) {
+                const std::size_t m = std::min(block_size, end - i);
+                for (std::size_t k = 0; k < m; ++k) {
+                    xs[k] = a + (i + k + 1) * h;
+                }
+                for (std::size_t q = 0; q < count; ++q) {
+                    fs[q]->evaluate(xs, fx, m);
+                    sums[q].add(fx, m);
+                }
+            }
+            for (std::size_t q = 0; q < count; ++q) {
+                chunk[q] = sums[q].sum();
+            }
+        });
+
+    std::vector<double> result(count);
+    for (std::size_t q = 0; q < count; ++q) {
+        const Function& f = *fs[q];
+        double s = 0.5 * (f(a) + f(b));
+        s += interior[q];
+        result[q] = s * h;
     }
-    return s * h;
+    return result;
+}
+
+std::string TrapezoidSolver::configuration() const {
+    return "Trapezoid(n=" + std::to_string(n_) + summation_suffix(summation_) + ")";
 }
@@ -0,0 +1,415 @@
+#include "VectorMath.h"
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+/*
+Implementation of the vectorized elementary functions.
+
+The algorithms (VectorMathKernels.inc) are written once against a small vector type (Vec) that
+wraps one SIMD register. Vec provides arithmetic, bitwise and 64 bit integer operations on the
+lanes, comparisons that return all-ones / all-zeros lane masks and select(mask, a, b).
+
+cos / sin: Cody-Waite reduction x = q*(pi/2) + r with pi/2 split into three parts, |r| <= pi/4,
+           Cephes minimax polynomials for sin(r) and cos(r), quadrant q chooses polynomial and sign.
+exp:       x = k*ln2 + r, |r| <= ln2/2, fdlibm rational approximation of exp(r), result scaled by 2^k
+           built directly in the exponent bits.
+log:       x = 2^k * m, m in [sqrt(2)/2, sqrt(2)), fdlibm polynomial in s = (m-1)/(m+1).
+
+Runtime dispatch: the kernels are compiled once per instruction set, each copy in its own
+namespace with its own Vec. With GCC / Clang on x86 the SSE2, AVX2 and AVX-512F copies are
+compiled with target pragmas, so the translation unit needs no -m flags and one binary runs on
+every x86-64 CPU; MSVC on x64 gets the SSE2 copy, other architectures the scalar one.
+The first call picks the best copy the CPU supports (CPUID through __builtin_cpu_supports)
+or the one named by the environment variable VMATH_ISA, set_isa switches later.
+The operations of each Vec are free functions next to it, GCC does not apply the target pragmas
+to friend functions defined inside a class.
+*/
+
+// a*b + c stays two roundings in every variant, also where the target has FMA (AVX-512F, -march=native)
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace {
+
+// adding and subtracting 1.5 * 2^52 rounds to the nearest integer,
+// the integer is then also available in the low mantissa bits
+const double round_shifter = 0x1.8p52;
+
+const std::uint64_t sign_mask = 0x8000000000000000ULL;
+
+// largest |x| for which the products in the pi/2 reduction are exact
+const double trig_limit = 0x1p20;
+// exp(x) stays a normal double for |x| <= 708
+const double exp_limit = 708.0;
+
+// lanes of vmath::sum / vmath::dot, a multiple of every vector width
+constexpr std::size_t sum_lanes = 8;
+
+// entry points of one instruction set variant
+struct Kernels {
+    const char* name;
+    void (*cos)(const double*, double*, std::size_t);
+    void (*sin)(const double*, double*, std::size_t);
+    void (*exp)(const double*, double*, std::size_t);
+    void (*log)(const double*, double*, std::size_t);
+    void (*rsqrt)(const double*, double*, std::size_t);
+    double (*sum)(const double*, std::size_t);
+    double (*dot)(const double*, const double*, std::size_t);
+};
+
+namespace scalar_isa {
+
+// portable one-lane fallback, the bit manipulation goes through memcpy
+struct Vec {
+    double v;
+    static constexpr std::size_t width = 1;
+
+    static std::uint64_t bits(double a) { std::uint64_t b; std::memcpy(&b, &a, sizeof b); return b; }
+    static Vec make(std::uint64_t b) { double a; std::memcpy(&a, &b, sizeof a); return {a}; }
+
+    static Vec load(const double* p) { return {*p}; }
+    void store(double* p) const { *p = v; }
+    static Vec broadcast(double a) { return {a}; }
+    static Vec from_bits(std::uint64_t b) { return make(b); }
+
+    static Vec mask(bool m) { return make(m ? ~std::uint64_t{0} : 0); }
+
+    template <int N> static Vec shift_left(Vec a) { return make(bits(a.v) << N); }
+    template <int N> static Vec shift_right(Vec a) { return make(bits(a.v) >> N); }
+};
+
+inline Vec operator+(Vec a, Vec b) { return {a.v + b.v}; }
+inline Vec operator-(Vec a, Vec b) { return {a.v - b.v}; }
+inline Vec operator*(Vec a, Vec b) { return {a.v * b.v}; }
+inline Vec operator/(Vec a, Vec b) { return {a.v / b.v}; }
+inline Vec operator&(Vec a, Vec b) { return Vec::make(Vec::bits(a.v) & Vec::bits(b.v)); }
+inline Vec operator|(Vec a, Vec b) { return Vec::make(Vec::bits(a.v) | Vec::bits(b.v)); }
+inline Vec operator^(Vec a, Vec b) { return Vec::make(Vec::bits(a.v) ^ Vec::bits(b.v)); }
+inline Vec sqrt(Vec a) { return {std::sqrt(a.v)}; }
+
+inline Vec operator<(Vec a, Vec b) { return Vec::mask(a.v < b.v); }
+inline Vec operator<=(Vec a, Vec b) { return Vec::mask(a.v <= b.v); }
+inline Vec operator>(Vec a, Vec b) { return Vec::mask(a.v > b.v); }
+inline Vec operator>=(Vec a, Vec b) { return Vec::mask(a.v >= b.v); }
+inline Vec select(Vec m, Vec a, Vec b) { return Vec::bits(m.v) ? a : b; }
+inline bool all(Vec m) { return Vec::bits(m.v) != 0; }
+
+inline Vec int_add(Vec a, Vec b) { return Vec::make(Vec::bits(a.v) + Vec::bits(b.v)); }
+inline Vec int_sub(Vec a, Vec b) { return Vec::make(Vec::bits(a.v) - Vec::bits(b.v)); }
+
+const char* const isa_name = "scalar";
+
+#include "VectorMathKernels.inc"
+
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VMATH_X86_DISPATCH 1
+
+// compiles the functions up to VMATH_TARGET_POP for the instruction set isa
+#define VMATH_PRAGMA(x) _Pragma(#x)
+#if defined(__clang__)
+#define VMATH_TARGET_PUSH(isa) VMATH_PRAGMA(clang attribute push(__attribute__((target(isa))), apply_to = function))
+#define VMATH_TARGET_POP VMATH_PRAGMA(clang attribute pop)
+#else
+#define VMATH_TARGET_PUSH(isa) VMATH_PRAGMA(GCC push_options) VMATH_PRAGMA(GCC target(isa))
+#define VMATH_TARGET_POP VMATH_PRAGMA(GCC pop_options)
+#endif
+
+#endif
+
+#if defined(VMATH_X86_DISPATCH) || defined(_M_X64)
+
+#if defined(VMATH_X86_DISPATCH)
+VMATH_TARGET_PUSH("sse2")
+#endif
+
+namespace sse2_isa {
+
+struct Vec {
+    __m128d v;
+    static constexpr std::size_t width = 2;
+
+    static Vec load(const double* p) { return {_mm_loadu_pd(p)}; }
+    void store(double* p) const { _mm_storeu_pd(p, v); }
+    static Vec broadcast(double a) { return {_mm_set1_pd(a)}; }
+    static Vec from_bits(std::uint64_t b) {
+        return {_mm_castsi128_pd(_mm_set1_epi64x(static_cast<long long>(b)))};
+    }
+
+    template <int N> static Vec shift_left(Vec a) {
+        return {_mm_castsi128_pd(_mm_slli_epi64(_mm_castpd_si128(a.v), N))};
+    }
+    template <int N> static Vec shift_right(Vec a) {
+        return {_mm_castsi128_pd(_mm_srli_epi64(_mm_castpd_si128(a.v), N))};
+    }
+};
+
+inline Vec operator+(Vec a, Vec b) { return {_mm_add_pd(a.v, b.v)}; }
+inline Vec operator-(Vec a, Vec b) { return {_mm_sub_pd(a.v, b.v)}; }
+inline Vec operator*(Vec a, Vec b) { return {_mm_mul_pd(a.v, b.v)}; }
+inline Vec operator/(Vec a, Vec b) { return {_mm_div_pd(a.v, b.v)}; }
+inline Vec operator&(Vec a, Vec b) { return {_mm_and_pd(a.v, b.v)}; }
+inline Vec operator|(Vec a, Vec b) { return {_mm_or_pd(a.v, b.v)}; }
+inline Vec operator^(Vec a, Vec b) { return {_mm_xor_pd(a.v, b.v)}; }
+inline Vec sqrt(Vec a) { return {_mm_sqrt_pd(a.v)}; }
+
+// comparisons return lane masks
+inline Vec operator<(Vec a, Vec b) { return {_mm_cmplt_pd(a.v, b.v)}; }
+inline Vec operator<=(Vec a, Vec b) { return {_mm_cmple_pd(a.v, b.v)}; }
+inline Vec operator>(Vec a, Vec b) { return {_mm_cmpgt_pd(a.v, b.v)}; }
+inline Vec operator>=(Vec a, Vec b) { return {_mm_cmpge_pd(a.v, b.v)}; }
+// SSE2 has no blend instruction, combine with and / andnot / or
+inline Vec select(Vec mask, Vec a, Vec b) {
+    return {_mm_or_pd(_mm_and_pd(mask.v, a.v), _mm_andnot_pd(mask.v, b.v))};
+}
+inline bool all(Vec mask) { return _mm_movemask_pd(mask.v) == 0x3; }
+
+// 64 bit integer operations on the raw lane bits
+inline Vec int_add(Vec a, Vec b) {
+    return {_mm_castsi128_pd(_mm_add_epi64(_mm_castpd_si128(a.v), _mm_castpd_si128(b.v)))};
+}
+inline Vec int_sub(Vec a, Vec b) {
+    return {_mm_castsi128_pd(_mm_sub_epi64(_mm_castpd_si128(a.v), _mm_castpd_si128(b.v)))};
+}
+
+const char* const isa_name = "sse2";
+
+#include "VectorMathKernels.inc"
+
+}
+
+#if defined(VMATH_X86_DISPATCH)
+VMATH_TARGET_POP
+#endif
+
+#endif
+
+#if defined(VMATH_X86_DISPATCH)
+
+VMATH_TARGET_PUSH("avx2")
+
+namespace avx2_isa {
+
+struct Vec {
+    __m256d v;
+    static constexpr std::size_t width = 4;
+
+    static Vec load(const double* p) { return {_mm256_loadu_pd(p)}; }
+    void store(double* p) const { _mm256_storeu_pd(p, v); }
+    static Vec broadcast(double a) { return {_mm256_set1_pd(a)}; }
+    static Vec from_bits(std::uint64_t b) {
+        return {_mm256_castsi256_pd(_mm256_set1_epi64x(static_cast<long long>(b)))};
+    }
+
+    template <int N> static Vec shift_left(Vec a) {
+        return {_mm256_castsi256_pd(_mm256_slli_epi64(_mm256_castpd_si256(a.v), N))};
+    }
+    template <int N> static Vec shift_right(Vec a) {
+        return {_mm256_castsi256_pd(_mm256_srli_epi64(_mm256_castpd_si256(a.v), N))};
+    }
+};
+
+inline Vec operator+(Vec a, Vec b) { return {_mm256_add_pd(a.v, b.v)}; }
+inline Vec operator-(Vec a, Vec b) { return {_mm256_sub_pd(a.v, b.v)}; }
+inline Vec operator*(Vec a, Vec b) { return {_mm256_mul_pd(a.v, b.v)}; }
+inline Vec operator/(Vec a, Vec b) { return {_mm256_div_pd(a.v, b.v)}; }
+inline Vec operator&(Vec a, Vec b) { return {_mm256_and_pd(a.v, b.v)}; }
+inline Vec operator|(Vec a, Vec b) { return {_mm256_or_pd(a.v, b.v)}; }
+inline Vec operator^(Vec a, Vec b) { return {_mm256_xor_pd(a.v, b.v)}; }
+inline Vec sqrt(Vec a) { return {_mm256_sqrt_pd(a.v)}; }
+
+// comparisons return lane masks
+inline Vec operator<(Vec a, Vec b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ)}; }
+inline Vec operator<=(Vec a, Vec b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_LE_OQ)}; }
+inline Vec operator>(Vec a, Vec b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ)}; }
+inline Vec operator>=(Vec a, Vec b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_GE_OQ)}; }
+inline Vec select(Vec mask, Vec a, Vec b) { return {_mm256_blendv_pd(b.v, a.v, mask.v)}; }
+inline bool all(Vec mask) { return _mm256_movemask_pd(mask.v) == 0xF; }
+
+// 64 bit integer operations on the raw lane bits
+inline Vec int_add(Vec a, Vec b) {
+    return {_mm256_castsi256_pd(_mm256_add_epi64(_mm256_castpd_si256(a.v), _mm256_castpd_si256(b.v)))};
+}
+inline Vec int_sub(Vec a, Vec b) {
+    return {_mm256_castsi256_pd(_mm256_sub_epi64(_mm256_castpd_si256(a.v), _mm256_castpd_si256(b.v)))};
+}
+
+const char* const isa_name = "avx2";
+
+#include "VectorMathKernels.inc"
+
+}
+
+VMATH_TARGET_POP
+
+VMATH_TARGET_PUSH("avx512f")
+
+namespace avx512_isa {
+
+// AVX-512F has the bitwise operations for 64 bit integer lanes only (the _pd versions are
+// AVX-512DQ), comparisons return a bit mask that is expanded to lane masks for the kernels.
+// sqrt and the shifts use the zero-masked forms with a full mask: the unmasked ones start from
+// _mm512_undefined_*, which GCC 12 reports with -Wmaybe-uninitialized
+struct Vec {
+    __m512d v;
+    static constexpr std::size_t width = 8;
+
+    static __m512i bits(Vec a) { return _mm512_castpd_si512(a.v); }
+    static Vec make(__m512i b) { return {_mm512_castsi512_pd(b)}; }
+    static Vec mask(__mmask8 m) { return make(_mm512_maskz_set1_epi64(m, -1)); }
+    static __mmask8 lanes(Vec m) { return _mm512_test_epi64_mask(bits(m), bits(m)); }
+
+    static Vec load(const double* p) { return {_mm512_loadu_pd(p)}; }
+    void store(double* p) const { _mm512_storeu_pd(p, v); }
+    static Vec broadcast(double a) { return {_mm512_set1_pd(a)}; }
+    static Vec from_bits(std::uint64_t b) { return make(_mm512_set1_epi64(static_cast<long long>(b))); }
+
+    template <int N> static Vec shift_left(Vec a) { return make(_mm512_maskz_slli_epi64(0xFF, bits(a), N)); }
+    template <int N> static Vec shift_right(Vec a) { return make(_mm512_maskz_srli_epi64(0xFF, bits(a), N)); }
+};
+
+inline Vec operator+(Vec a, Vec b) { return {_mm512_add_pd(a.v, b.v)}; }
+inline Vec operator-(Vec a, Vec b) { return {_mm512_sub_pd(a.v, b.v)}; }
+inline Vec operator*(Vec a, Vec b) { return {_mm512_mul_pd(a.v, b.v)}; }
+inline Vec operator/(Vec a, Vec b) { return {_mm512_div_pd(a.v, b.v)}; }
+inline Vec operator&(Vec a, Vec b) { return Vec::make(_mm512_and_si512(Vec::bits(a), Vec::bits(b))); }
+inline Vec operator|(Vec a, Vec b) { return Vec::make(_mm512_or_si512(Vec::bits(a), Vec::bits(b))); }
+inline Vec operator^(Vec a, Vec b) { return Vec::make(_mm512_xor_si512(Vec::bits(a), Vec::bits(b))); }
+inline Vec sqrt(Vec a) { return {_mm512_maskz_sqrt_pd(0xFF, a.v)}; }
+
+// comparisons return lane masks
+inline Vec operator<(Vec a, Vec b) { return Vec::mask(_mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ)); }
+inline Vec operator<=(Vec a, Vec b) { return Vec::mask(_mm512_cmp_pd_mask(a.v, b.v, _CMP_LE_OQ)); }
+inline Vec operator>(Vec a, Vec b) { return Vec::mask(_mm512_cmp_pd_mask(a.v, b.v, _CMP_GT_OQ)); }
+inline Vec operator>=(Vec a, Vec b) { return Vec::mask(_mm512_cmp_pd_mask(a.v, b.v, _CMP_GE_OQ)); }
+inline Vec select(Vec m, Vec a, Vec b) { return {_mm512_mask_blend_pd(Vec::lanes(m), b.v, a.v)}; }
+inline bool all(Vec m) { return Vec::lanes(m) == 0xFF; }
+
+// 64 bit integer operations on the raw lane bits
+inline Vec int_add(Vec a, Vec b) { return Vec::make(_mm512_add_epi64(Vec::bits(a), Vec::bits(b))); }
+inline Vec int_sub(Vec a, Vec b) { return Vec::make(_mm512_sub_epi64(Vec::bits(a), Vec::bits(b))); }
+
+const char* const isa_name = "avx512";
+
+#include "VectorMathKernels.inc"
+
+}
+
+VMATH_TARGET_POP
+
+// __builtin_cpu_supports also checks that the OS saves the wider registers
+bool cpu_sse2() { __builtin_cpu_init(); return __builtin_cpu_supports("sse2"); }
+bool cpu_avx2() { __builtin_cpu_init(); return __builtin_cpu_supports("avx2"); }
+bool cpu_avx512() { __builtin_cpu_init(); return __builtin_cpu_supports("avx512f"); }
+
+#endif
+
+bool cpu_any() { return true; }
+
+// the variants of this build, best first
+struct Variant {
+    const Kernels& kernels;
+    bool (*supported)();
+};
+
+const Variant variants[] = {
+#if defined(VMATH_X86_DISPATCH)
+    {avx512_isa::kernels, cpu_avx512},
+    {avx2_isa::kernels, cpu_avx2},
+    {sse2_isa::kernels, cpu_sse2},
+#elif defined(_M_X64)
+    {sse2_isa::kernels, cpu_any},
+#endif
+    {scalar_isa::kernels, cpu_any},
+};
+
+const Variant* find_variant(const char* name) {
+    if (!name) return nullptr;
+    for (const Variant& v : variants) {
+        if (std::strcmp(v.kernels.name, name) == 0) return &v;
+    }
+    return nullptr;
+}
+
+// VMATH_ISA if this build has it and the CPU supports it, else the best supported variant
+const Kernels* initial_kernels() {
+    const Variant* forced = find_variant(std::getenv("VMATH_ISA"));
+    if (forced && forced->supported()) return &forced->kernels;
+    for (const Variant& v : variants) {
+        if (v.supported()) return &v.kernels;
+    }
+    return &scalar_isa::kernels;
+}
+
+std::atomic<const Kernels*> active_kernels{nullptr};
+
+// the variant in use, selected on the first call
+const Kernels& current() {
+    const Kernels* k = active_kernels.load(std::memory_order_acquire);
+    if (!k) {
+        k = initial_kernels();
+        active_kernels.store(k, std::memory_order_release);
+    }
+    return *k;
+}
+
+}
+
+namespace vmath {
+
+void cos(const double* x, double* out, std::size_t n) {
+    current().cos(x, out, n);
+}
+
+void sin(const double* x, double* out, std::size_t n) {
+    current().sin(x, out, n);
+}
+
+void exp(const double* x, double* out, std::size_t n) {
+    current().exp(x, out, n);
+}
+
+void log(const double* x, double* out, std::size_t n) {
+    current().log(x, out, n);
+}
+
+void rsqrt(const double* x, double* out, std::size_t n) {
+    current().rsqrt(x, out, n);
+}
+
+double sum(const double* x, std::size_t n) {
+    return current().sum(x, n);
+}
+
+double dot(const double* w, const double* x, std::size_t n) {
+    return current().dot(w, x, n);
+}
+
+const char* isa() {
+    return current().name;
+}
+
+bool isa_supported(const char* name) {
+    const Variant* v = find_variant(name);
+    return v && v->supported();
+}
+
+bool set_isa(const char* name) {
+    const Variant* v = find_variant(name);
+    if (!v || !v->supported()) return false;
+    active_kernels.store(&v->kernels, std::memory_order_release);
+    return true;
+}
+
+}
@@ -0,0 +1,174 @@
+#include "VegasSolver.h"
+#include "Philox.h"
+#include "RunningStats.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+/*
+Implementation of the 1D VEGAS solver.
+
+Grid edges e_0 = a < e_1 < ... < e_N = b, widths w_k. A uniform u in (0,1) is mapped to
+y = N u, bin k = floor(y), x = e_k + (y - k) w_k, so the sampling density is 1 / (N w_k) in bin k
+and every sample contributes f(x) · J with J = N w_k.
+*/
+
+namespace {
+
+// exponent of the damping in the grid refinement (Lepage's alpha)
+constexpr double refinement_damping = 1.5;
+
+// new edges such that every bin holds the same share of the (smoothed, damped) importance d_k
+void refine_grid(std::vector<double>& edges, const std::vector<double>& d) {
+    const std::size_t N = d.size();
+    if (N < 2) return;
+
+    // smooth with the neighbours, then normalize
+    std::vector<double> smooth(N);
+    smooth[0] = 0.5 * (d[0] + d[1]);
+    smooth[N - 1] = 0.5 * (d[N - 2] + d[N - 1]);
+    for (std::size_t k = 1; k + 1 < N; ++k) {
+        smooth[k] = (d[k - 1] + d[k] + d[k + 1]) / 3.0;
+    }
+    double total = 0.0;
+    for (double s : smooth) total += s;
+    if (!(total > 0.0) || !std::isfinite(total)) return;
+
+    // damped importance m_k = ((r_k - 1) / ln r_k)^alpha, r_k = smooth_k / total
+    std::vector<double> importance(N);
+    double importance_total = 0.0;
+    for (std::size_t k = 0; k < N; ++k) {
+        const double r = smooth[k] / total;
+        importance[k] = (r > 0.0 && r < 1.0) ? std::pow((r - 1.0) / std::log(r), refinement_damping)
+                                             : (r >= 1.0 ? 1.0 : 0.0);
+        importance_total += importance[k];
+    }
+    if (!(importance_total > 0.0)) return;
+
+    // walk through the old bins and place a new edge whenever another N-th of the importance is collected
+    const double per_bin = importance_total / static_cast<double>(N);
+    std::vector<double> new_edges(N + 1);
+    new_edges[0] = edges[0];
+    new_edges[N] = edges[N];
+    std::size_t old_bin = 0;
+    double collected = 0.0;  // importance of the old bins before old_bin
+    for (std::size_t k = 1; k < N; ++k) {
+        const double target = per_bin * static_cast<double>(k);
+        while (old_bin + 1 < N && collected + importance[old_bin] < target) {
+            collected += importance[old_bin];
+            ++old_bin;
+        }
+        // linear inside the old bin
+        const double fraction = importance[old_bin] > 0.0
+            ? std::min(1.0, (target - collected) / importance[old_bin]) : 0.0;
+        new_edges[k] = edges[old_bin] + fraction * (edges[old_bin + 1] - edges[old_bin]);
+        new_edges[k] = std::max(new_edges[k], new_edges[k - 1]);
+    }
+    edges.swap(new_edges);
+}
+
+}
+
+VegasSolver::VegasSolver(std::size_t n, std::size_t bins, std::size_t iterations,
+                         std::uint64_t seed, unsigned threads)
+    : n_(std::max(n, 2 * (iterations ? iterations : 1))), bins_(bins ? bins : 1),
+      iterations_(iterations ? iterations : 1), seed_(seed), threads_(resolve_threads(threads)) {}
+
+double VegasSolver::integrate(const Function& f, double a, double b) const {
+    return integrate_vegas(f, a, b).value;
+}
+
+VegasSolver::Result VegasSolver::integrate_vegas(const Function& f, double a, double b) const {
+    validate_interval(a, b);
+    const std::uint64_t actual_seed = (seed_ != 0) ? seed_ : std::random_device{}();
+    const Philox4x32 rng(actual_seed);
+    const std::size_t N = bins_;
+
+    // start with the uniform grid
+    std::vector<double> edges(N + 1);
+    for (std::size_t k = 0; k <= N; ++k) {
+        edges[k] = a + (b - a) * static_cast<double>(k) / static_cast<double>(N);
+    }
+    edges[N] = b;
+
+    std::vector<double> estimates(iterations_);
+    std::vector<double> variances(iterations_);
+    std::size_t first = 0;  // index of the first sample of the pass
+    for (std::size_t it = 0; it < iterations_; ++it) {
+        const std::size_t count = n_ / iterations_ + (it < n_ % iterations_ ? 1 : 0);
+
+        // per chunk: statistics of f·J and Σ (f·J)² per bin for the refinement
+        const std::size_t chunks = (count + chunk_size - 1) / chunk_size;
+        std::vector<RunningStats> partial(chunks);
+        std::vector<double> partial_d(chunks * N, 0.0);
+        parallel_chunks(count, chunk_size, threads_, [&](std::size_t c, std::size_t begin, std::size_t end) {
+            double xs[block_size];
+            double jacobian[block_size];
+            std::size_t bin[block_size];
+            double fx[block_size];
+            double* d = partial_d.data() + c * N;
+            for (std::size_t i = begin; i < end; i += block_size) {
+                const std::size_t m = std::min(block_size, end - i);
+                for (std::size_t k = 0; k < m; ++k) {
+                    const Philox4x32::result_type r = rng(static_cast<std::uint64_t>(first + i + k));
+                    const double y = static_cast<double>(N) * Philox4x32::to_open_unit(r[0], r[1]);
+                    const std::size_t kb = std::min(static_cast<std::size_t>(y), N - 1);
+                    const double width = edges[kb + 1] - edges[kb];
+                    bin[k] = kb;
+                    xs[k] = edges[kb] + (y - static_cast<double>(kb)) * width;
+                    jacobian[k] = static_cast<double>(N) * width;
+                }
+                f.evaluate(xs, fx, m);
+                for (std::size_t k = 0; k < m; ++k) {
+                    const double w = fx[k] * jacobian[k];
+                    partial[c].add(w);
+                    d[bin[k]] += w * w;
+                }
+            }
+        });
+
+        RunningStats stats;
+        std::vector<double> d(N, 0.0);
+        for (std::size_t c = 0; c < chunks; ++c) {
+            stats.merge(partial[c]);
+            for (std::size_t k = 0; k < N; ++k) {
+                d[k] += partial_d[c * N + k];
+            }
+        }
+        estimates[it] = stats.mean();
+        variances[it] = stats.variance() / static_cast<double>(stats.count());
+        first += count;
+
+        if (it + 1 < iterations_) refine_grid(edges, d);
+    }
+
+    // inverse-variance weighted combination of the passes
+    // a pass with zero variance (f constant on the samples) gets a large but finite weight
+    double weight_total = 0.0;
+    double weighted_sum = 0.0;
+    for (std::size_t it = 0; it < iterations_; ++it) {
+        const double weight = 1.0 / std::max(variances[it], 1e-300);
+        weight_total += weight;
+        weighted_sum += weight * estimates[it];
+    }
+    Result result;
+    result.value = weighted_sum / weight_total;
+    result.error = 1.0 / std::sqrt(weight_total);
+    double chi2 = 0.0;
+    for (std::size_t it = 0; it < iterations_; ++it) {
+        const double diff = estimates[it] - result.value;
+        chi2 += diff * diff / std::max(variances[it], 1e-300);
+    }
+    result.chi2_per_dof = iterations_ > 1 ? chi2 / static_cast<double>(iterations_ - 1) : 0.0;
+    result.samples = n_;
+    result.iterations = iterations_;
+    return result;
+}
+
+std::string VegasSolver::configuration() const {
+    // seed 0 draws a new random seed on every call, the result is not reproducible
+    if (seed_ == 0) return std::string();
+    return "Vegas(n=" + std::to_string(n_) + ",bins=" + std::to_string(bins_) + ",iterations="
+         + std::to_string(iterations_) + ",seed=" + std::to_string(seed_) + ")";
+}
@@ -1,43 +1,33 @@
 #include "Weddle2DSolver.h"
+#include "TensorProduct.h"
 
 /*
 Implementation fo the 2D Weddle Solver.
-Tensor product extension: corners + edge midpoints + cell midpoints
+Tensor product extension: corners + edge midpoints + cell midpoints, evaluated in one tiled pass
 */
 
 double Weddle2DSolver::integrate(const Function2D& f,
                                   double a, double b,
                                   double c, double d) const {
+    return integrate_many({&f}, a, b, c, d)[0];
+}
+
+std::vector<double> Weddle2DSolver::integrate_many(const std::vector<const Function2D*>& fs,
+                                                   double a, double b,
+                                                   double c, double d) const {
     validate_intervals(a, b, c, d);
     
-    const double hx = (b - a) / static_cast<double>(nx_);
-    const double hy = (d - c) / static_cast<double>(ny_);
-    
-    // Corner points
-    double sum = f(a, c) + f(a, d) + f(b, c) + f(b, d);
-    
-    // Edge midpoints in x direction (top and bottom edges)
-    for (std::size_t i = 0; i < nx_; ++i) {
-        double x_mid = a + (static_cast<double>(i) + 0.5) * hx;
-        sum += 2.0 * f(x_mid, c);  // bottom edge
-        sum += 2.0 * f(x_mid, d);  // top edge
-    }
-    
-    // Edge midpoints in y direction (left and right edges)
-    for (std::size_t j = 0; j < ny_; ++j) {
-        double y_mid = c + (static_cast<double>(j) + 0.5) * hy;
-        sum += 2.0 * f(a, y_mid);  // left edge
-        sum += 2.0 * f(b, y_mid);  // right edge
-    }
-    
-    // Interior midpoints
-    for (std::size_t i = 0; i < nx_; ++i) {
-        double x_mid = a + (static_cast<double>(i) + 0.5) * hx;
-        for (std::size_t j = 0; j < ny_; ++j) {
-            double y_mid = c + (static_cast<double>(j) + 0.5) * hy;
-            sum += 4.0 * f(x_mid, y_mid);
-        }
+    const TensorRule1D x_rule = weddle_rule(a, b, nx_);
+    const TensorRule1D y_rule = weddle_rule(c, d, ny_);
+
+    std::vector<double> sum = tensor_product_sum(fs, x_rule.nodes, x_rule.weights,
+                                                 y_rule.nodes, y_rule.weights, threads_, summation_);
+    for (double& s : sum) {
+        s *= x_rule.scale * y_rule.scale;
     }
-    
-    return sum * (hx * hy / 4.0);
-}
\ No newline at end of file
+    return sum;
+}
+
+std::string Weddle2DSolver::configuration() const {
+    return "Weddle2D(nx=" + std::to_string(nx_) + ",ny=" + std::to_string(ny_) + summation_suffix(summation_) + ")";
+}
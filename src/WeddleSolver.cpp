@@ -1,4 +1,5 @@
 #include "WeddleSolver.h"
+#include <algorithm>
 
 
 /*
@@ -11,12 +12,46 @@ Error: O(h²)
 
 */
 double WeddleSolver::integrate(const Function& f, double a, double b) const {
+    return kernels::weddle(f, a, b, n_, threads_, summation_);
+}
+
+std::vector<double> WeddleSolver::integrate_many(const std::vector<const Function*>& fs, double a, double b) const {
     validate_interval(a, b);
+    const std::size_t count = fs.size();
     const double h = (b - a) / static_cast<double>(n_);
-    double sum = f(a) + f(b);
-    for (std::size_t i = 0; i < n_; ++i) {
-        double x_midpoint = a + (static_cast<double>(i) + 0.5) * h;
-        sum += 2.0 * f(x_midpoint);
+
+    // midpoints split into fixed chunks that are summed in parallel,
+    // within a chunk they are generated in blocks, every integrand is evaluated on the same block
+    const std::vector<double> mid = parallel_sum(n_, chunk_size, threads_, count,
+        [&](std::size_t begin, std::size_t end, double* chunk) {
+            double xs[block_size];
+            double fx[block_size];
+            std::vector<Accumulator> sums(count, Accumulator(summation_));
+            for (std::size_t i = begin; i < end; i += block_size) {
+                const std::size_t m = std::min(block_size, end - i);
+                for (std::size_t k = 0; k < m; ++k) {
+                    xs[k] = a + (static_cast<double>(i + k) + 0.5) * h;
+                }
+                for (std::size_t q = 0; q < count; ++q) {
+                    fs[q]->evaluate(xs, fx, m);
+                    sums[q].add(fx, m);
+                }
+            }
+            for (std::size_t q = 0; q < count; ++q) {
+                chunk[q] = sums[q].sum();
+            }
+        });
+
+    std::vector<double> result(count);
+    for (std::size_t q = 0; q < count; ++q) {
+        const Function& f = *fs[q];
+        double sum = f(a) + f(b);
+        sum += 2.0 * mid[q];
+        result[q] = sum * (h / 2.0);
     }
-    return sum * (h / 2.0);
+    return result;
+}
+
+std::string WeddleSolver::configuration() const {
+    return "Weddle(n=" + std::to_string(n_) + summation_suffix(summation_) + ")";
 }
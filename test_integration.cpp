@@ -1,17 +1,101 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <functional>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <vector>
+#include <stdexcept>
 #include <string>
+#include <thread>
 
 #include "FunctionsConcrete.h"
 #include "TrapezoidSolver.h"
 #include "SimpsonSolver.h"
 #include "WeddleSolver.h"
 #include "MonteCarloSolver.h"
+#include "ParallelSum.h"
+#include "Philox.h"
+#include "AdaptiveGKSolver.h"
+#include "RombergSolver.h"
+#include "GaussLegendreSolver.h"
+#include "GaussLegendre2DSolver.h"
+#include "TanhSinhSolver.h"
+#include "CachedSolver.h"
+#include "Functions2DConcrete.h"
+#include "MonteCarlo2DSolver.h"
+#include "LowDiscrepancy.h"
+#include "QuasiMonteCarloSolver.h"
+#include "QuasiMonteCarlo2DSolver.h"
+#include "StratifiedMonteCarloSolver.h"
+#include "ImportanceMonteCarloSolver.h"
+#include "VegasSolver.h"
+#include "Trapezoid2DSolver.h"
+#include "Simpson2DSolver.h"
+#include "Weddle2DSolver.h"
+#include "SeparableFunction2D.h"
+#include "CountingFunction.h"
+#include "FunctionND.h"
+#include "TrapezoidNDSolver.h"
+#include "SimpsonNDSolver.h"
+#include "WeddleNDSolver.h"
+#include "GaussLegendreNDSolver.h"
+#include "MonteCarloNDSolver.h"
+#include "IntegrationKernels.h"
+#include "SparseGridNDSolver.h"
+#include "SparseGrid2DSolver.h"
+#include "Accumulator.h"
+#include "Expression.h"
+#include "InstrumentedSolver.h"
+#include "AutoSolver.h"
+#include "VectorMath.h"
+#include "Samples.h"
+#include "SampledTrapezoidSolver.h"
+#include "SampledSimpsonSolver.h"
 
 
+// Forwards to another Function2D without deriving from SeparableFunction2D,
+// forces the grid solvers to evaluate it on every grid point
+class GridOnly : public Function2D {
+public:
+    explicit GridOnly(const Function2D& f) : f_(f) {}
+    double operator()(double x, double y) const override { return f_(x, y); }
+    void evaluate(const double* x, const double* y, double* out, std::size_t n) const override {
+        f_.evaluate(x, y, out, n);
+    }
+
+private:
+    const Function2D& f_;
+};
+
+// e^(x_0 + ... + x_(D-1)), integral over the unit cube (e - 1)^D
+template <std::size_t D>
+class ExpSumND : public FunctionND<D> {
+public:
+    double operator()(const typename FunctionND<D>::Point& x) const override {
+        double s = 0.0;
+        for (double v : x) s += v;
+        return std::exp(s);
+    }
+};
+
+// e^(x_0), the other coordinates are ignored; counts its evaluations
+template <std::size_t D>
+class FirstCoordinateExpND : public FunctionND<D> {
+public:
+    double operator()(const typename FunctionND<D>::Point& x) const override {
+        ++count;
+        return std::exp(x[0]);
+    }
+    mutable std::size_t count = 0;
+};
+
 // Helper function for floating point comparison
 bool approx_equal(double value, double reference, double tolerance) {
     return std::abs(value - reference) < tolerance;
@@ -172,6 +256,1206 @@ int main() {
         if (passed) tests_passed++;
     }
 
+    // THREAD SCALING
+    // The multithreaded solvers split the nodes into fixed chunks and combine the partial sums
+    // in a fixed order, so every thread count has to give the bit-identical result.
+    // The timings show the speedup from 1 to N threads.
+    {
+        const std::size_t n_scaling = 300000;
+        const unsigned max_threads = std::max(4u, resolve_threads(0));
+
+        std::cout << "\nThread scaling (n=" << n_scaling << ", up to " << max_threads << " threads)\n";
+
+        struct Integral {
+            std::string name;
+            const Function* f;
+            double a;
+        };
+        const std::vector<Integral> integrals = {
+            {"f1", &f1, 0.0}, {"f2", &f2, 0.0}, {"f3", &f3, epsilon}, {"f4", &f4, epsilon}
+        };
+
+        using SolverFactory = std::function<std::unique_ptr<Solver>(unsigned)>;
+        const std::vector<std::pair<std::string, SolverFactory>> factories = {
+            {"Trapezoid", [&](unsigned t) { return std::make_unique<TrapezoidSolver>(n_scaling, t); }},
+            {"Simpson",   [&](unsigned t) { return std::make_unique<SimpsonSolver>(n_scaling, t); }},
+            {"Weddle",    [&](unsigned t) { return std::make_unique<WeddleSolver>(n_scaling, t); }}
+        };
+
+        for (const Integral& integral : integrals) {
+            for (const auto& factory : factories) {
+                double reference = 0.0;
+                double reference_time = 0.0;
+                bool passed = true;
+                std::cout << "  " << integral.name << " " << factory.first << ":";
+                for (unsigned t = 1; t <= max_threads; t *= 2) {
+                    std::unique_ptr<Solver> solver = factory.second(t);
+                    const auto start = std::chrono::steady_clock::now();
+                    const double val = solver->integrate(*integral.f, integral.a, 1.0);
+                    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                    if (t == 1) {
+                        reference = val;
+                        reference_time = elapsed.count();
+                    }
+                    passed = passed && (val == reference);
+                    std::cout << "  " << t << "T x" << (reference_time / elapsed.count());
+                }
+                std::cout << (passed ? " [PASS]" : " [FAIL - result depends on thread count]") << "\n";
+                tests_total++;
+                if (passed) tests_passed++;
+            }
+        }
+
+        // the shared worker pool: nested calls from inside a chunk, concurrent callers and an
+        // exception in a chunk, none of them may deadlock or lose a chunk
+        std::atomic<std::size_t> visited{0};
+        parallel_chunks(16, 1, 4, [&](std::size_t, std::size_t, std::size_t) {
+            parallel_chunks(8, 1, 4, [&](std::size_t, std::size_t, std::size_t) { ++visited; });
+        });
+        const double reference = TrapezoidSolver(100000, 4).integrate(f1, 0.0, 1.0);
+        std::atomic<int> same{0};
+        std::vector<std::thread> callers;
+        for (int t = 0; t < 4; ++t) {
+            callers.emplace_back([&] {
+                for (int k = 0; k < 20; ++k) {
+                    if (TrapezoidSolver(100000, 4).integrate(f1, 0.0, 1.0) == reference) ++same;
+                }
+            });
+        }
+        for (std::thread& t : callers) {
+            t.join();
+        }
+        bool thrown = false;
+        try {
+            parallel_chunks(64, 1, 4, [](std::size_t c, std::size_t, std::size_t) {
+                if (c == 17) throw std::runtime_error("chunk 17");
+            });
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        const bool pool_passed = visited == 16 * 8 && same == 80 && thrown;
+        std::cout << "  worker pool: nested, concurrent, exception" << (pool_passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (pool_passed) tests_passed++;
+    }
+
+    // PARALLEL MONTE CARLO
+    // Philox4x32-10 has to reproduce the known answers of the reference implementation (Random123),
+    // and the counter-based Monte Carlo estimate for a fixed seed must not depend on the thread count.
+    {
+        std::cout << "\nParallel Monte Carlo (counter-based Philox stream)\n";
+
+        const Philox4x32::result_type kat0 = Philox4x32(0)(0u, 0u, 0u, 0u);
+        const Philox4x32::result_type kat1 = Philox4x32(0x299f31d0a4093822ULL)(0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u);
+        const bool kat_passed = kat0 == Philox4x32::result_type{0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u}
+                             && kat1 == Philox4x32::result_type{0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u};
+        std::cout << "  Philox4x32-10 known answers" << (kat_passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (kat_passed) tests_passed++;
+
+        const std::size_t n_mc = 2000000;
+        const unsigned max_threads = std::max(4u, resolve_threads(0));
+        const MonteCarloSolver mc_reference(n_mc, 42, MonteCarloSolver::Mode::Parallel, 1);
+        const double reference = mc_reference.integrate(f3, epsilon, 1.0);
+        bool passed = approx_equal(reference, true_f3_adjusted, 1e-2);
+        for (unsigned t = 2; t <= max_threads; t *= 2) {
+            const MonteCarloSolver mc(n_mc, 42, MonteCarloSolver::Mode::Parallel, t);
+            passed = passed && (mc.integrate(f3, epsilon, 1.0) == reference);
+        }
+        std::cout << "  Monte Carlo f3, 1.." << max_threads << " threads: " << reference
+                  << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        G1 g1;
+        const MonteCarlo2DSolver mc2d_reference(n_mc, 42, MonteCarlo2DSolver::Mode::Parallel, 1);
+        const double reference_2d = mc2d_reference.integrate(g1, 0.0, 1.0, 0.0, 1.0);
+        bool passed_2d = approx_equal(reference_2d, 2.0 / 3.0, tol_monte_carlo);
+        for (unsigned t = 2; t <= max_threads; t *= 2) {
+            const MonteCarlo2DSolver mc2d(n_mc, 42, MonteCarlo2DSolver::Mode::Parallel, t);
+            passed_2d = passed_2d && (mc2d.integrate(g1, 0.0, 1.0, 0.0, 1.0) == reference_2d);
+        }
+        std::cout << "  Monte Carlo 2D g1, 1.." << max_threads << " threads: " << reference_2d
+                  << (passed_2d ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed_2d) tests_passed++;
+    }
+
+    // ADAPTIVE GAUSS-KRONROD
+    // Smooth integrands converge in a few hundred evaluations at most, the singular ones
+    // are integrated over the true interval [0,1] since the rule never evaluates the endpoints.
+    {
+        std::cout << "\nAdaptive Gauss-Kronrod (tol=1e-10)\n";
+        const AdaptiveGKSolver gk(1e-10, 1e-10);
+
+        struct Case {
+            std::string name;
+            const Function* f;
+            double a;
+            double true_value;
+            std::size_t max_evaluations;
+        };
+        const std::vector<Case> cases = {
+            {"f1 on [0,1]", &f1, 0.0, true_f1, 300},
+            {"f2 on [0,1]", &f2, 0.0, true_f2, 300},
+            {"f3 on [0,1]", &f3, 0.0, true_f3, 5000},
+            {"f4 on [0,1]", &f4, 0.0, true_f4, 5000}
+        };
+        for (const Case& c : cases) {
+            const AdaptiveGKSolver::Result r = gk.integrate_adaptive(*c.f, c.a, 1.0);
+            const bool passed = r.converged && approx_equal(r.value, c.true_value, 1e-9)
+                             && r.evaluations <= c.max_evaluations;
+            std::cout << "  " << c.name << ": " << r.value << " (estimated error " << r.error
+                      << ", " << r.evaluations << " evaluations)"
+                      << (passed ? " [PASS]" : " [FAIL]") << "\n";
+            tests_total++;
+            if (passed) tests_passed++;
+        }
+    }
+
+    // ROMBERG
+    // On the smooth integrands the extrapolated nested trapezoid sequence has to reach 1e-10
+    // with a tiny fraction of the evaluations TrapezoidSolver(100000) needs for 1e-5.
+    {
+        std::cout << "\nRomberg (tol=1e-10)\n";
+        const RombergSolver romberg(1e-10, 1e-10);
+
+        const RombergSolver::Result r1 = romberg.integrate_romberg(f1, 0.0, 1.0);
+        const RombergSolver::Result r2 = romberg.integrate_romberg(f2, 0.0, 1.0);
+        const std::vector<std::pair<std::string, std::pair<RombergSolver::Result, double>>> cases = {
+            {"f1 on [0,1]", {r1, true_f1}},
+            {"f2 on [0,1]", {r2, true_f2}}
+        };
+        for (const auto& c : cases) {
+            const RombergSolver::Result& r = c.second.first;
+            const bool passed = r.converged && approx_equal(r.value, c.second.second, 1e-10)
+                             && r.evaluations <= 257;
+            std::cout << "  " << c.first << ": " << r.value << " (" << r.levels << " levels, "
+                      << r.evaluations << " evaluations)"
+                      << (passed ? " [PASS]" : " [FAIL]") << "\n";
+            tests_total++;
+            if (passed) tests_passed++;
+        }
+    }
+
+    // GAUSS-LEGENDRE
+    // 16 points reach machine precision on the smooth 1D and 2D integrands.
+    {
+        std::cout << "\nGauss-Legendre (order 16)\n";
+        const double tol_gauss = 1e-13;
+        const GaussLegendreSolver gl(16);
+        const GaussLegendreSolver gl_composite(8, 10);
+        const GaussLegendre2DSolver gl2d(16);
+        G1 g1;
+        G2 g2;
+        G3 g3;
+
+        const std::vector<std::pair<std::string, std::pair<double, double>>> cases = {
+            {"f1 on [0,1]", {gl.integrate(f1, 0.0, 1.0), true_f1}},
+            {"f2 on [0,1]", {gl.integrate(f2, 0.0, 1.0), true_f2}},
+            {"f1 on [0,1], 10 panels of order 8", {gl_composite.integrate(f1, 0.0, 1.0), true_f1}},
+            {"g1 on [0,1]^2", {gl2d.integrate(g1, 0.0, 1.0, 0.0, 1.0), 2.0 / 3.0}},
+            {"g2 on [0,1]^2", {gl2d.integrate(g2, 0.0, 1.0, 0.0, 1.0), 0.25}},
+            {"g3 on [0,1]^2", {gl2d.integrate(g3, 0.0, 1.0, 0.0, 1.0), (std::exp(1.0) - 1.0) * (std::exp(1.0) - 1.0)}}
+        };
+        for (const auto& c : cases) {
+            const bool passed = approx_equal(c.second.first, c.second.second, tol_gauss);
+            std::cout << "  " << c.first << ": " << c.second.first
+                      << (passed ? " [PASS]" : " [FAIL]") << "\n";
+            tests_total++;
+            if (passed) tests_passed++;
+        }
+    }
+
+    // TANH-SINH
+    // The singular integrands are integrated over the true interval [0,1] without any epsilon cut-off.
+    {
+        std::cout << "\nTanh-sinh (tol=1e-10)\n";
+        const TanhSinhSolver tanh_sinh(1e-10, 1e-10);
+
+        struct Case {
+            std::string name;
+            const Function* f;
+            double true_value;
+        };
+        const std::vector<Case> cases = {
+            {"f1 on [0,1]", &f1, true_f1},
+            {"f2 on [0,1]", &f2, true_f2},
+            {"f3 on [0,1]", &f3, true_f3},
+            {"f4 on [0,1]", &f4, true_f4}
+        };
+        for (const Case& c : cases) {
+            const TanhSinhSolver::Result r = tanh_sinh.integrate_tanh_sinh(*c.f, 0.0, 1.0);
+            const bool passed = r.converged && approx_equal(r.value, c.true_value, 1e-10)
+                             && r.evaluations <= 500;
+            std::cout << "  " << c.name << ": " << r.value << " (" << r.evaluations << " evaluations)"
+                      << (passed ? " [PASS]" : " [FAIL]") << "\n";
+            tests_total++;
+            if (passed) tests_passed++;
+        }
+    }
+
+    // STREAMING MONTE CARLO
+    // Running mean / variance with early stop: the reported standard error meets the tolerance,
+    // the sample count stays far below the budget, the true error is within a few standard errors,
+    // without a tolerance the whole budget is used and Parallel mode is independent of the thread count.
+    {
+        std::cout << "\nStreaming Monte Carlo\n";
+        const MonteCarloSolver mc_budget(10000, 42);
+        MonteCarloSolver::Result r = mc_budget.integrate_streaming(f1, 0.0, 1.0, 0.0);
+        bool passed = !r.converged && r.samples == 10000
+                   && std::abs(r.value - mc_budget.integrate(f1, 0.0, 1.0)) < 1e-12;
+        std::cout << "  no tolerance: full budget, same estimate as integrate" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        const MonteCarloSolver mc_stream(10000000, 42);
+        r = mc_stream.integrate_streaming(f1, 0.0, 1.0, 1e-3);
+        passed = r.converged && r.error <= 1e-3 && r.samples < 1000000 && std::abs(r.value - true_f1) < 4e-3;
+        std::cout << "  f1 abs_tol 1e-3: " << r.value << " +- " << r.error << " after " << r.samples
+                  << " samples" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        const MonteCarloSolver mc_stream_1(10000000, 42, MonteCarloSolver::Mode::Parallel, 1);
+        const MonteCarloSolver mc_stream_4(10000000, 42, MonteCarloSolver::Mode::Parallel, 4);
+        const MonteCarloSolver::Result r1 = mc_stream_1.integrate_streaming(f2, 0.0, 1.0, 0.0, 1e-3);
+        const MonteCarloSolver::Result r4 = mc_stream_4.integrate_streaming(f2, 0.0, 1.0, 0.0, 1e-3);
+        passed = r1.converged && r1.value == r4.value && r1.samples == r4.samples
+              && r1.error <= 1e-3 * std::abs(r1.value) && std::abs(r1.value - true_f2) < 4e-3 * true_f2;
+        std::cout << "  f2 rel_tol 1e-3, parallel: " << r1.samples << " samples, 1 vs 4 threads identical"
+                  << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        G3 g3;
+        const double true_g3 = (std::exp(1.0) - 1.0) * (std::exp(1.0) - 1.0);
+        const MonteCarlo2DSolver mc2d(10000000, 42, MonteCarlo2DSolver::Mode::Parallel);
+        const MonteCarlo2DSolver::Result r2d = mc2d.integrate_streaming(g3, 0.0, 1.0, 0.0, 1.0, 0.0, 1e-3);
+        passed = r2d.converged && r2d.samples < 1000000 && std::abs(r2d.value - true_g3) < 4e-3 * true_g3;
+        std::cout << "  g3 rel_tol 1e-3 (2D): " << r2d.value << " +- " << r2d.error << " after " << r2d.samples
+                  << " samples" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+    }
+
+    // VARIANCE-REDUCED MONTE CARLO
+    // F3 and F4 on the full interval [0,1] within 1e-3 with 10-100x fewer samples than the
+    // 2M-sample plain Monte Carlo runs: importance sampling with the matching power law makes
+    // the F3 weights constant, stratification and the VEGAS grid concentrate on the singular end of F4.
+    {
+        std::cout << "\nVariance-reduced Monte Carlo\n";
+        const ImportanceMonteCarloSolver importance(20000, std::make_shared<PowerLawProposal>(0.5), 42);
+        ImportanceMonteCarloSolver::Result ri = importance.integrate_importance(f3, 0.0, 1.0);
+        bool passed = approx_equal(ri.value, true_f3, 1e-12) && ri.error < 1e-12;
+        std::cout << "  importance x^(-1/2), f3, n=20000: " << ri.value << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        // exponential proposal concentrated at b for x^10, error within a few standard errors
+        const ImportanceMonteCarloSolver importance_exp(20000, std::make_shared<ExponentialProposal>(-8.0), 42);
+        const MonteCarloSolver uniform(20000, 42);
+        ri = importance_exp.integrate_importance(f2, 0.0, 1.0);
+        passed = std::abs(ri.value - true_f2) < 4.0 * ri.error && approx_equal(ri.value, true_f2, 1e-3)
+              && std::abs(uniform.integrate(f2, 0.0, 1.0) - true_f2) > std::abs(ri.value - true_f2);
+        std::cout << "  importance e^(8x), f2, n=20000: error " << std::scientific << std::abs(ri.value - true_f2)
+                  << " (estimate " << ri.error << ")" << std::fixed << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        const StratifiedMonteCarloSolver stratified(20000, 10000, 42);
+        const StratifiedMonteCarloSolver::Result rs = stratified.integrate_stratified(f4, 0.0, 1.0);
+        passed = approx_equal(rs.value, true_f4, 1e-3) && rs.strata == 10000;
+        std::cout << "  stratified, f4, n=20000: error " << std::scientific << std::abs(rs.value - true_f4)
+                  << " (estimate " << rs.error << ")" << std::fixed << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        // f3 has infinite variance under any piecewise constant density (f3^2 / p ~ 1/x in the first bin),
+        // the grid still cuts the plain Monte Carlo error of 2M samples, the 1e-3 target is met by f4
+        const VegasSolver vegas_1(200000, 100, 10, 42, 1);
+        const VegasSolver vegas_4(200000, 100, 10, 42, 4);
+        const Function* singular[] = {&f3, &f4};
+        const double true_singular[] = {true_f3, true_f4};
+        const double tolerance[] = {5e-3, 1e-3};
+        for (int q = 0; q < 2; ++q) {
+            const VegasSolver::Result rv = vegas_1.integrate_vegas(*singular[q], 0.0, 1.0);
+            passed = approx_equal(rv.value, true_singular[q], tolerance[q])
+                  && rv.value == vegas_4.integrate(*singular[q], 0.0, 1.0);
+            std::cout << "  VEGAS, f" << (q + 3) << ", n=200000: error " << std::scientific
+                      << std::abs(rv.value - true_singular[q]) << " (estimate " << rv.error << ", chi2/dof "
+                      << std::fixed << rv.chi2_per_dof << "), 1 vs 4 threads identical"
+                      << (passed ? " [PASS]" : " [FAIL]") << "\n";
+            tests_total++;
+            if (passed) tests_passed++;
+        }
+    }
+
+    // RESULT CACHE
+    // Repeated integrations are served from the cache, different bounds or integrands are not,
+    // the least recently used entry is evicted and Monte Carlo with seed 0 bypasses the cache.
+    {
+        std::cout << "\nResult cache\n";
+        const CachedSolver cached(std::make_unique<SimpsonSolver>(100000), 2);
+
+        const double first = cached.integrate(f1, 0.0, 1.0);
+        const double second = cached.integrate(f1, 0.0, 1.0);
+        CacheStats st = cached.stats();
+        bool passed = first == second && st.hits == 1 && st.misses == 1;
+        std::cout << "  repeated call served from cache" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        cached.integrate(f1, 0.0, 0.5);  // other bounds: miss
+        cached.integrate(f2, 0.0, 1.0);  // other integrand: miss, evicts (f1, [0,1])
+        cached.integrate(f1, 0.0, 1.0);  // evicted: miss again
+        st = cached.stats();
+        passed = st.hits == 1 && st.misses == 4 && st.size == 2;
+        std::cout << "  keys and LRU eviction (hits " << st.hits << ", misses " << st.misses << ")"
+                  << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        const CachedSolver cached_mc(std::make_unique<MonteCarloSolver>(1000, 0));
+        cached_mc.integrate(f1, 0.0, 1.0);
+        cached_mc.integrate(f1, 0.0, 1.0);
+        st = cached_mc.stats();
+        passed = st.bypassed == 2 && st.hits == 0 && st.size == 0;
+        std::cout << "  Monte Carlo with seed 0 bypasses the cache" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+    }
+
+    // 2D THREAD SCALING
+    // The tensor-product 2D solvers share the tiled kernel, tile rows are distributed over the
+    // threads and reduced in a fixed order: bit-identical results for every thread count.
+    {
+        const std::size_t n_grid = 1000;
+        const unsigned max_threads = std::max(4u, resolve_threads(0));
+        std::cout << "\n2D thread scaling (" << n_grid << "x" << n_grid << " grid, up to "
+                  << max_threads << " threads)\n";
+
+        G4 g4_separable;
+        const GridOnly g4(g4_separable);  // the separable fast path would skip the grid
+        const double true_g4 = (1.0 - std::cos(1.0)) * std::sin(1.0);
+        using Solver2DFactory = std::function<std::unique_ptr<Solver2D>(unsigned)>;
+        struct Factory {
+            std::string name;
+            Solver2DFactory make;
+            double tolerance;  // the Weddle 2D rule only converges like O(h)
+        };
+        const std::vector<Factory> factories = {
+            {"Trapezoid 2D", [&](unsigned t) { return std::make_unique<Trapezoid2DSolver>(n_grid, n_grid, t); }, 1e-6},
+            {"Simpson 2D",   [&](unsigned t) { return std::make_unique<Simpson2DSolver>(n_grid, n_grid, t); }, 1e-6},
+            {"Weddle 2D",    [&](unsigned t) { return std::make_unique<Weddle2DSolver>(n_grid, n_grid, t); }, 1e-2},
+            {"Gauss-Legendre 2D", [&](unsigned t) { return std::make_unique<GaussLegendre2DSolver>(16, 8, 8, t); }, 1e-6}
+        };
+        for (const Factory& factory : factories) {
+            double reference = 0.0;
+            double reference_time = 0.0;
+            bool passed = true;
+            std::cout << "  g4 " << factory.name << ":";
+            for (unsigned t = 1; t <= max_threads; t *= 2) {
+                std::unique_ptr<Solver2D> solver = factory.make(t);
+                const auto start = std::chrono::steady_clock::now();
+                const double val = solver->integrate(g4, 0.0, 1.0, 0.0, 1.0);
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                if (t == 1) {
+                    reference = val;
+                    reference_time = elapsed.count();
+                }
+                passed = passed && (val == reference);
+                std::cout << "  " << t << "T x" << (reference_time / elapsed.count());
+            }
+            passed = passed && approx_equal(reference, true_g4, factory.tolerance);
+            std::cout << (passed ? " [PASS]" : " [FAIL]") << "\n";
+            tests_total++;
+            if (passed) tests_passed++;
+        }
+    }
+
+    // SEPARABLE INTEGRANDS
+    // G1-G4 are sums of products of 1D functions, the grid solvers integrate them as products of
+    // 1D rule sums: same value as the full grid up to rounding with nx + ny instead of nx * ny evaluations
+    {
+        std::cout << "\nSeparable integrands\n";
+        G1 g1;
+        G2 g2;
+        G3 g3;
+        G4 g4;
+        const std::vector<std::pair<std::string, const Function2D*>> integrands = {
+            {"g1", &g1}, {"g2", &g2}, {"g3", &g3}, {"g4", &g4}
+        };
+        const Trapezoid2DSolver trap2d(400, 300);
+        const Simpson2DSolver simpson2d(400, 300);
+        const Weddle2DSolver weddle2d(400, 300);
+        const GaussLegendre2DSolver gauss2d(16, 2, 3);
+        const std::vector<std::pair<std::string, const Solver2D*>> solvers2d = {
+            {"Trapezoid 2D", &trap2d}, {"Simpson 2D", &simpson2d},
+            {"Weddle 2D", &weddle2d}, {"Gauss-Legendre 2D", &gauss2d}
+        };
+        for (const auto& solver : solvers2d) {
+            bool passed = true;
+            for (const auto& integrand : integrands) {
+                const GridOnly grid(*integrand.second);
+                const double fast = solver.second->integrate(*integrand.second, 0.0, 1.0, 0.0, 1.0);
+                const double full = solver.second->integrate(grid, 0.0, 1.0, 0.0, 1.0);
+                passed = passed && std::abs(fast - full) <= 1e-13 * std::max(1.0, std::abs(full));
+            }
+            std::cout << "  " << solver.first << " G1-G4 match the full grid" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+            tests_total++;
+            if (passed) tests_passed++;
+        }
+
+        F1 f1_factor;
+        F2 f2_factor;
+        std::atomic<std::uint64_t> u_count{0};
+        std::atomic<std::uint64_t> v_count{0};
+        auto u = std::make_shared<CountingFunction>(f1_factor, u_count);
+        auto v = std::make_shared<CountingFunction>(f2_factor, v_count);
+        const SeparableFunction2D product(u, v);
+        const double value = Trapezoid2DSolver(1000, 1000).integrate(product, 0.0, 1.0, 0.0, 1.0);
+        const bool passed = u_count == 1001 && v_count == 1001
+                         && approx_equal(value, true_f1 * true_f2, 1e-6);
+        std::cout << "  f1(x)*f2(y), 1000x1000 grid: " << (u_count + v_count) << " evaluations"
+                  << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+    }
+
+    // QUASI-MONTE CARLO
+    // The scrambled Sobol points keep the (0,m,2)-net property of the first two coordinates,
+    // randomized QMC reaches on G1-G4 with 8 x 4096 points what plain Monte Carlo does not reach
+    // with 1M samples, the replicate spread is a usable error estimate and the thread count
+    // does not change the result.
+    {
+        std::cout << "\nQuasi-Monte Carlo\n";
+
+        // every elementary interval [i/2^k, (i+1)/2^k) x [j/2^(m-k), (j+1)/2^(m-k)) holds exactly one point
+        const unsigned m = 10;
+        const std::size_t points = std::size_t(1) << m;
+        const SobolSequence sobol(2, 99);
+        std::vector<double> u(points), v(points);
+        sobol.generate(0, 0, u.data(), points);
+        sobol.generate(1, 0, v.data(), points);
+        bool passed = true;
+        for (unsigned k = 0; k <= m; ++k) {
+            std::vector<int> cells(points, 0);
+            for (std::size_t i = 0; i < points; ++i) {
+                const std::size_t cx = static_cast<std::size_t>(u[i] * (1u << k));
+                const std::size_t cy = static_cast<std::size_t>(v[i] * (1u << (m - k)));
+                cells[(cx << (m - k)) | cy]++;
+            }
+            passed = passed && std::all_of(cells.begin(), cells.end(), [](int c) { return c == 1; });
+        }
+        std::cout << "  scrambled Sobol 2^10 points form a (0,10,2)-net" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        G1 g1;
+        G2 g2;
+        G3 g3;
+        G4 g4;
+        const double e1 = std::exp(1.0) - 1.0;
+        const std::vector<std::pair<const Function2D*, double>> integrals = {
+            {&g1, 2.0 / 3.0}, {&g2, 0.25}, {&g3, e1 * e1}, {&g4, (1.0 - std::cos(1.0)) * std::sin(1.0)}
+        };
+        const QuasiMonteCarlo2DSolver qmc_sobol(4096, 8, 42);
+        const QuasiMonteCarlo2DSolver qmc_halton(4096, 8, 42, QuasiMonteCarlo2DSolver::Sequence::Halton);
+        const MonteCarlo2DSolver mc(1000000, 42, MonteCarlo2DSolver::Mode::Parallel);
+        for (std::size_t q = 0; q < integrals.size(); ++q) {
+            const QuasiMonteCarlo2DSolver::Result sobol_r = qmc_sobol.integrate_qmc(*integrals[q].first, 0.0, 1.0, 0.0, 1.0);
+            const QuasiMonteCarlo2DSolver::Result halton_r = qmc_halton.integrate_qmc(*integrals[q].first, 0.0, 1.0, 0.0, 1.0);
+            const double mc_error = std::abs(mc.integrate(*integrals[q].first, 0.0, 1.0, 0.0, 1.0) - integrals[q].second);
+            const double sobol_error = std::abs(sobol_r.value - integrals[q].second);
+            const double halton_error = std::abs(halton_r.value - integrals[q].second);
+            // the true error should be within a few standard errors
+            passed = sobol_error < mc_error && sobol_error < 1e-5 && halton_error < 1e-3
+                  && sobol_error < 5.0 * sobol_r.error + 1e-12 && halton_error < 5.0 * halton_r.error + 1e-12
+                  && sobol_r.evaluations == 8 * 4096;
+            std::cout << "  g" << (q + 1) << ": Sobol error " << std::scientific << sobol_error
+                      << " (estimate " << sobol_r.error << "), Halton error " << halton_error
+                      << ", MC(1M) error " << mc_error << std::fixed << (passed ? " [PASS]" : " [FAIL]") << "\n";
+            tests_total++;
+            if (passed) tests_passed++;
+        }
+
+        const QuasiMonteCarloSolver qmc_1(131072, 4, 7, QuasiMonteCarloSolver::Sequence::Sobol, 1);
+        const QuasiMonteCarloSolver qmc_4(131072, 4, 7, QuasiMonteCarloSolver::Sequence::Sobol, 4);
+        const double v1 = qmc_1.integrate(f1, 0.0, 1.0);
+        passed = v1 == qmc_4.integrate(f1, 0.0, 1.0) && approx_equal(v1, true_f1, 1e-7);
+        std::cout << "  1D Sobol f1, 1 vs 4 threads bit-identical" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+    }
+
+    // FUSED MULTI-INTEGRAND SWEEP
+    // integrate_many evaluates all integrands on the same nodes in one pass,
+    // every result has to be bit-identical to a separate integrate call
+    {
+        std::cout << "\nFused multi-integrand integration\n";
+        const std::vector<const Function*> fs = {&f1, &f2, &f3, &f4};
+        const TrapezoidSolver trap_many(100000, 4);
+        const SimpsonSolver simpson_many(100000, 4);
+        const WeddleSolver weddle_many(100000, 4);
+        const GaussLegendreSolver gauss_many(16, 8);
+        const std::vector<std::pair<std::string, const Solver*>> solvers = {
+            {"Trapezoid", &trap_many}, {"Simpson", &simpson_many},
+            {"Weddle", &weddle_many}, {"Gauss-Legendre", &gauss_many}
+        };
+        for (const auto& entry : solvers) {
+            const std::vector<double> fused = entry.second->integrate_many(fs, 0.0, 1.0);
+            bool passed = fused.size() == fs.size();
+            for (std::size_t q = 0; passed && q < fs.size(); ++q) {
+                passed = fused[q] == entry.second->integrate(*fs[q], 0.0, 1.0);
+            }
+            std::cout << "  " << entry.first << " F1-F4" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+            tests_total++;
+            if (passed) tests_passed++;
+        }
+
+        G1 g1;
+        G2 g2;
+        G3 g3;
+        G4 g4;
+        const std::vector<const Function2D*> gs = {&g1, &g2, &g3, &g4};
+        const Trapezoid2DSolver trap2d(300, 300);
+        const Simpson2DSolver simpson2d(300, 300);
+        const Weddle2DSolver weddle2d(300, 300);
+        const GaussLegendre2DSolver gauss2d(16, 2, 3);
+        const std::vector<std::pair<std::string, const Solver2D*>> solvers2d = {
+            {"Trapezoid 2D", &trap2d}, {"Simpson 2D", &simpson2d},
+            {"Weddle 2D", &weddle2d}, {"Gauss-Legendre 2D", &gauss2d}
+        };
+        for (const auto& entry : solvers2d) {
+            const std::vector<double> fused = entry.second->integrate_many(gs, 0.0, 1.0, 0.0, 1.0);
+            bool passed = fused.size() == gs.size();
+            for (std::size_t q = 0; passed && q < gs.size(); ++q) {
+                passed = fused[q] == entry.second->integrate(*gs[q], 0.0, 1.0, 0.0, 1.0);
+            }
+            std::cout << "  " << entry.first << " G1-G4" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+            tests_total++;
+            if (passed) tests_passed++;
+        }
+
+        const MonteCarloSolver mc_many(10000, 7);
+        const std::vector<double> fused = mc_many.integrate_many({&f1, &f2}, 0.0, 1.0);
+        const bool passed = fused.size() == 2 && fused[0] == mc_many.integrate(f1, 0.0, 1.0)
+                         && fused[1] == mc_many.integrate(f2, 0.0, 1.0);
+        std::cout << "  default integrate_many (Monte Carlo)" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+    }
+
+    // N-DIMENSIONAL SOLVERS
+    // FunctionND<D> / SolverND<D>: at D = 2 the tensor rules reproduce the 2D solvers (same 1D rules)
+    // and Monte Carlo draws the samples of MonteCarlo2DSolver in Parallel mode; in 3-6 dimensions
+    // the rules converge on e^(x_0 + ... + x_(D-1)) and stay bit-identical across thread counts
+    {
+        std::cout << "\nN-dimensional solvers\n";
+        G1 g1;
+        G2 g2;
+        G3 g3;
+        G4 g4;
+        const std::vector<const Function2D*> gs = {&g1, &g2, &g3, &g4};
+        const std::array<double, 2> lower2{0.0, 0.0};
+        const std::array<double, 2> upper2{1.0, 1.0};
+
+        bool passed = true;
+        for (const Function2D* g : gs) {
+            const GridOnly grid(*g);
+            const Function2DAsND g_nd(grid);
+            const double pairs[4][2] = {
+                {TrapezoidNDSolver<2>(TrapezoidNDSolver<2>::Sizes{60, 40}).integrate(g_nd, lower2, upper2),
+                 Trapezoid2DSolver(60, 40).integrate(grid, 0.0, 1.0, 0.0, 1.0)},
+                {SimpsonNDSolver<2>(SimpsonNDSolver<2>::Sizes{60, 40}).integrate(g_nd, lower2, upper2),
+                 Simpson2DSolver(60, 40).integrate(grid, 0.0, 1.0, 0.0, 1.0)},
+                {WeddleNDSolver<2>(WeddleNDSolver<2>::Sizes{60, 40}).integrate(g_nd, lower2, upper2),
+                 Weddle2DSolver(60, 40).integrate(grid, 0.0, 1.0, 0.0, 1.0)},
+                {GaussLegendreNDSolver<2>(8, 3).integrate(g_nd, lower2, upper2),
+                 GaussLegendre2DSolver(8, 3, 3).integrate(grid, 0.0, 1.0, 0.0, 1.0)}
+            };
+            for (const auto& pair : pairs) {
+                passed = passed && std::abs(pair[0] - pair[1]) <= 1e-13 * std::max(1.0, std::abs(pair[1]));
+            }
+        }
+        std::cout << "  tensor rules at D = 2 match the 2D solvers on G1-G4" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        const Function2DAsND g4_nd(g4);
+        const double mc_nd = MonteCarloNDSolver<2>(100000, 11, 3).integrate(g4_nd, lower2, upper2);
+        const double mc_2d = MonteCarlo2DSolver(100000, 11, MonteCarlo2DSolver::Mode::Parallel, 2)
+                                 .integrate(g4, 0.0, 1.0, 0.0, 1.0);
+        passed = (mc_nd == mc_2d);
+        std::cout << "  Monte Carlo at D = 2 equals MonteCarlo2DSolver (Parallel): " << mc_nd
+                  << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        const ExpSumND<3> f3d;
+        const ExpSumND<4> f4d;
+        const ExpSumND<6> f6d;
+        const double e1 = std::exp(1.0) - 1.0;
+        const std::array<double, 3> lower3{0.0, 0.0, 0.0};
+        const std::array<double, 3> upper3{1.0, 1.0, 1.0};
+        const std::array<double, 4> lower4{};
+        const std::array<double, 4> upper4{1.0, 1.0, 1.0, 1.0};
+        const std::array<double, 6> lower6{};
+        const std::array<double, 6> upper6{1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+        struct Case {
+            std::string name;
+            double value;
+            double exact;
+            double tolerance;
+        };
+        const std::vector<Case> cases = {
+            {"Trapezoid 3D (n=40)", TrapezoidNDSolver<3>(40).integrate(f3d, lower3, upper3), e1 * e1 * e1, 1e-3},
+            {"Simpson 4D (n=16)", SimpsonNDSolver<4>(16).integrate(f4d, lower4, upper4), std::pow(e1, 4), 1e-5},
+            {"Gauss-Legendre 6D (order 5)", GaussLegendreNDSolver<6>(5).integrate(f6d, lower6, upper6),
+             std::pow(e1, 6), 1e-9},
+            {"Monte Carlo 3D (n=10^6)", MonteCarloNDSolver<3>(1000000, 5).integrate(f3d, lower3, upper3),
+             e1 * e1 * e1, 1e-2}
+        };
+        for (const Case& c : cases) {
+            passed = approx_equal(c.value, c.exact, c.tolerance);
+            std::cout << "  " << c.name << ": " << c.value << " (exact " << c.exact << ")"
+                      << (passed ? " [PASS]" : " [FAIL]") << "\n";
+            tests_total++;
+            if (passed) tests_passed++;
+        }
+
+        const double serial = SimpsonNDSolver<4>(16, 1).integrate(f4d, lower4, upper4);
+        passed = true;
+        for (unsigned t = 2; t <= 4; ++t) {
+            passed = passed && SimpsonNDSolver<4>(16, t).integrate(f4d, lower4, upper4) == serial
+                            && MonteCarloNDSolver<3>(100000, 5, t).integrate(f3d, lower3, upper3)
+                               == MonteCarloNDSolver<3>(100000, 5, 1).integrate(f3d, lower3, upper3);
+        }
+        std::cout << "  bit-identical for 1-4 threads" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        bool threw = false;
+        try {
+            TrapezoidNDSolver<3>(10).integrate(f3d, lower3, std::array<double, 3>{1.0, 0.0, 1.0});
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        std::cout << "  empty box rejected" << (threw ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (threw) tests_passed++;
+    }
+
+    // TEMPLATE KERNELS
+    // The solver classes forward to the kernels of IntegrationKernels.h; a lambda with the formula
+    // of F2::evaluate goes through the same nodes and sums, so it gives the same bits
+    {
+        std::cout << "\nTemplate kernels\n";
+        F2 f2;
+        const auto f2_lambda = [](double x) {
+            const double x2 = x * x;
+            const double x4 = x2 * x2;
+            const double x8 = x4 * x4;
+            return x8 * x2;
+        };
+        const TrapezoidSolver trap(100001, 3);
+        const SimpsonSolver simpson(100001, 3);
+        const WeddleSolver weddle(100001, 3);
+        const GaussLegendreSolver gauss(12, 7);
+        const MonteCarloSolver mc_seq(50000, 9);
+        const MonteCarloSolver mc_par(50000, 9, MonteCarloSolver::Mode::Parallel, 3);
+        const std::vector<std::pair<std::string, std::pair<double, double>>> pairs = {
+            {"Trapezoid", {trap.integrate(f2, 0.0, 1.0), trap.integrate(f2_lambda, 0.0, 1.0)}},
+            {"Simpson", {simpson.integrate(f2, 0.0, 1.0), simpson.integrate(f2_lambda, 0.0, 1.0)}},
+            {"Weddle", {weddle.integrate(f2, 0.0, 1.0), weddle.integrate(f2_lambda, 0.0, 1.0)}},
+            {"Gauss-Legendre", {gauss.integrate(f2, 0.0, 1.0), gauss.integrate(f2_lambda, 0.0, 1.0)}},
+            {"Monte Carlo", {mc_seq.integrate(f2, 0.0, 1.0), mc_seq.integrate(f2_lambda, 0.0, 1.0)}},
+            {"Monte Carlo (Parallel)", {mc_par.integrate(f2, 0.0, 1.0), mc_par.integrate(f2_lambda, 0.0, 1.0)}}
+        };
+        for (const auto& pair : pairs) {
+            const bool passed = pair.second.first == pair.second.second;
+            std::cout << "  " << pair.first << ": lambda == Function " << pair.second.second
+                      << (passed ? " [PASS]" : " [FAIL]") << "\n";
+            tests_total++;
+            if (passed) tests_passed++;
+        }
+
+        bool passed = approx_equal(kernels::simpson([](double x) { return std::exp(x); }, 0.0, 1.0, 1000),
+                                   std::exp(1.0) - 1.0, 1e-12)
+                   && approx_equal(kernels::gauss_legendre([](double x) { return 1.0 / (1.0 + x * x); }, 0.0, 1.0, 20),
+                                   std::atan(1.0), 1e-14);
+        bool threw = false;
+        try {
+            kernels::trapezoid(f2_lambda, 1.0, 0.0, 10);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        passed = passed && threw;
+        std::cout << "  free kernels on lambdas, empty interval rejected" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+    }
+
+    // SPARSE GRIDS
+    // Dimension-adaptive Smolyak cubature with nested Clenshaw-Curtis rules: G1-G4 to ~1e-10 with a
+    // few hundred points, every shared point evaluated once, directions without dependence stay coarse
+    {
+        std::cout << "\nSparse grids\n";
+        G1 g1;
+        G2 g2;
+        G3 g3;
+        G4 g4;
+        const std::vector<std::pair<const Function2D*, double>> integrands = {
+            {&g1, 2.0 / 3.0}, {&g2, 0.25}, {&g3, (std::exp(1.0) - 1.0) * (std::exp(1.0) - 1.0)},
+            {&g4, (1.0 - std::cos(1.0)) * std::sin(1.0)}
+        };
+        const SparseGrid2DSolver sparse2d(1e-12, 1e-12);
+        for (std::size_t q = 0; q < integrands.size(); ++q) {
+            const SparseGrid2DSolver::Result r = sparse2d.integrate_sparse(*integrands[q].first, 0.0, 1.0, 0.0, 1.0);
+            const bool passed = r.converged && approx_equal(r.value, integrands[q].second, 1e-10) && r.evaluations < 1000;
+            std::cout << "  g" << (q + 1) << " sparse grid 2D: " << r.value << " (" << r.evaluations << " points, "
+                      << r.indices << " indices)" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+            tests_total++;
+            if (passed) tests_passed++;
+        }
+        // max_level beyond the Clenshaw-Curtis limit gives the same integral, so the same cache key
+        const bool clamped = SparseGrid2DSolver(1e-12, 1e-12, 100000, 100).configuration()
+                             == SparseGrid2DSolver(1e-12, 1e-12, 100000, 12).configuration();
+        std::cout << "  sparse grid 2D max_level clamped in configuration" << (clamped ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (clamped) tests_passed++;
+
+        const ExpSumND<5> f5d;
+        const std::array<double, 5> lower5{};
+        const std::array<double, 5> upper5{1.0, 1.0, 1.0, 1.0, 1.0};
+        const SparseGridNDSolver<5>::Result r5 = SparseGridNDSolver<5>(1e-9, 1e-9).integrate_sparse(f5d, lower5, upper5);
+        bool passed = r5.converged && approx_equal(r5.value, std::pow(std::exp(1.0) - 1.0, 5), 1e-7)
+                   && r5.evaluations < 20000;
+        std::cout << "  e^(x1+..+x5) sparse grid 5D: " << r5.value << " (" << r5.evaluations << " points)"
+                  << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        const FirstCoordinateExpND<4> f4d;
+        const std::array<double, 4> lower4{};
+        const std::array<double, 4> upper4{1.0, 2.0, 3.0, 4.0};
+        const SparseGridNDSolver<4>::Result r4 = SparseGridNDSolver<4>(1e-12, 1e-12).integrate_sparse(f4d, lower4, upper4);
+        passed = approx_equal(r4.value, 24.0 * (std::exp(1.0) - 1.0), 1e-10)
+              && r4.evaluations == f4d.count && r4.evaluations < 100;
+        std::cout << "  e^x1 in 4D (anisotropic): " << r4.value << " (" << r4.evaluations << " points, each evaluated once)"
+                  << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+    }
+
+    // SUMMATION POLICIES
+    // 10^7 terms of 0.1: the running sum drifts by ~1e-7 relative, the pairwise cascade and the
+    // compensated sum stay at a few ulps; every policy is independent of the thread count
+    {
+        std::cout << "\nSummation policies\n";
+        const std::vector<double> block(256, 0.1);
+        const std::size_t blocks = 39063;  // 10000128 terms
+        const double exact = 0.1 * static_cast<double>(blocks * block.size());
+        double errors[3];
+        const Summation policies[3] = {Summation::Naive, Summation::Pairwise, Summation::Neumaier};
+        for (int p = 0; p < 3; ++p) {
+            Accumulator sum(policies[p]);
+            for (std::size_t b = 0; b < blocks; ++b) {
+                sum.add(block.data(), block.size());
+            }
+            errors[p] = std::abs(sum.sum() - exact) / exact;
+        }
+        bool passed = errors[1] < 1e-14 && errors[2] < 1e-15 && errors[1] < errors[0] && errors[2] < errors[0];
+        std::cout << "  relative error naive " << std::scientific << errors[0] << ", pairwise " << errors[1] << ", neumaier "
+                  << errors[2] << std::fixed << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        F2 f2;
+        passed = true;
+        for (Summation summation : policies) {
+            const double one = TrapezoidSolver(1000001, 1, summation).integrate(f2, 0.0, 1.0);
+            const double three = TrapezoidSolver(1000001, 3, summation).integrate(f2, 0.0, 1.0);
+            const double grid = Trapezoid2DSolver(300, 200, 3, summation).integrate(G1(), 0.0, 1.0, 0.0, 1.0);
+            passed = passed && one == three && approx_equal(one, 1.0 / 11.0, 1e-11)
+                  && grid == Trapezoid2DSolver(300, 200, 1, summation).integrate(G1(), 0.0, 1.0, 0.0, 1.0);
+        }
+        passed = passed && TrapezoidSolver(1000, 1, Summation::Naive).configuration() == "Trapezoid(n=1000,summation=naive)"
+              && TrapezoidSolver(1000).configuration() == "Trapezoid(n=1000)";
+        std::cout << "  Trapezoid 1D/2D bit-identical for 1 and 3 threads under every policy" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        // Romberg and quasi-Monte Carlo sum through the same policies
+        F1 f1;
+        passed = true;
+        for (Summation summation : policies) {
+            const double romberg = RombergSolver(1e-12, 1e-12, 25, summation).integrate(f1, 0.0, 1.0);
+            const double qmc = QuasiMonteCarloSolver(1 << 16, 4, 42, QuasiMonteCarloSolver::Sequence::Sobol, 3, summation)
+                                   .integrate(f1, 0.0, 1.0);
+            const double qmc_2d = QuasiMonteCarlo2DSolver(1 << 14, 4, 42, QuasiMonteCarlo2DSolver::Sequence::Sobol, 3, summation)
+                                      .integrate(G1(), 0.0, 1.0, 0.0, 1.0);
+            passed = passed && approx_equal(romberg, true_f1, 1e-11) && approx_equal(qmc, true_f1, 1e-6)
+                  && approx_equal(qmc_2d, 2.0 / 3.0, 1e-5)
+                  && qmc == QuasiMonteCarloSolver(1 << 16, 4, 42, QuasiMonteCarloSolver::Sequence::Sobol, 1, summation)
+                                .integrate(f1, 0.0, 1.0);
+        }
+        passed = passed && RombergSolver(1e-10, 1e-10, 25, Summation::Neumaier).configuration().find(",summation=neumaier)") != std::string::npos
+              && QuasiMonteCarloSolver(4096, 8, 1, QuasiMonteCarloSolver::Sequence::Sobol, 1, Summation::Naive)
+                     .configuration().find(",summation=naive)") != std::string::npos;
+        std::cout << "  Romberg / quasi-Monte Carlo under every policy" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+    }
+
+    // INSTRUMENTATION
+    // The wrappers count every evaluation (G3 stays separable: nx + ny factor evaluations), mark the
+    // sampling solvers, leave the value unchanged and aggregate concurrent calls without losing any
+    {
+        std::cout << "\nInstrumentation\n";
+        F2 f2;
+        G3 g3;
+        const InstrumentedSolver trapezoid(std::make_unique<TrapezoidSolver>(1000, 1));
+        const InstrumentedSolver monte_carlo(std::make_unique<MonteCarloSolver>(5000, 7));
+        const InstrumentedSolver2D simpson_2d(std::make_unique<Simpson2DSolver>(100, 60, 1));
+        const double value = trapezoid.integrate(f2, 0.0, 1.0);
+        const InstrumentedSolver::Result r = monte_carlo.integrate_instrumented(f2, 0.0, 1.0);
+        const double value_2d = simpson_2d.integrate(g3, 0.0, 1.0, 0.0, 1.0);
+        const SolverStats s_trap = trapezoid.snapshot();
+        const SolverStats s_mc = monte_carlo.snapshot();
+        const SolverStats s_2d = simpson_2d.snapshot();
+        bool passed = value == TrapezoidSolver(1000, 1).integrate(f2, 0.0, 1.0)
+                   && r.value == MonteCarloSolver(5000, 7).integrate(f2, 0.0, 1.0)
+                   && value_2d == Simpson2DSolver(100, 60, 1).integrate(g3, 0.0, 1.0, 0.0, 1.0)
+                   && s_trap.name == "Trapezoid(n=1000)" && s_trap.calls == 1 && s_trap.evaluations == 1001
+                   && s_trap.samples == 0 && r.stats.evaluations == 5000 && r.stats.samples == 5000
+                   && s_mc.samples == 5000 && s_2d.evaluations == 101 + 61
+                   && s_trap.to_json().find("\"evaluations\": 1001") != std::string::npos;
+        std::cout << "  counts: " << s_trap.to_text() << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        // 4 threads x 25 calls on one wrapper, then a disabled call that is not recorded
+        InstrumentedSolver shared(std::make_unique<TrapezoidSolver>(1000, 1), "shared");
+        std::vector<std::thread> callers;
+        for (int t = 0; t < 4; ++t) {
+            callers.emplace_back([&] {
+                for (int k = 0; k < 25; ++k) {
+                    shared.integrate(f2, 0.0, 1.0);
+                }
+            });
+        }
+        for (std::thread& t : callers) {
+            t.join();
+        }
+        shared.set_enabled(false);
+        shared.integrate(f2, 0.0, 1.0);
+        const SolverStats s_shared = shared.snapshot();
+        passed = s_shared.calls == 100 && s_shared.evaluations == 100 * 1001 && s_shared.wall_seconds > 0.0;
+        std::cout << "  concurrent calls: " << s_shared.calls << " calls, " << s_shared.evaluations << " evaluations"
+                  << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        // on top of a cache: every integrand keeps its own entry although the counting wrappers
+        // share one stack address, a repeated call is a hit without evaluations
+        F1 f1;
+        G4 g4;
+        auto cached = std::make_unique<CachedSolver>(std::make_unique<TrapezoidSolver>(1000, 1));
+        const CachedSolver& cache = *cached;
+        const InstrumentedSolver over_cache(std::move(cached));
+        const InstrumentedSolver2D over_cache_2d(std::make_unique<CachedSolver2D>(std::make_unique<Simpson2DSolver>(100, 60, 1)));
+        const double v1 = over_cache.integrate(f1, 0.0, 1.0);
+        const double v2 = over_cache.integrate(f2, 0.0, 1.0);
+        const double v1_again = over_cache.integrate(f1, 0.0, 1.0);
+        const std::vector<double> many = over_cache.integrate_many({&f2, &f1}, 0.0, 1.0);
+        const double w3 = over_cache_2d.integrate(g3, 0.0, 1.0, 0.0, 1.0);
+        const double w4 = over_cache_2d.integrate(g4, 0.0, 1.0, 0.0, 1.0);
+        passed = v1 == TrapezoidSolver(1000, 1).integrate(f1, 0.0, 1.0) && v2 == value && v1_again == v1
+              && many[0] == v2 && many[1] == v1 && cache.stats().misses == 2 && cache.stats().hits == 3
+              && over_cache.snapshot().evaluations == 2 * 1001
+              && w3 == value_2d && w4 == Simpson2DSolver(100, 60, 1).integrate(g4, 0.0, 1.0, 0.0, 1.0);
+        std::cout << "  instrumented cache: " << cache.stats().misses << " misses, " << cache.stats().hits << " hits"
+                  << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+    }
+
+    // AUTO-TUNER
+    // Smooth integrands are done by the Simpson pilot itself (a few thousand evaluations for 1e-8);
+    // F4 near its singularity needs the doubling stage, its estimated error has to track the true one
+    {
+        std::cout << "\nAuto-tuner\n";
+        F1 f1;
+        F2 f2;
+        F4 f4;
+        const AutoSolver auto_solver(1e-8, 1e-8, 100000000, 64, 42, 1);
+        const AutoSolver::Result r1 = auto_solver.integrate_auto(f1, 0.0, 1.0);
+        const AutoSolver::Result r2 = auto_solver.integrate_auto(f2, 0.0, 1.0);
+        bool passed = r1.converged && r2.converged && r1.rule == AutoSolver::Rule::Simpson
+                   && r2.rule == AutoSolver::Rule::Simpson && approx_equal(r1.value, true_f1, 1e-8)
+                   && approx_equal(r2.value, true_f2, 1e-8) && r1.evaluations < 20000 && r2.evaluations < 20000
+                   && r1.candidates.size() == 4;
+        std::cout << "  F1, F2 tol=1e-8: " << AutoSolver::rule_name(r1.rule) << " n=" << r1.n << ", "
+                  << AutoSolver::rule_name(r2.rule) << " n=" << r2.n << ", " << (r1.evaluations + r2.evaluations)
+                  << " evaluations" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        const double epsilon = 1e-6;
+        const double true_f4_eps = -1.0 - epsilon * (std::log(epsilon) - 1.0);
+        const AutoSolver::Result r4 = AutoSolver(1e-6, 1e-6, 100000000, 64, 42, 1).integrate_auto(f4, epsilon, 1.0);
+        const double error = std::abs(r4.value - true_f4_eps);
+        passed = r4.converged && error <= 1e-6 && error <= 3.0 * r4.error && r4.error <= 10.0 * error
+              && r4.evaluations < 5000000;
+        std::cout << "  F4 on [1e-6,1] tol=1e-6: " << AutoSolver::rule_name(r4.rule) << " n=" << r4.n << ", error "
+                  << std::scientific << error << " (estimated " << r4.error << ", predicted " << r4.predicted_error
+                  << ")" << std::fixed << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+    }
+
+    // ISA DISPATCH
+    // The solvers give the scalar results bit for bit with every instruction set variant of the kernels
+    {
+        std::cout << "\nISA dispatch\n";
+        const char* const selected = vmath::isa();
+        const double pi = 3.14159265358979323846;
+        F1 f1;
+        F4 f4;
+        G3 g3;
+        G4 g4;
+        auto run = [&]() {
+            return std::vector<double>{
+                SimpsonSolver(100000, 2).integrate(f1, 0.0, 1.0),
+                TrapezoidSolver(100000, 2).integrate(f4, 1e-6, 1.0),
+                Trapezoid2DSolver(300, 300, 2).integrate(g4, 0.0, pi, 0.0, pi),
+                MonteCarlo2DSolver(100000, 42, MonteCarlo2DSolver::Mode::Parallel, 2).integrate(g3, 0.0, 1.0, 0.0, 1.0)};
+        };
+        bool passed = vmath::set_isa("scalar");
+        const std::vector<double> reference = run();
+        std::cout << "  selected " << selected << ", compared:";
+        for (const char* name : {"sse2", "avx2", "avx512"}) {
+            if (!vmath::set_isa(name)) continue;
+            const bool same = run() == reference;
+            std::cout << " " << name << (same ? "" : " (differs)");
+            passed &= same;
+        }
+        vmath::set_isa(selected);
+        std::cout << " vs scalar" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+    }
+
+    // EXPRESSION INTEGRANDS
+    // Run-time expressions integrate like the hand-written classes; folding, CSE and power chains
+    // show in the program size; separable 2D expressions keep the factorized path
+    {
+        std::cout << "\nExpression integrands\n";
+        F1 f1;
+        F2 f2;
+        F3 f3;
+        F4 f4;
+        const ExpressionFunction e1("x^2*cos(x)");
+        const ExpressionFunction e2("x^10");
+        const ExpressionFunction e3("1/sqrt(x)");
+        const ExpressionFunction e4("log(x)");
+        const SimpsonSolver simpson(100000, 2);
+        bool passed = approx_equal(simpson.integrate(e1, 0.0, 1.0), simpson.integrate(f1, 0.0, 1.0), 1e-13)
+                   && approx_equal(simpson.integrate(e2, 0.0, 1.0), simpson.integrate(f2, 0.0, 1.0), 1e-13)
+                   && approx_equal(simpson.integrate(e3, 1e-6, 1.0), simpson.integrate(f3, 1e-6, 1.0), 1e-13)
+                   && approx_equal(simpson.integrate(e4, 1e-6, 1.0), simpson.integrate(f4, 1e-6, 1.0), 1e-13);
+        std::cout << "  E1-E4 vs F1-F4 (Simpson)" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        const ExpressionFunction cse("sin(x)*sin(x) + 2*pi*x");
+        const ExpressionFunction folded("2^-1");
+        const double x0 = 0.3;
+        passed = cse.expression().instructions() == 4 && e2.expression().instructions() == 4
+              && folded.expression().instructions() == 0 && folded(x0) == 0.5
+              && approx_equal(cse(x0), std::sin(x0) * std::sin(x0) + 2.0 * 3.14159265358979323846 * x0, 1e-15);
+        std::cout << "  program sizes " << cse.expression().instructions() << ", " << e2.expression().instructions()
+                  << ", " << folded.expression().instructions() << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        // blocks longer than the 256 point registers, in place
+        std::vector<double> xs(1000), out(1000);
+        for (std::size_t i = 0; i < xs.size(); ++i) xs[i] = 0.001 * static_cast<double>(i + 1);
+        e1.evaluate(xs.data(), out.data(), out.size());
+        passed = true;
+        for (std::size_t i = 0; i < xs.size(); ++i) passed &= out[i] == e1(xs[i]);
+        e1.evaluate(xs.data(), xs.data(), xs.size());
+        passed &= xs == out;
+        std::cout << "  block evaluation = point evaluation" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        G3 g3;
+        const std::unique_ptr<Function2D> h3 = make_expression_function_2d("exp(x+y)", "x", "y", true);
+        const std::unique_ptr<Function2D> h4 = make_expression_function_2d("sin(x)*cos(y)");
+        const std::unique_ptr<Function2D> mixed = make_expression_function_2d("sin(x*y)");
+        const Trapezoid2DSolver trapezoid_2d(200, 200, 2);
+        passed = dynamic_cast<const SeparableFunction2D*>(h3.get()) != nullptr
+              && dynamic_cast<const SeparableFunction2D*>(h4.get()) != nullptr
+              && dynamic_cast<const SeparableFunction2D*>(make_expression_function_2d("exp(x+y)").get()) == nullptr
+              && dynamic_cast<const SeparableFunction2D*>(mixed.get()) == nullptr
+              && approx_equal(trapezoid_2d.integrate(*h3, 0.0, 1.0, 0.0, 1.0),
+                              trapezoid_2d.integrate(g3, 0.0, 1.0, 0.0, 1.0), 1e-13);
+        std::cout << "  separable sin(x)*cos(y), exp(x+y) = G3 with expand, sin(x*y) direct"
+                  << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        // without expand the factorized path must not change the value: (x-y)^2 far from 0 cancels
+        // when expanded, exp(800x - 800y) overflows in the factor exp(800x)
+        const std::unique_ptr<Function2D> square = make_expression_function_2d("(x-y)^2");
+        const std::unique_ptr<Function2D> ratio = make_expression_function_2d("exp(800*x-800*y)");
+        const double shifted = Simpson2DSolver(100, 100, 2).integrate(*square, 1e8, 1e8 + 1.0, 1e8, 1e8 + 1.0);
+        const double ratio_integral = trapezoid_2d.integrate(*ratio, 0.0, 1.0, 0.99, 1.0);
+        passed = approx_equal(shifted, 1.0 / 6.0, 1e-8) && std::isfinite(ratio_integral)
+              && ratio_integral == trapezoid_2d.integrate(ExpressionFunction2D("exp(800*x-800*y)"), 0.0, 1.0, 0.99, 1.0);
+        std::cout << "  (x-y)^2 on [1e8, 1e8+1]^2 = " << shifted << ", exp(800x-800y) finite"
+                  << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        passed = ExpressionFunction(".5 + 1e-3 + 2.5E+2 + 3.")(0.0) == 0.5 + 1e-3 + 2.5e2 + 3.0;
+        const std::string too_deep = std::string(100000, '(') + "x" + std::string(100000, ')');
+        for (const std::string bad : {"x +", "sin(x", "foo(x)", "y", "pow(x)", "2 $ x", "0x10", "1e", "1.2.3", ".", "2x",
+                                      too_deep.c_str()}) {
+            try {
+                ExpressionFunction f(bad);
+                passed = false;
+            } catch (const std::invalid_argument&) {
+            }
+        }
+        std::cout << "  invalid expressions rejected" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+    }
+
+    // SAMPLED DATA
+    // Samples of F1 / G4 at the solver nodes, read back from raw and CSV files, give the grid solvers'
+    // results bit for bit; non-uniform nodes are exact for quadratics, also with an odd last interval
+    {
+        std::cout << "\nSampled data\n";
+        auto write_raw = [](const char* path, const std::vector<double>& values) {
+            std::ofstream out(path, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(double)));
+        };
+        F1 f1;
+        const std::size_t n = 100000;
+        const double h = 1.0 / static_cast<double>(n);
+        std::vector<double> values(n + 1);
+        for (std::size_t i = 0; i < n; ++i) values[i] = f1(0.0 + i * h);
+        values[n] = f1(1.0);
+        write_raw("test_samples_1d.bin", values);
+        const Samples1D raw = Samples1D::load_raw("test_samples_1d.bin", 0.0, 1.0);
+        const double trapezoid = SampledTrapezoidSolver(1).integrate(raw);
+        const double simpson = SampledSimpsonSolver(1).integrate(raw);
+        bool passed = trapezoid == TrapezoidSolver(n, 2).integrate(f1, 0.0, 1.0)
+                   && simpson == SimpsonSolver(n, 2).integrate(f1, 0.0, 1.0)
+                   && trapezoid == SampledTrapezoidSolver(4).integrate(raw)
+                   && simpson == SampledSimpsonSolver(4).integrate(raw);
+        std::cout << "  raw F1 = Trapezoid / Simpson (n=" << n << "), 1 and 4 threads"
+                  << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        // x^2 at clustered nodes x_i = (i/m)^2 with an odd number of intervals, as (x, f) pairs and as CSV
+        const std::size_t m = 1001;
+        std::vector<double> pairs;
+        {
+            std::ofstream csv("test_samples_1d.csv");
+            csv << "x,f\n";
+            csv.precision(17);
+            for (std::size_t i = 0; i <= m; ++i) {
+                const double t = static_cast<double>(i) / static_cast<double>(m);
+                pairs.push_back(t * t);
+                pairs.push_back(t * t * t * t);
+                csv << pairs[2 * i] << ", " << pairs[2 * i + 1] << "\n";
+            }
+        }
+        write_raw("test_samples_pairs.bin", pairs);
+        const Samples1D raw_pairs = Samples1D::load_raw_pairs("test_samples_pairs.bin");
+        const Samples1D csv = Samples1D::load_csv("test_samples_1d.csv", 0, 1, 3);
+        const double quadratic = SampledSimpsonSolver(2).integrate(raw_pairs);
+        passed = raw_pairs.count() == m + 1 && csv.count() == m + 1 && !raw_pairs.uniform()
+              && quadratic == SampledSimpsonSolver(1).integrate(csv)
+              && approx_equal(quadratic, 1.0 / 3.0, 1e-14)
+              && approx_equal(SampledTrapezoidSolver(2).integrate(raw_pairs), 1.0 / 3.0, 1e-6);
+        std::cout << "  x^2 on non-uniform nodes (raw pairs, CSV): " << std::scientific
+                  << std::abs(quadratic - 1.0 / 3.0) << std::fixed << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        // grid of G4 at the nodes of the 2D solvers, raw and CSV
+        G4 g4;
+        const GridOnly grid_g4(g4);
+        const double pi = 3.14159265358979323846;
+        const std::size_t nx = 120;
+        const std::size_t ny = 80;
+        std::vector<double> xs(ny + 1);
+        std::vector<double> ys(ny + 1);
+        for (std::size_t j = 0; j <= ny; ++j) ys[j] = 0.0 + j * (pi / static_cast<double>(ny));
+        std::vector<double> grid((nx + 1) * (ny + 1));
+        {
+            std::ofstream csv_grid("test_samples_2d.csv");
+            csv_grid.precision(17);
+            for (std::size_t i = 0; i <= nx; ++i) {
+                std::fill(xs.begin(), xs.end(), 0.0 + i * (pi / static_cast<double>(nx)));
+                g4.evaluate(xs.data(), ys.data(), grid.data() + i * (ny + 1), ny + 1);
+                for (std::size_t j = 0; j <= ny; ++j) {
+                    csv_grid << grid[i * (ny + 1) + j] << (j < ny ? "\t" : "\n");
+                }
+            }
+        }
+        write_raw("test_samples_2d.bin", grid);
+        const Samples2D raw_grid = Samples2D::load_raw("test_samples_2d.bin", nx + 1, ny + 1, 0.0, pi, 0.0, pi);
+        const Samples2D csv_grid = Samples2D::load_csv("test_samples_2d.csv", 0.0, pi, 0.0, pi, 2);
+        passed = SampledTrapezoidSolver(2).integrate(raw_grid) == Trapezoid2DSolver(nx, ny, 2).integrate(grid_g4, 0.0, pi, 0.0, pi)
+              && SampledSimpsonSolver(2).integrate(raw_grid) == Simpson2DSolver(nx, ny, 2).integrate(grid_g4, 0.0, pi, 0.0, pi)
+              && SampledSimpsonSolver(1).integrate(csv_grid) == SampledSimpsonSolver(3).integrate(raw_grid);
+        std::cout << "  raw / CSV grid of G4 = Trapezoid2D / Simpson2D" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+
+        // errors: decreasing nodes, a bad CSV line (with its number), a missing file
+        passed = true;
+        std::swap(pairs[2 * 500], pairs[2 * 501]);
+        try {
+            SampledTrapezoidSolver(2).integrate(Samples1D(pairs.data(), pairs.data() + 1, m + 1, 2));
+            passed = false;
+        } catch (const std::invalid_argument&) {
+        }
+        {
+            std::ofstream bad("test_samples_1d.csv", std::ios::app);
+            bad << "0.5, abc\n";
+        }
+        try {
+            Samples1D::load_csv("test_samples_1d.csv");
+            passed = false;
+        } catch (const std::invalid_argument& e) {
+            passed &= std::string(e.what()).find("line " + std::to_string(m + 3)) != std::string::npos;
+        }
+        try {
+            Samples1D::load_raw("test_samples_missing.bin", 0.0, 1.0);
+            passed = false;
+        } catch (const std::runtime_error&) {
+        }
+        std::cout << "  invalid samples rejected" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+    }
+    // only after the samples are gone, Windows does not delete mapped files
+    for (const char* path : {"test_samples_1d.bin", "test_samples_pairs.bin", "test_samples_1d.csv",
+                             "test_samples_2d.bin", "test_samples_2d.csv"}) {
+        std::remove(path);
+    }
+
     // SUMMARY
     std::cout << "\n==========================================================\n";
     std::cout << "TEST SUMMARY: " << tests_passed << "/" << tests_total << " tests passed\n";
@@ -0,0 +1,189 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "VectorMath.h"
+
+
+/*
+Tests of the vectorized math kernels against the std:: versions.
+The kernels are compared on the intervals the drivers integrate over
+(main.cpp: [0,1] and [1e-6,1], main_2d.cpp: [0,1]x[0,1] and [0,pi]x[0,pi]),
+on wider ranges and on special values.
+Every instruction set variant the CPU supports is run and compared to the scalar one,
+the documented tolerance between the variants is 0 ulp (VectorMath.h).
+*/
+
+// distance in units in the last place between two doubles
+double ulp_distance(double value, double reference) {
+    if (value == reference) return 0.0;
+    if (std::isnan(value) || std::isnan(reference)) return std::numeric_limits<double>::infinity();
+    const double ulp = std::nextafter(std::abs(reference), std::numeric_limits<double>::infinity()) - std::abs(reference);
+    return std::abs(value - reference) / ulp;
+}
+
+// n equally spaced points on [lo, hi] plus an odd count so the vector tail is exercised
+std::vector<double> grid(double lo, double hi, std::size_t n) {
+    std::vector<double> x(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        x[i] = lo + (hi - lo) * static_cast<double>(i) / static_cast<double>(n - 1);
+    }
+    return x;
+}
+
+// maximum ulp error of a kernel compared to the std:: reference on the points x
+template <class Kernel, class Reference>
+double max_ulp(Kernel kernel, Reference reference, const std::vector<double>& x) {
+    std::vector<double> out(x.size());
+    kernel(x.data(), out.data(), x.size());
+    double worst = 0.0;
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        const double e = ulp_distance(out[i], reference(x[i]));
+        if (e > worst) worst = e;
+    }
+    return worst;
+}
+
+// true if both are NaN or both are bitwise the same value
+bool same_value(double value, double reference) {
+    if (std::isnan(value) && std::isnan(reference)) return true;
+    return std::memcmp(&value, &reference, sizeof value) == 0;
+}
+
+int main() {
+    std::cout << "==========================================================\n";
+    std::cout << "Running vector math kernel tests (" << vmath::isa() << ")...\n";
+    std::cout << "==========================================================\n\n";
+
+    // std:: is within 1 ulp itself, so allow 2 ulp between the two
+    const double tol_ulp = 2.0;
+    const double pi = 3.14159265358979323846;
+    const std::size_t n = 200001;
+
+    int tests_passed = 0;
+    int tests_total = 0;
+
+    struct Case {
+        std::string name;
+        void (*kernel)(const double*, double*, std::size_t);
+        double (*reference)(double);
+        double lo, hi;
+    };
+
+    const std::vector<Case> cases = {
+        // intervals used in main.cpp / main_2d.cpp
+        {"cos   [0,1]",      vmath::cos,   [](double x) { return std::cos(x); },        0.0,  1.0},
+        {"rsqrt [1e-6,1]",   vmath::rsqrt, [](double x) { return 1.0 / std::sqrt(x); }, 1e-6, 1.0},
+        {"log   [1e-6,1]",   vmath::log,   [](double x) { return std::log(x); },        1e-6, 1.0},
+        {"exp   [0,2]",      vmath::exp,   [](double x) { return std::exp(x); },        0.0,  2.0},
+        {"sin   [0,pi]",     vmath::sin,   [](double x) { return std::sin(x); },        0.0,  pi},
+        {"cos   [0,pi]",     vmath::cos,   [](double x) { return std::cos(x); },        0.0,  pi},
+        // wider ranges
+        {"sin   [-1e5,1e5]", vmath::sin,   [](double x) { return std::sin(x); },        -1e5, 1e5},
+        {"cos   [-1e5,1e5]", vmath::cos,   [](double x) { return std::cos(x); },        -1e5, 1e5},
+        {"exp   [-700,700]", vmath::exp,   [](double x) { return std::exp(x); },        -700, 700},
+        {"log   [1e-300,1e300]", vmath::log, [](double x) { return std::log(x); },      1e-300, 1e300},
+    };
+
+    for (const Case& c : cases) {
+        const double err = max_ulp(c.kernel, c.reference, grid(c.lo, c.hi, n));
+        const bool passed = err <= tol_ulp;
+        std::cout << "  " << c.name << ": max error " << err << " ulp"
+                  << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+    }
+
+    // special values (outside the fast domain of each kernel) must behave exactly like <cmath>
+    {
+        const double inf = std::numeric_limits<double>::infinity();
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        bool passed = true;
+
+        auto check = [&](void (*kernel)(const double*, double*, std::size_t), double (*reference)(double),
+                         const std::vector<double>& x) {
+            std::vector<double> out(x.size());
+            kernel(x.data(), out.data(), x.size());
+            for (std::size_t i = 0; i < x.size(); ++i) passed &= same_value(out[i], reference(x[i]));
+        };
+
+        check(vmath::log, [](double x) { return std::log(x); }, {0.0, -0.0, -1.0, 1e-310, inf, -inf, nan});
+        check(vmath::exp, [](double x) { return std::exp(x); }, {710.0, -746.0, inf, -inf, nan});
+        check(vmath::sin, [](double x) { return std::sin(x); }, {0.0, -0.0, 1e22, -1e300, inf, -inf, nan});
+        check(vmath::cos, [](double x) { return std::cos(x); }, {0.0, -0.0, 1e22, -1e300, inf, -inf, nan});
+        check(vmath::rsqrt, [](double x) { return 1.0 / std::sqrt(x); }, {0.0, -0.0, -1.0, inf, nan});
+
+        std::cout << "  special values (0, inf, nan, negative, overflow)"
+                  << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+    }
+
+    // in-place evaluation (out == x)
+    {
+        std::vector<double> x = grid(0.0, 2.0, 1001);
+        const std::vector<double> copy = x;
+        vmath::exp(x.data(), x.data(), x.size());
+        bool passed = true;
+        for (std::size_t i = 0; i < x.size(); ++i) passed &= ulp_distance(x[i], std::exp(copy[i])) <= tol_ulp;
+        std::cout << "  in-place evaluation" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+    }
+
+    // every supported variant gives the scalar results bit for bit, also on the vector tails
+    {
+        const char* const selected = vmath::isa();
+        const std::vector<double> x = grid(-3.0, 3.0, 1003);
+        const std::vector<double> positive = grid(1e-6, 3.0, 1003);
+        const std::vector<double> w = grid(0.5, 1.5, 1003);
+
+        // results of all kernels and block sums of the current variant
+        auto run = [&]() {
+            std::vector<double> all;
+            auto append = [&](void (*kernel)(const double*, double*, std::size_t), const std::vector<double>& in) {
+                std::vector<double> out(in.size());
+                kernel(in.data(), out.data(), in.size());
+                all.insert(all.end(), out.begin(), out.end());
+            };
+            append(vmath::cos, x);
+            append(vmath::sin, x);
+            append(vmath::exp, x);
+            append(vmath::log, positive);
+            append(vmath::rsqrt, positive);
+            for (std::size_t m = 0; m <= 19; ++m) {
+                all.push_back(vmath::sum(x.data(), m));
+                all.push_back(vmath::dot(w.data(), x.data(), m));
+            }
+            all.push_back(vmath::sum(x.data(), x.size()));
+            all.push_back(vmath::dot(w.data(), x.data(), x.size()));
+            return all;
+        };
+
+        bool passed = vmath::set_isa("scalar") && !vmath::set_isa("no-such-isa");
+        const std::vector<double> reference = run();
+        std::cout << "  variants:";
+        for (const char* name : {"sse2", "avx2", "avx512"}) {
+            if (!vmath::set_isa(name)) continue;
+            const std::vector<double> values = run();
+            bool same = values.size() == reference.size();
+            for (std::size_t i = 0; same && i < values.size(); ++i) same = same_value(values[i], reference[i]);
+            std::cout << " " << name << (same ? "" : " (differs)");
+            passed &= same;
+        }
+        vmath::set_isa(selected);
+        std::cout << " vs scalar, bit for bit" << (passed ? " [PASS]" : " [FAIL]") << "\n";
+        tests_total++;
+        if (passed) tests_passed++;
+    }
+
+    std::cout << "\n==========================================================\n";
+    std::cout << "TEST SUMMARY: " << tests_passed << "/" << tests_total << " tests passed\n";
+    std::cout << "==========================================================\n";
+
+    return (tests_passed == tests_total) ? 0 : 1;
+}